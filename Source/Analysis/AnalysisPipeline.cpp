@@ -0,0 +1,162 @@
+#include "AnalysisPipeline.h"
+#include <algorithm>
+
+AnalysisPipeline::~AnalysisPipeline()
+{
+    stop();
+}
+
+void AnalysisPipeline::prepare(int newFrameSize, int queueCapacity)
+{
+    stop();
+    
+    frameSize = newFrameSize;
+    
+    // AbstractFifo keeps one slot free to tell "full" from "empty"
+    frameFifo.setTotalSize(queueCapacity + 1);
+    frameSlots.assign(static_cast<size_t>((queueCapacity + 1) * frameSize), 0.0f);
+    frameAmplitudes.assign(static_cast<size_t>(queueCapacity + 1), 0.0f);
+    
+    resultFifo.setTotalSize(queueCapacity + 1);
+    resultSlots.assign(static_cast<size_t>(queueCapacity + 1), AnalysisResult());
+    
+    reset();
+}
+
+void AnalysisPipeline::start()
+{
+    // The queues belong to the audio thread and the workers, so the frames
+    // left from the last run are discarded by the audio thread
+    if (!enabled.load())
+        resetRequested.store(true);
+    
+    enabled.store(true);
+}
+
+void AnalysisPipeline::stop()
+{
+    enabled.store(false);
+    
+    // A worker that got in before the flag changed finishes its frame first
+    while (busy.load())
+        juce::Thread::yield();
+}
+
+void AnalysisPipeline::handlePendingReset()
+{
+    if (!resetRequested.load())
+        return;
+    
+    // Hold the pipeline as a worker would; a worker that has it sees the
+    // request and lets go straight away
+    bool expected = false;
+    if (!busy.compare_exchange_strong(expected, true))
+        return;
+    
+    reset();
+    busy.store(false);
+}
+
+void AnalysisPipeline::reset()
+{
+    resetRequested.store(false);
+    frameFifo.reset();
+    resultFifo.reset();
+    droppedFrames.store(0);
+    maxQueueDepth.store(0);
+}
+
+bool AnalysisPipeline::pushFrame(const AudioFrameView& frame, float amplitude)
+{
+    int start1, size1, start2, size2;
+    frameFifo.prepareToWrite(1, start1, size1, start2, size2);
+    
+    if (size1 == 0)
+    {
+        droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    jassert(frame.getNumSamples() == frameSize);
+    frame.copyTo(frameSlots.data() + static_cast<size_t>(start1 * frameSize));
+    frameAmplitudes[static_cast<size_t>(start1)] = amplitude;
+    frameFifo.finishedWrite(1);
+    
+    int depth = frameFifo.getNumReady();
+    if (depth > maxQueueDepth.load(std::memory_order_relaxed))
+        maxQueueDepth.store(depth, std::memory_order_relaxed);
+    
+    return true;
+}
+
+bool AnalysisPipeline::popResult(AnalysisResult& result)
+{
+    int start1, size1, start2, size2;
+    resultFifo.prepareToRead(1, start1, size1, start2, size2);
+    
+    if (size1 == 0)
+        return false;
+    
+    result = resultSlots[static_cast<size_t>(start1)];
+    resultFifo.finishedRead(1);
+    return true;
+}
+
+bool AnalysisPipeline::analyzeNextFrame()
+{
+    if (!enabled.load(std::memory_order_relaxed))
+        return false;
+    
+    bool expected = false;
+    if (!busy.compare_exchange_strong(expected, true))
+        return false;
+    
+    // Checked again while holding the pipeline, so stop() can't miss us, and
+    // queues waiting to be reset are left to the audio thread
+    bool analysed = enabled.load() && !resetRequested.load() && analyzeQueuedFrame();
+    busy.store(false);
+    return analysed;
+}
+
+bool AnalysisPipeline::analyzeQueuedFrame()
+{
+    int start1, size1, start2, size2;
+    frameFifo.prepareToRead(1, start1, size1, start2, size2);
+    
+    if (size1 == 0)
+        return false;
+    
+    // The detector reads the frame in its slot, which the audio thread can't
+    // reuse until it's handed back below
+    const AudioFrameView frame(frameSlots.data() + static_cast<size_t>(start1 * frameSize), frameSize);
+    float amplitude = frameAmplitudes[static_cast<size_t>(start1)];
+    
+    PitchDetector* currentDetector = detector.load();
+    if (currentDetector == nullptr)
+    {
+        frameFifo.finishedRead(1);
+        return true;
+    }
+    
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    
+    AnalysisResult result;
+    result.frequency = currentDetector->detectPitchInFrame(frame);
+    result.confidence = currentDetector->getConfidence();
+    result.amplitude = amplitude;
+    result.computeTimeMs = static_cast<float>(juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks) * 1000.0);
+    
+    frameFifo.finishedRead(1);
+    
+    resultFifo.prepareToWrite(1, start1, size1, start2, size2);
+    
+    // The audio thread drains results every block, so this only happens if
+    // it has stopped calling processBlock
+    if (size1 == 0)
+        return true;
+    
+    resultSlots[static_cast<size_t>(start1)] = result;
+    resultFifo.finishedWrite(1);
+    return true;
+}
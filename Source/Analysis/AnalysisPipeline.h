@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../PitchDetectionAlgorithms/PitchDetector.h"
+#include <atomic>
+#include <vector>
+
+// Result of analysing one frame on the background thread
+struct AnalysisResult
+{
+    float frequency = 0.0f;     // 0 if no pitch was detected
+    float confidence = 0.0f;
+    float amplitude = 0.0f;
+    float computeTimeMs = 0.0f; // Time spent in detectPitch
+};
+
+// Moves pitch detection off the audio thread.
+//
+// The audio thread copies frames into a pre-allocated single-producer /
+// single-consumer ring (wait-free: a memcpy per span of the frame and an
+// index update) and never waits for the analysis. The detector reads the
+// frame in its slot, which is only handed back once it's done, and results
+// go back through a second SPSC ring that the audio thread drains. When the
+// frame ring is full the frame is dropped and counted, so the audio thread
+// never blocks.
+class AnalysisPipeline
+{
+public:
+    AnalysisPipeline() = default;
+    ~AnalysisPipeline();
+    
+    // Allocate frame and result slots (stops the pipeline; not real-time safe)
+    void prepare(int frameSize, int queueCapacity);
+    
+    // Let the pool's workers analyse queued frames, or stop them (message
+    // thread). stop() returns once no worker is inside the detector. A
+    // stopped pipeline starts from empty queues: start() asks the audio
+    // thread to discard what is left, and no frame is analysed until it has.
+    void start();
+    void stop();
+    bool isRunning() const { return enabled.load(); }
+    
+    // Detector used for subsequent frames
+    void setDetector(PitchDetector* newDetector) { detector.store(newDetector); }
+    
+    // Audio thread: queue a frame for analysis. Returns false if the queue was
+    // full and the frame had to be dropped.
+    bool pushFrame(const AudioFrameView& frame, float amplitude);
+    
+    // Audio thread: fetch the next published result, if any. Every analysed
+    // frame produces a result, including frames where no pitch was found.
+    bool popResult(AnalysisResult& result);
+    
+    // Audio thread: apply a reset requested by start(), once no worker
+    // holds the pipeline (retried at the next call if one does)
+    void handlePendingReset();
+    
+    // Forget queued frames and results, and clear the counters (only while
+    // no other thread uses the queues, as in prepare())
+    void reset();
+    
+    // Counters for sizing the queue
+    int getDroppedFrames() const { return droppedFrames.load(); }
+    int getQueueDepth() const { return frameFifo.getNumReady(); }
+    int getMaxQueueDepth() const { return maxQueueDepth.load(); }
+    int getQueueCapacity() const { return frameFifo.getTotalSize() - 1; }
+    
+    // Worker thread: analyse one queued frame. Returns false straight away
+    // if stopped, if nothing is queued or if another worker has this pipeline.
+    bool analyzeNextFrame();
+
+private:
+    bool analyzeQueuedFrame();
+    
+    // Frames: audio thread -> worker
+    juce::AbstractFifo frameFifo { 2 };
+    std::vector<float> frameSlots;
+    std::vector<float> frameAmplitudes;
+    int frameSize = 0;
+    
+    // Results: worker -> audio thread
+    juce::AbstractFifo resultFifo { 2 };
+    std::vector<AnalysisResult> resultSlots;
+    
+    std::atomic<PitchDetector*> detector { nullptr };
+    
+    std::atomic<bool> enabled { false };
+    std::atomic<bool> busy { false };   // Held by the worker analysing a frame
+    std::atomic<bool> resetRequested { false };
+    
+    std::atomic<int> droppedFrames { 0 };
+    std::atomic<int> maxQueueDepth { 0 };
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisPipeline)
+};
@@ -0,0 +1,84 @@
+#include "AnalysisWorkerPool.h"
+#include "AnalysisPipeline.h"
+#include <algorithm>
+
+AnalysisWorkerPool::AnalysisWorkerPool(int numWorkers)
+{
+    for (int i = 0; i < juce::jlimit(1, MAX_WORKERS, numWorkers); ++i)
+        workers.push_back(std::make_unique<Worker>(*this, i));
+}
+
+AnalysisWorkerPool::~AnalysisWorkerPool()
+{
+    stop();
+}
+
+void AnalysisWorkerPool::addPipeline(AnalysisPipeline* pipeline)
+{
+    jassert(!isRunning());
+    
+    if (std::find(pipelines.begin(), pipelines.end(), pipeline) == pipelines.end())
+        pipelines.push_back(pipeline);
+}
+
+void AnalysisWorkerPool::removePipeline(AnalysisPipeline* pipeline)
+{
+    jassert(!isRunning());
+    pipelines.erase(std::remove(pipelines.begin(), pipelines.end(), pipeline), pipelines.end());
+}
+
+void AnalysisWorkerPool::start()
+{
+    for (auto& worker : workers)
+    {
+        if (!worker->isThreadRunning())
+            worker->startThread();
+    }
+}
+
+void AnalysisWorkerPool::stop()
+{
+    // Ask them all first so they wind down together
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+    
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+}
+
+bool AnalysisWorkerPool::isRunning() const
+{
+    return std::any_of(workers.begin(), workers.end(), [](const auto& worker) { return worker->isThreadRunning(); });
+}
+
+int AnalysisWorkerPool::getDefaultNumWorkers()
+{
+    return juce::jlimit(1, MAX_WORKERS, juce::SystemStats::getNumCpus() - 1);
+}
+
+AnalysisWorkerPool::Worker::Worker(AnalysisWorkerPool& owner, int workerIndex)
+    : juce::Thread("Pitch Analysis " + juce::String(workerIndex + 1)), pool(owner), index(workerIndex)
+{
+}
+
+void AnalysisWorkerPool::Worker::run()
+{
+    const std::vector<AnalysisPipeline*>& pipelines = pool.pipelines;
+    
+    while (!threadShouldExit())
+    {
+        // Workers start their sweeps at different pipelines so they don't
+        // all contend for the first one
+        bool analysedAny = false;
+        const size_t numPipelines = pipelines.size();
+        
+        for (size_t i = 0; i < numPipelines; ++i)
+        {
+            if (pipelines[(static_cast<size_t>(index) + i) % numPipelines]->analyzeNextFrame())
+                analysedAny = true;
+        }
+        
+        if (!analysedAny)
+            wait(IDLE_WAIT_MS);
+    }
+}
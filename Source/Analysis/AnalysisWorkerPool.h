@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+class AnalysisPipeline;
+
+// Small fixed set of threads that run the detectors of every registered
+// AnalysisPipeline.
+//
+// Each worker sweeps the pipelines (starting at a different one per worker)
+// and analyses at most one queued frame from each per pass, so the work of
+// several channels and detectors spreads over the cores instead of each
+// pipeline needing a thread of its own. A pipeline is only ever serviced by
+// one worker at a time, which keeps every detector single-threaded. Like the
+// pipelines, workers are never signalled by the audio thread; an idle worker
+// sleeps for IDLE_WAIT_MS.
+class AnalysisWorkerPool
+{
+public:
+    explicit AnalysisWorkerPool(int numWorkers = getDefaultNumWorkers());
+    ~AnalysisWorkerPool();
+    
+    // Pipelines the workers service (only while the workers are stopped)
+    void addPipeline(AnalysisPipeline* pipeline);
+    void removePipeline(AnalysisPipeline* pipeline);
+    
+    // Start/stop the worker threads (message thread)
+    void start();
+    void stop();
+    bool isRunning() const;
+    
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+    
+    // One thread per core, leaving one for the audio thread
+    static int getDefaultNumWorkers();
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(AnalysisWorkerPool& owner, int workerIndex);
+        void run() override;
+    
+    private:
+        AnalysisWorkerPool& pool;
+        int index;
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<AnalysisPipeline*> pipelines;   // Fixed while the workers run
+    
+    static constexpr int MAX_WORKERS = 8;
+    static constexpr int IDLE_WAIT_MS = 1;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisWorkerPool)
+};
@@ -0,0 +1,312 @@
+#include "ChannelAnalyzer.h"
+#include "../PitchDetectionAlgorithms/PitchDetectorFactory.h"
+#include "../Utilities/CycleCounter.h"
+#include <algorithm>
+#include <cmath>
+
+ChannelAnalyzer::ChannelAnalyzer(AnalysisWorkerPool& workerPool)
+    : pool(workerPool)
+{
+    // Initialize pitch detectors (the first one is the default)
+    detectors = PitchDetectorFactory::createAll();
+    
+    analysisPipeline.setDetector(getActiveDetector());
+    pool.addPipeline(&analysisPipeline);
+    
+    for (auto& detector : detectors)
+    {
+        auto pipeline = std::make_unique<AnalysisPipeline>();
+        pipeline->setDetector(detector.get());
+        pool.addPipeline(pipeline.get());
+        comparisonPipelines.push_back(std::move(pipeline));
+        comparisonStatistics.push_back(std::make_unique<StatisticsManager>());
+    }
+}
+
+ChannelAnalyzer::~ChannelAnalyzer()
+{
+    pool.removePipeline(&analysisPipeline);
+    for (auto& pipeline : comparisonPipelines)
+        pool.removePipeline(pipeline.get());
+}
+
+void ChannelAnalyzer::prepare(double sampleRate, int decimationFactor, int hopSize, int algorithmIndex)
+{
+    decimator.prepare(decimationFactor);
+    decimatedBlock.resize(static_cast<size_t>(decimator.getMaxOutputSamples(MAX_DECIMATOR_BLOCK_SIZE)));
+    
+    // Frames are sized in time from the lowest note (B0), so every sample
+    // rate can reach it; multi-resolution detectors use less of the frame
+    // for higher notes
+    const double analysisSampleRate = sampleRate / decimationFactor;
+    const int analysisFrameSize = PitchDetector::getFrameSizeForFrequency(analysisSampleRate,
+                                                                          PitchDetector::DEFAULT_MIN_FREQUENCY);
+    
+    // Prepare analysis buffers
+    analysisRing.prepare(analysisFrameSize, std::max(1, hopSize / decimationFactor));
+    
+    // Prepare the pipelines (stops them while reallocating)
+    analysisPipeline.prepare(analysisFrameSize, ANALYSIS_QUEUE_CAPACITY);
+    for (auto& pipeline : comparisonPipelines)
+        pipeline->prepare(analysisFrameSize, ANALYSIS_QUEUE_CAPACITY);
+    
+    // Use the detectors specialised for this frame size where there are any
+    // (the pipelines are stopped, so none is in use)
+    if (analysisFrameSize != detectorFrameSize)
+    {
+        detectors = PitchDetectorFactory::createAll(analysisFrameSize);
+        detectorFrameSize = analysisFrameSize;
+        
+        for (size_t i = 0; i < detectors.size(); ++i)
+            comparisonPipelines[i]->setDetector(detectors[i].get());
+    }
+    
+    // Prepare every pitch detector so switching never allocates. They see
+    // the decimated rate, so their frequencies come out in Hz unchanged.
+    for (auto& detector : detectors)
+        detector->prepare(analysisSampleRate, analysisFrameSize);
+    
+    activeAlgorithmIndex = juce::jlimit(0, getNumDetectors() - 1, algorithmIndex);
+    analysisPipeline.setDetector(getActiveDetector());
+    
+    // Audio thread timing (calibrates the cycle counter here, once)
+    hostSampleRate = sampleRate;
+    timestampsPerSecond = CycleCounter::getTimestampsPerSecond();
+    
+    // Allocate and reset statistics; only the selected algorithm's are plotted
+    statisticsManager.prepare();
+    statisticsManager.prepareSessionHistory();
+    for (auto& statistics : comparisonStatistics)
+        statistics->prepare();
+}
+
+void ChannelAnalyzer::processBlock(const float* input, int numSamples, const BlockSettings& settings)
+{
+    const juce::uint64 processStart = CycleCounter::timestamp();
+    
+    // Apply resets requested by the UI before any new measurements, and
+    // empty the queues of pipelines that were just started
+    if (statisticsResetRequested.exchange(false))
+        resetMainStatistics();
+    for (auto& statistics : comparisonStatistics)
+        statistics->handlePendingReset();
+    
+    analysisPipeline.handlePendingReset();
+    for (auto& pipeline : comparisonPipelines)
+        pipeline->handlePendingReset();
+    
+    collectResults();
+    
+    // Switch algorithm between frames, after the old detector's results are in
+    applyAlgorithmChange(settings.algorithmIndex);
+    
+    // Pick up hop changes from the UI; hops keep their host-rate duration
+    analysisRing.setHopSize(std::max(1, settings.hopSize / decimator.getFactor()));
+    
+    // Decimate in blocks that fit the preallocated output, however large the
+    // host block is
+    for (int blockStart = 0; blockStart < numSamples; blockStart += MAX_DECIMATOR_BLOCK_SIZE)
+    {
+        int blockSize = std::min(MAX_DECIMATOR_BLOCK_SIZE, numSamples - blockStart);
+        int numDecimated = decimator.process(input + blockStart, blockSize, decimatedBlock.data());
+        
+        // Feed the circular buffer in chunks that end exactly on frame boundaries
+        int position = 0;
+        while (position < numDecimated)
+        {
+            int chunkSize = std::min(numDecimated - position, analysisRing.getSamplesUntilNextFrame());
+            analysisRing.push(decimatedBlock.data() + position, chunkSize);
+            position += chunkSize;
+            
+            if (analysisRing.isFrameReady())
+                analyzeFrame(analysisRing.readFrame(), settings);
+        }
+    }
+    
+    // How much of the time this block lasts went on analysing it
+    const auto budget = static_cast<juce::uint64>(numSamples / hostSampleRate * timestampsPerSecond);
+    statisticsManager.addBlockCost(CycleCounter::timestamp() - processStart, budget);
+}
+
+void ChannelAnalyzer::collectResults()
+{
+    // Results published by the background worker...
+    AnalysisResult result;
+    while (analysisPipeline.popResult(result))
+        addMainResult(result);
+    
+    // ... and by the comparison workers, where the selected algorithm also
+    // feeds the main statistics
+    for (size_t i = 0; i < comparisonPipelines.size(); ++i)
+    {
+        while (comparisonPipelines[i]->popResult(result))
+        {
+            addAnalysisResult(*comparisonStatistics[i], result, juce::Time::getHighResolutionTicks());
+            
+            if (static_cast<int>(i) == activeAlgorithmIndex)
+                addMainResult(result);
+        }
+    }
+}
+
+void ChannelAnalyzer::analyzeFrame(const AudioFrameView& frame, const BlockSettings& settings)
+{
+    const juce::uint64 frameStart = CycleCounter::timestamp();
+    const int frameSize = frame.getNumSamples();
+    
+    // Check if there's enough signal
+    float rms = 0.0f;
+    frame.forEachSpan([&rms](const float* samples, int numSamples)
+    {
+        for (int j = 0; j < numSamples; ++j)
+            rms += samples[j] * samples[j];
+    });
+    rms = std::sqrt(rms / frameSize);
+    
+    if (rms <= MIN_AMPLITUDE_THRESHOLD)
+    {
+        addGatedFrame(rms);
+        statisticsManager.addFrameCost(CycleCounter::timestamp() - frameStart);
+        return;
+    }
+    
+    if (settings.comparisonMode)
+    {
+        // Every detector analyses the same frame on the worker pool
+        for (auto& pipeline : comparisonPipelines)
+            pipeline->pushFrame(frame, rms);
+        statisticsManager.addFrameCost(CycleCounter::timestamp() - frameStart);
+        return;
+    }
+    
+    if (settings.backgroundAnalysis)
+    {
+        // Wait-free hand-off; a full queue drops the frame
+        analysisPipeline.pushFrame(frame, rms);
+        statisticsManager.addFrameCost(CycleCounter::timestamp() - frameStart);
+        return;
+    }
+    
+    const juce::uint64 detectionStart = CycleCounter::timestamp();
+    
+    AnalysisResult result;
+    result.frequency = getActiveDetector()->detectPitchInFrame(frame);
+    result.confidence = getActiveDetector()->getConfidence();
+    result.amplitude = rms;
+    
+    const juce::uint64 frameEnd = CycleCounter::timestamp();
+    result.computeTimeMs = static_cast<float>((frameEnd - detectionStart) / timestampsPerSecond * 1000.0);
+    
+    // Update statistics
+    statisticsManager.addFrameCost(frameEnd - frameStart);
+    addMainResult(result);
+}
+
+void ChannelAnalyzer::addAnalysisResult(StatisticsManager& statistics, const AnalysisResult& result, juce::int64 timestamp)
+{
+    statistics.addComputeTime(result.computeTimeMs);
+    
+    if (result.frequency > 0.0f)
+        statistics.addPitchMeasurement(result.frequency, result.amplitude, timestamp);
+    else
+        statistics.addUnpitchedFrame(timestamp);
+}
+
+void ChannelAnalyzer::addMainResult(const AnalysisResult& result)
+{
+    // The log gets the timestamp the statistics saw, so a replay matches
+    const juce::int64 timestamp = juce::Time::getHighResolutionTicks();
+    addAnalysisResult(statisticsManager, result, timestamp);
+    
+    if (sessionRecorder != nullptr && sessionRecorder->isRecording())
+        sessionRecorder->addMeasurement(PitchMeasurement(result.frequency, result.amplitude, timestamp,
+                                                         result.confidence, result.computeTimeMs),
+                                        recorderChannel, activeAlgorithmIndex, true);
+}
+
+void ChannelAnalyzer::addGatedFrame(float amplitude)
+{
+    const juce::int64 timestamp = juce::Time::getHighResolutionTicks();
+    statisticsManager.addUnpitchedFrame(timestamp);
+    
+    if (sessionRecorder != nullptr && sessionRecorder->isRecording())
+        sessionRecorder->addMeasurement(PitchMeasurement(0.0f, amplitude, timestamp), recorderChannel, activeAlgorithmIndex, false);
+}
+
+void ChannelAnalyzer::applyAlgorithmChange(int algorithmIndex)
+{
+    if (algorithmIndex == activeAlgorithmIndex || algorithmIndex < 0 || algorithmIndex >= getNumDetectors())
+        return;
+    
+    activeAlgorithmIndex = algorithmIndex;
+    
+    // The background worker picks this up at its next frame; the previous
+    // detector stays alive in `detectors`, so a frame in flight is safe
+    analysisPipeline.setDetector(getActiveDetector());
+    
+    // Reset statistics when changing algorithm
+    resetMainStatistics();
+}
+
+void ChannelAnalyzer::resetMainStatistics()
+{
+    statisticsManager.reset();
+    
+    if (sessionRecorder != nullptr && sessionRecorder->isRecording())
+        sessionRecorder->addReset(recorderChannel, activeAlgorithmIndex, juce::Time::getHighResolutionTicks());
+}
+
+void ChannelAnalyzer::startPipelines(bool comparisonMode)
+{
+    // A detector must never run on two threads at once, so the pipelines
+    // that were using the detectors stop before the others start
+    if (comparisonMode)
+    {
+        analysisPipeline.stop();
+        for (auto& pipeline : comparisonPipelines)
+            pipeline->start();
+    }
+    else
+    {
+        for (auto& pipeline : comparisonPipelines)
+            pipeline->stop();
+        analysisPipeline.start();
+    }
+}
+
+void ChannelAnalyzer::stopPipelines()
+{
+    analysisPipeline.stop();
+    for (auto& pipeline : comparisonPipelines)
+        pipeline->stop();
+}
+
+void ChannelAnalyzer::resetComparison()
+{
+    // The queues are emptied when the pipelines start
+    for (auto& statistics : comparisonStatistics)
+        statistics->requestReset();
+}
+
+void ChannelAnalyzer::requestStatisticsReset()
+{
+    statisticsResetRequested.store(true);
+    for (auto& statistics : comparisonStatistics)
+        statistics->requestReset();
+}
+
+void ChannelAnalyzer::setSessionRecorder(SessionRecorder* recorder, int channelIndex)
+{
+    sessionRecorder = recorder;
+    recorderChannel = channelIndex;
+}
+
+juce::StringArray ChannelAnalyzer::getAlgorithmNames() const
+{
+    juce::StringArray names;
+    
+    for (const auto& detector : detectors)
+        names.add(detector->getName());
+    
+    return names;
+}
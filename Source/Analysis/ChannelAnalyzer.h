@@ -0,0 +1,115 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../PitchDetectionAlgorithms/PitchDetector.h"
+#include "../Statistics/StatisticsManager.h"
+#include "../Statistics/SessionRecorder.h"
+#include "../DSP/PolyphaseDecimator.h"
+#include "CircularAnalysisBuffer.h"
+#include "AnalysisPipeline.h"
+#include "AnalysisWorkerPool.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Pitch analysis of one input channel: its own decimator, analysis ring,
+// detectors, statistics and pipelines, so channels never share detector
+// state. The audio thread feeds it with processBlock(); background and
+// comparison frames go to pipelines that the shared worker pool services.
+class ChannelAnalyzer
+{
+public:
+    // Registers the pipelines with the pool (which must be stopped)
+    explicit ChannelAnalyzer(AnalysisWorkerPool& workerPool);
+    ~ChannelAnalyzer();
+    
+    // Audio thread settings for the next block, as chosen in the UI
+    struct BlockSettings
+    {
+        int hopSize = 256;              // Host-rate samples
+        int algorithmIndex = 0;
+        bool backgroundAnalysis = false;
+        bool comparisonMode = false;
+    };
+    
+    // Allocate everything for this rate (stops the pipelines; not real-time safe)
+    void prepare(double sampleRate, int decimationFactor, int hopSize, int algorithmIndex);
+    
+    // Audio thread: collect published results, then decimate and analyse
+    // this channel's samples
+    void processBlock(const float* input, int numSamples, const BlockSettings& settings);
+    
+    // Message thread: which pipelines the pool's workers should run
+    void startPipelines(bool comparisonMode);
+    void stopPipelines();
+    
+    // Message thread: start a comparison from fresh statistics (the queues
+    // are emptied when startPipelines() starts the comparison pipelines)
+    void resetComparison();
+    
+    // Applied by the audio thread at its next block
+    void requestStatisticsReset();
+    
+    // Log every frame that feeds the main statistics to recorder, as this
+    // input channel (only while the audio thread is stopped; null for none)
+    void setSessionRecorder(SessionRecorder* recorder, int channelIndex);
+    
+    int getNumDetectors() const { return static_cast<int>(detectors.size()); }
+    juce::StringArray getAlgorithmNames() const;
+    StatisticsManager& getStatisticsManager() { return statisticsManager; }
+    StatisticsManager& getComparisonStatistics(int detectorIndex) { return *comparisonStatistics[static_cast<size_t>(detectorIndex)]; }
+    const AnalysisPipeline& getAnalysisPipeline() const { return analysisPipeline; }
+    const AnalysisPipeline& getComparisonPipeline(int detectorIndex) const { return *comparisonPipelines[static_cast<size_t>(detectorIndex)]; }
+
+private:
+    AnalysisWorkerPool& pool;
+    
+    // Every registered detector, prepared up front so switching is just an
+    // index change. prepare() swaps in compile-time specialisations for the
+    // analysis frame size where the factory has them.
+    std::vector<std::unique_ptr<PitchDetector>> detectors;
+    int detectorFrameSize = 0;      // Frame size the detectors were created for (0: dynamic ones)
+    int activeAlgorithmIndex = 0;   // Audio thread
+    
+    StatisticsManager statisticsManager;
+    
+    // Requested by the UI; the audio thread resets the main statistics
+    // itself, so the reset lands in the session log where it took effect
+    std::atomic<bool> statisticsResetRequested { false };
+    
+    // Session log, fed alongside the main statistics
+    SessionRecorder* sessionRecorder = nullptr;
+    int recorderChannel = 0;
+    
+    // Audio thread cost: a block's budget is its duration at the host rate
+    double hostSampleRate = 44100.0;
+    double timestampsPerSecond = 1.0e9;
+    
+    PolyphaseDecimator decimator;
+    std::vector<float> decimatedBlock;
+    
+    // Overlapping analysis frames (at the decimated rate), analysed in place
+    CircularAnalysisBuffer analysisRing;
+    
+    // Background analysis of the active detector, and comparison mode's one
+    // pipeline and set of statistics per detector
+    AnalysisPipeline analysisPipeline;
+    std::vector<std::unique_ptr<AnalysisPipeline>> comparisonPipelines;
+    std::vector<std::unique_ptr<StatisticsManager>> comparisonStatistics;
+    
+    static constexpr int MAX_DECIMATOR_BLOCK_SIZE = 4096;
+    static constexpr int ANALYSIS_QUEUE_CAPACITY = 32;  // Frames
+    static constexpr float MIN_AMPLITUDE_THRESHOLD = 0.01f;
+    
+    static void addAnalysisResult(StatisticsManager& statistics, const AnalysisResult& result, juce::int64 timestamp);
+    void addMainResult(const AnalysisResult& result);
+    void addGatedFrame(float amplitude);
+    void collectResults();
+    void applyAlgorithmChange(int algorithmIndex);
+    void resetMainStatistics();
+    PitchDetector* getActiveDetector() const { return detectors[static_cast<size_t>(activeAlgorithmIndex)].get(); }
+    void analyzeFrame(const AudioFrameView& frame, const BlockSettings& settings);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelAnalyzer)
+};
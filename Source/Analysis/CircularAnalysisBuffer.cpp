@@ -0,0 +1,64 @@
+#include "CircularAnalysisBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+void CircularAnalysisBuffer::prepare(int newFrameSize, int newHopSize)
+{
+    frameSize = newFrameSize;
+    buffer.resize(frameSize);
+    setHopSize(newHopSize);
+    reset();
+}
+
+void CircularAnalysisBuffer::reset()
+{
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    writeIndex = 0;
+    samplesWritten = 0;
+    samplesSinceLastFrame = 0;
+}
+
+void CircularAnalysisBuffer::setHopSize(int newHopSize)
+{
+    hopSize = std::max(1, std::min(newHopSize, frameSize));
+}
+
+int CircularAnalysisBuffer::getSamplesUntilNextFrame() const
+{
+    // The first frame needs a full buffer, later ones one hop of new samples
+    int untilFull = frameSize - samplesWritten;
+    int untilHop = hopSize - samplesSinceLastFrame;
+    return std::max(1, std::max(untilFull, untilHop));
+}
+
+void CircularAnalysisBuffer::push(const float* samples, int numSamples)
+{
+    // Only the most recent frameSize samples can ever be read back
+    if (numSamples > frameSize)
+    {
+        samples += numSamples - frameSize;
+        samplesSinceLastFrame += numSamples - frameSize;
+        numSamples = frameSize;
+    }
+    
+    int firstPart = std::min(numSamples, frameSize - writeIndex);
+    std::memcpy(buffer.data() + writeIndex, samples, sizeof(float) * static_cast<size_t>(firstPart));
+    std::memcpy(buffer.data(), samples + firstPart, sizeof(float) * static_cast<size_t>(numSamples - firstPart));
+    
+    writeIndex = (writeIndex + numSamples) % frameSize;
+    samplesWritten = std::min(frameSize, samplesWritten + numSamples);
+    samplesSinceLastFrame += numSamples;
+}
+
+bool CircularAnalysisBuffer::isFrameReady() const
+{
+    return samplesWritten >= frameSize && samplesSinceLastFrame >= hopSize;
+}
+
+AudioFrameView CircularAnalysisBuffer::readFrame()
+{
+    samplesSinceLastFrame = 0;
+    
+    // writeIndex points at the oldest sample
+    return { buffer.data() + writeIndex, frameSize - writeIndex, buffer.data(), writeIndex };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../Utilities/AudioFrameView.h"
+#include <vector>
+
+// Circular buffer that turns a continuous input stream into overlapping
+// analysis frames. Input is written with bulk copies, and a new frame of the
+// most recent `frameSize` samples becomes available every `hopSize` samples
+// once the buffer has filled up for the first time.
+class CircularAnalysisBuffer
+{
+public:
+    CircularAnalysisBuffer() = default;
+    ~CircularAnalysisBuffer() = default;
+    
+    // Allocate storage (not real-time safe)
+    void prepare(int frameSize, int hopSize);
+    
+    // Forget all buffered audio
+    void reset();
+    
+    // Change the hop; takes effect from the next frame
+    void setHopSize(int newHopSize);
+    int getHopSize() const { return hopSize; }
+    int getFrameSize() const { return frameSize; }
+    
+    // Samples that can be pushed before the next frame is due. Pushing in
+    // chunks of at most this size keeps frames aligned to the hop exactly.
+    int getSamplesUntilNextFrame() const;
+    
+    // Append samples (two memcpys at most)
+    void push(const float* samples, int numSamples);
+    
+    bool isFrameReady() const;
+    
+    // The most recent frameSize samples, oldest first, read in place (two
+    // spans when they wrap around), and start the next hop. The view is
+    // valid until the next push().
+    AudioFrameView readFrame();
+
+private:
+    std::vector<float> buffer;
+    int frameSize = 0;
+    int hopSize = 0;
+    int writeIndex = 0;
+    int samplesWritten = 0;         // Saturates at frameSize
+    int samplesSinceLastFrame = 0;
+};
@@ -0,0 +1,188 @@
+#include "FFTEngine.h"
+#include <cmath>
+#include <algorithm>
+
+// Define M_PI if not already defined (Windows doesn't define it by default)
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void FFTEngine::prepare(int fftSize)
+{
+    size = fftSize;
+    halfSize = fftSize / 2;
+    
+    // Bit-reversal permutation table for the half-size complex FFT
+    bitReversedIndex.resize(halfSize);
+    int j = 0;
+    for (int i = 0; i < halfSize; ++i)
+    {
+        bitReversedIndex[i] = j;
+        
+        int k = halfSize >> 1;
+        while (k >= 1 && k <= j)
+        {
+            j -= k;
+            k >>= 1;
+        }
+        j += k;
+    }
+    
+    // Stage plan: pairs of radix-2 stages are fused into radix-4 passes,
+    // with a single radix-2 pass first when log2(halfSize) is odd
+    int log2Size = 0;
+    while ((1 << log2Size) < halfSize)
+        ++log2Size;
+    
+    needsRadix2Stage = (log2Size % 2 != 0);
+    radix4QuarterSpans.clear();
+    radix4TwiddleOffsets.clear();
+    stageTwiddles.clear();
+    
+    for (int quarterSpan = needsRadix2Stage ? 2 : 1; quarterSpan * 4 <= halfSize; quarterSpan *= 4)
+    {
+        radix4QuarterSpans.push_back(quarterSpan);
+        radix4TwiddleOffsets.push_back(static_cast<int>(stageTwiddles.size()));
+        
+        // Contiguous w1, w2, w3 blocks so the butterflies can load them as vectors
+        for (int power = 1; power <= 3; ++power)
+        {
+            for (int k = 0; k < quarterSpan; ++k)
+            {
+                double angle = -2.0 * M_PI * power * k / (quarterSpan * 4);
+                stageTwiddles.push_back(static_cast<float>(std::cos(angle)));
+                stageTwiddles.push_back(static_cast<float>(std::sin(angle)));
+            }
+        }
+    }
+    
+    // Twiddles for splitting the packed spectrum into the real-input spectrum
+    realSplitTwiddles.resize(halfSize * 2);
+    for (int k = 0; k < halfSize; ++k)
+    {
+        double angle = -2.0 * M_PI * k / size;
+        realSplitTwiddles[k * 2] = static_cast<float>(std::cos(angle));
+        realSplitTwiddles[k * 2 + 1] = static_cast<float>(std::sin(angle));
+    }
+    
+    workBuffer.resize(halfSize * 2);
+    std::fill(workBuffer.begin(), workBuffer.end(), 0.0f);
+}
+
+void FFTEngine::performRealForward(const float* input, float* spectrum)
+{
+    float* z = workBuffer.data();
+    
+    // Step 1: Pack even/odd samples as complex values, in bit-reversed order
+    for (int n = 0; n < halfSize; ++n)
+    {
+        int target = bitReversedIndex[n];
+        z[target * 2] = input[n * 2];
+        z[target * 2 + 1] = input[n * 2 + 1];
+    }
+    
+    // Step 2: Half-size complex FFT
+    performComplexFFT(z);
+    
+    // Step 3: Split into the spectrum of the real input
+    // X[k] = E[k] + W^k O[k], E = (Z[k] + conj(Z[M-k])) / 2, O = (Z[k] - conj(Z[M-k])) / 2i
+    spectrum[0] = z[0] + z[1];
+    spectrum[1] = 0.0f;
+    spectrum[halfSize * 2] = z[0] - z[1];
+    spectrum[halfSize * 2 + 1] = 0.0f;
+    
+    for (int k = 1; k < halfSize; ++k)
+    {
+        int mirror = halfSize - k;
+        
+        float zr = z[k * 2];
+        float zi = z[k * 2 + 1];
+        float mr = z[mirror * 2];
+        float mi = -z[mirror * 2 + 1];
+        
+        float evenReal = 0.5f * (zr + mr);
+        float evenImag = 0.5f * (zi + mi);
+        float oddReal = 0.5f * (zi - mi);
+        float oddImag = -0.5f * (zr - mr);
+        
+        float wr = realSplitTwiddles[k * 2];
+        float wi = realSplitTwiddles[k * 2 + 1];
+        
+        spectrum[k * 2] = evenReal + wr * oddReal - wi * oddImag;
+        spectrum[k * 2 + 1] = evenImag + wr * oddImag + wi * oddReal;
+    }
+}
+
+void FFTEngine::performRealInverse(const float* spectrum, float* output)
+{
+    float* z = workBuffer.data();
+    
+    // Step 1: Rebuild the packed half-size spectrum
+    // E = (X[k] + conj(X[M-k])) / 2, O = (X[k] - conj(X[M-k])) conj(W^k) / 2, Z = E + iO
+    // Stored conjugated (and bit reversed) so a forward FFT performs the inverse
+    for (int k = 0; k < halfSize; ++k)
+    {
+        int mirror = halfSize - k;
+        
+        float xr = spectrum[k * 2];
+        float xi = spectrum[k * 2 + 1];
+        float mr = spectrum[mirror * 2];
+        float mi = -spectrum[mirror * 2 + 1];
+        
+        float evenReal = 0.5f * (xr + mr);
+        float evenImag = 0.5f * (xi + mi);
+        float diffReal = 0.5f * (xr - mr);
+        float diffImag = 0.5f * (xi - mi);
+        
+        float wr = realSplitTwiddles[k * 2];
+        float wi = -realSplitTwiddles[k * 2 + 1];
+        
+        float oddReal = diffReal * wr - diffImag * wi;
+        float oddImag = diffReal * wi + diffImag * wr;
+        
+        int target = bitReversedIndex[k];
+        z[target * 2] = evenReal - oddImag;
+        z[target * 2 + 1] = -(evenImag + oddReal);
+    }
+    
+    // Step 2: Forward FFT of the conjugate
+    performComplexFFT(z);
+    
+    // Step 3: Conjugate back, scale and unpack even/odd samples
+    const float scale = 1.0f / static_cast<float>(halfSize);
+    for (int n = 0; n < halfSize; ++n)
+    {
+        output[n * 2] = z[n * 2] * scale;
+        output[n * 2 + 1] = -z[n * 2 + 1] * scale;
+    }
+}
+
+void FFTEngine::performComplexFFT(float* data) const
+{
+    // Input is expected in bit-reversed order
+    if (needsRadix2Stage)
+        performRadix2Stage(data);
+    
+    for (size_t stage = 0; stage < radix4QuarterSpans.size(); ++stage)
+    {
+        kernels->radix4Stage(data, stageTwiddles.data() + radix4TwiddleOffsets[stage],
+                             halfSize, radix4QuarterSpans[stage]);
+    }
+}
+
+void FFTEngine::performRadix2Stage(float* data) const
+{
+    // First stage only: every twiddle factor is 1
+    for (int i = 0; i < halfSize; i += 2)
+    {
+        float ar = data[i * 2];
+        float ai = data[i * 2 + 1];
+        float br = data[i * 2 + 2];
+        float bi = data[i * 2 + 3];
+        
+        data[i * 2] = ar + br;
+        data[i * 2 + 1] = ai + bi;
+        data[i * 2 + 2] = ar - br;
+        data[i * 2 + 3] = ai - bi;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SimdKernels.h"
+#include <vector>
+
+// Reusable real-input FFT shared by the spectral pitch detectors.
+//
+// A real frame of N samples is packed into an N/2-point complex FFT
+// (even samples as real parts, odd samples as imaginary parts) and then
+// split back into the N/2 + 1 non-redundant bins. The complex kernel is a
+// radix-4 decimation-in-time FFT driven entirely by tables built in
+// prepare(), so no trigonometry runs per frame. Butterflies run through the
+// SIMD kernels selected for the current CPU.
+//
+// Each detector should own its own engine: the work buffer makes a single
+// instance unsafe to use from several threads at once.
+class FFTEngine
+{
+public:
+    FFTEngine() = default;
+    ~FFTEngine() = default;
+    
+    // Build twiddle and bit-reversal tables (fftSize must be a power of 2, >= 4)
+    void prepare(int fftSize);
+    
+    int getSize() const { return size; }
+    int getNumBins() const { return size / 2 + 1; }
+    
+    // Forward transform of `size` real samples into getNumBins() interleaved
+    // complex bins (re, im, re, im, ...)
+    void performRealForward(const float* input, float* spectrum);
+    
+    // Inverse of performRealForward, including the 1/size scaling, so that a
+    // forward/inverse round trip reproduces the input
+    void performRealInverse(const float* spectrum, float* output);
+    
+    // Override the CPU-selected kernels (e.g. to validate a specific variant)
+    void setKernelTable(const SimdKernelTable& table) { kernels = &table; }
+
+private:
+    int size = 0;
+    int halfSize = 0;
+    
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    
+    std::vector<int> bitReversedIndex;      // For the halfSize complex FFT
+    std::vector<float> stageTwiddles;       // Per radix-4 stage: w1, w2, w3 blocks (interleaved)
+    std::vector<int> radix4QuarterSpans;
+    std::vector<int> radix4TwiddleOffsets;
+    bool needsRadix2Stage = false;
+    std::vector<float> realSplitTwiddles;   // Interleaved W_size^k, k < halfSize
+    std::vector<float> workBuffer;          // halfSize interleaved complex values
+    
+    void performComplexFFT(float* data) const;
+    void performRadix2Stage(float* data) const;
+};
@@ -0,0 +1,295 @@
+#pragma once
+
+#include "SimdKernels.h"
+#include "../Utilities/ConstexprMath.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+// Real-input FFT of a size fixed at compile time, for detectors specialised
+// on their frame size.
+//
+// The same algorithm as FFTEngine (the real frame packed into a Size/2-point
+// complex radix-4 FFT, split afterwards), but every table - bit reversal,
+// stage twiddles, split twiddles - is a constexpr std::array computed by the
+// compiler, the sequence of stages is expanded at compile time rather than
+// looped over, and every loop has a constant trip count. Sample is float or
+// double. For float, radix-4 passes wide enough to fill a vector go through
+// the active SimdKernels radix4Stage, as FFTEngine's do; the narrow first
+// passes, and every pass for double, are plain loops with constant trip counts
+// over aligned storage that the compiler unrolls and vectorises itself.
+//
+// Like FFTEngine, an instance holds a work buffer and must only be used from
+// one thread at a time.
+template <int Size, typename Sample = float>
+class FixedSizeFFT
+{
+public:
+    static_assert(Size >= 8 && (Size & (Size - 1)) == 0, "FixedSizeFFT needs a power of two of at least 8");
+    
+    static constexpr int HALF_SIZE = Size / 2;      // Complex points of the packed FFT
+    static constexpr int NUM_BINS = Size / 2 + 1;
+    
+    // Forward transform of Size real samples into NUM_BINS interleaved
+    // complex bins (re, im, re, im, ...)
+    void performRealForward(const Sample* input, Sample* spectrum)
+    {
+        Sample* z = workBuffer.data();
+        
+        // Step 1: Pack even/odd samples as complex values, in bit-reversed order
+        for (int n = 0; n < HALF_SIZE; ++n)
+        {
+            const int target = BIT_REVERSED_INDEX[static_cast<size_t>(n)];
+            z[target * 2] = input[n * 2];
+            z[target * 2 + 1] = input[n * 2 + 1];
+        }
+        
+        // Step 2: Half-size complex FFT
+        performComplexFFT(z);
+        
+        // Step 3: Split into the spectrum of the real input
+        // X[k] = E[k] + W^k O[k], E = (Z[k] + conj(Z[M-k])) / 2, O = (Z[k] - conj(Z[M-k])) / 2i
+        spectrum[0] = z[0] + z[1];
+        spectrum[1] = 0;
+        spectrum[HALF_SIZE * 2] = z[0] - z[1];
+        spectrum[HALF_SIZE * 2 + 1] = 0;
+        
+        for (int k = 1; k < HALF_SIZE; ++k)
+        {
+            const int mirror = HALF_SIZE - k;
+            
+            const Sample zr = z[k * 2];
+            const Sample zi = z[k * 2 + 1];
+            const Sample mr = z[mirror * 2];
+            const Sample mi = -z[mirror * 2 + 1];
+            
+            const Sample evenReal = Sample(0.5) * (zr + mr);
+            const Sample evenImag = Sample(0.5) * (zi + mi);
+            const Sample oddReal = Sample(0.5) * (zi - mi);
+            const Sample oddImag = Sample(-0.5) * (zr - mr);
+            
+            const Sample wr = REAL_SPLIT_TWIDDLES[static_cast<size_t>(k * 2)];
+            const Sample wi = REAL_SPLIT_TWIDDLES[static_cast<size_t>(k * 2 + 1)];
+            
+            spectrum[k * 2] = evenReal + wr * oddReal - wi * oddImag;
+            spectrum[k * 2 + 1] = evenImag + wr * oddImag + wi * oddReal;
+        }
+    }
+    
+    // Inverse of performRealForward, including the 1/Size scaling
+    void performRealInverse(const Sample* spectrum, Sample* output)
+    {
+        Sample* z = workBuffer.data();
+        
+        // Step 1: Rebuild the packed half-size spectrum, conjugated and bit
+        // reversed so a forward FFT performs the inverse
+        for (int k = 0; k < HALF_SIZE; ++k)
+        {
+            const int mirror = HALF_SIZE - k;
+            
+            const Sample xr = spectrum[k * 2];
+            const Sample xi = spectrum[k * 2 + 1];
+            const Sample mr = spectrum[mirror * 2];
+            const Sample mi = -spectrum[mirror * 2 + 1];
+            
+            const Sample evenReal = Sample(0.5) * (xr + mr);
+            const Sample evenImag = Sample(0.5) * (xi + mi);
+            const Sample diffReal = Sample(0.5) * (xr - mr);
+            const Sample diffImag = Sample(0.5) * (xi - mi);
+            
+            const Sample wr = REAL_SPLIT_TWIDDLES[static_cast<size_t>(k * 2)];
+            const Sample wi = -REAL_SPLIT_TWIDDLES[static_cast<size_t>(k * 2 + 1)];
+            
+            const Sample oddReal = diffReal * wr - diffImag * wi;
+            const Sample oddImag = diffReal * wi + diffImag * wr;
+            
+            const int target = BIT_REVERSED_INDEX[static_cast<size_t>(k)];
+            z[target * 2] = evenReal - oddImag;
+            z[target * 2 + 1] = -(evenImag + oddReal);
+        }
+        
+        // Step 2: Forward FFT of the conjugate
+        performComplexFFT(z);
+        
+        // Step 3: Conjugate back, scale and unpack even/odd samples
+        constexpr Sample scale = Sample(1) / Sample(HALF_SIZE);
+        for (int n = 0; n < HALF_SIZE; ++n)
+        {
+            output[n * 2] = z[n * 2] * scale;
+            output[n * 2 + 1] = -z[n * 2 + 1] * scale;
+        }
+    }
+
+private:
+    alignas(64) std::array<Sample, HALF_SIZE * 2> workBuffer {};
+    
+    static constexpr int getLog2(int value)
+    {
+        int log2 = 0;
+        while ((1 << log2) < value)
+            ++log2;
+        return log2;
+    }
+    
+    // Pairs of radix-2 stages fused into radix-4 passes, with a single
+    // radix-2 pass first when log2(HALF_SIZE) is odd
+    static constexpr bool NEEDS_RADIX2_STAGE = getLog2(HALF_SIZE) % 2 != 0;
+    static constexpr int FIRST_QUARTER_SPAN = NEEDS_RADIX2_STAGE ? 2 : 1;
+    
+    static constexpr std::array<int, HALF_SIZE> makeBitReversedIndex()
+    {
+        std::array<int, HALF_SIZE> table {};
+        int j = 0;
+        
+        for (int i = 0; i < HALF_SIZE; ++i)
+        {
+            table[static_cast<size_t>(i)] = j;
+            
+            int k = HALF_SIZE >> 1;
+            while (k >= 1 && k <= j)
+            {
+                j -= k;
+                k >>= 1;
+            }
+            j += k;
+        }
+        
+        return table;
+    }
+    
+    // W_Size^k for k < HALF_SIZE, interleaved
+    static constexpr std::array<Sample, HALF_SIZE * 2> makeRealSplitTwiddles()
+    {
+        std::array<Sample, HALF_SIZE * 2> table {};
+        
+        for (int k = 0; k < HALF_SIZE; ++k)
+        {
+            const double angle = -2.0 * ConstexprMath::PI * k / Size;
+            table[static_cast<size_t>(k * 2)] = static_cast<Sample>(ConstexprMath::cos(angle));
+            table[static_cast<size_t>(k * 2 + 1)] = static_cast<Sample>(ConstexprMath::sin(angle));
+        }
+        
+        return table;
+    }
+    
+    static constexpr std::array<int, HALF_SIZE> BIT_REVERSED_INDEX = makeBitReversedIndex();
+    static constexpr std::array<Sample, HALF_SIZE * 2> REAL_SPLIT_TWIDDLES = makeRealSplitTwiddles();
+    
+    // One radix-4 pass's w1, w2 and w3 blocks (QuarterSpan interleaved
+    // complex values each), laid out as FFTEngine's
+    template <int QuarterSpan>
+    struct StageTwiddles
+    {
+        static constexpr std::array<Sample, QuarterSpan * 6> make()
+        {
+            std::array<Sample, QuarterSpan * 6> table {};
+            
+            for (int power = 1; power <= 3; ++power)
+            {
+                for (int k = 0; k < QuarterSpan; ++k)
+                {
+                    const double angle = -2.0 * ConstexprMath::PI * power * k / (QuarterSpan * 4);
+                    const auto index = static_cast<size_t>(((power - 1) * QuarterSpan + k) * 2);
+                    table[index] = static_cast<Sample>(ConstexprMath::cos(angle));
+                    table[index + 1] = static_cast<Sample>(ConstexprMath::sin(angle));
+                }
+            }
+            
+            return table;
+        }
+        
+        static constexpr std::array<Sample, QuarterSpan * 6> TABLE = make();
+    };
+    
+    static void performComplexFFT(Sample* data)
+    {
+        // Input is expected in bit-reversed order
+        if constexpr (NEEDS_RADIX2_STAGE)
+            performRadix2Stage(data);
+        
+        performRadix4Stages<FIRST_QUARTER_SPAN>(data);
+    }
+    
+    static void performRadix2Stage(Sample* data)
+    {
+        // First stage only: every twiddle factor is 1
+        for (int i = 0; i < HALF_SIZE; i += 2)
+        {
+            const Sample ar = data[i * 2];
+            const Sample ai = data[i * 2 + 1];
+            const Sample br = data[i * 2 + 2];
+            const Sample bi = data[i * 2 + 3];
+            
+            data[i * 2] = ar + br;
+            data[i * 2 + 1] = ai + bi;
+            data[i * 2 + 2] = ar - br;
+            data[i * 2 + 3] = ai - bi;
+        }
+    }
+    
+    // This pass, then the next one four times as wide, until the whole
+    // transform is covered
+    template <int QuarterSpan>
+    static void performRadix4Stages(Sample* data)
+    {
+        if constexpr (QuarterSpan * 4 <= HALF_SIZE)
+        {
+            if constexpr (std::is_same_v<Sample, float> && QuarterSpan >= 4)
+                SimdKernels::getActive().radix4Stage(data, StageTwiddles<QuarterSpan>::TABLE.data(), HALF_SIZE, QuarterSpan);
+            else
+                performRadix4Stage<QuarterSpan>(data);
+            performRadix4Stages<QuarterSpan * 4>(data);
+        }
+    }
+    
+    template <int QuarterSpan>
+    static void performRadix4Stage(Sample* data)
+    {
+        constexpr int span = QuarterSpan * 4;
+        const Sample* w1Table = StageTwiddles<QuarterSpan>::TABLE.data();
+        const Sample* w2Table = w1Table + QuarterSpan * 2;
+        const Sample* w3Table = w1Table + QuarterSpan * 4;
+        
+        for (int group = 0; group < HALF_SIZE; group += span)
+        {
+            for (int k = 0; k < QuarterSpan; ++k)
+            {
+                Sample* a = data + (group + k) * 2;
+                Sample* b = a + QuarterSpan * 2;
+                Sample* c = b + QuarterSpan * 2;
+                Sample* d = c + QuarterSpan * 2;
+                
+                const Sample* w1 = w1Table + k * 2;
+                const Sample* w2 = w2Table + k * 2;
+                const Sample* w3 = w3Table + k * 2;
+                
+                const Sample bwr = b[0] * w2[0] - b[1] * w2[1];
+                const Sample bwi = b[0] * w2[1] + b[1] * w2[0];
+                const Sample cwr = c[0] * w1[0] - c[1] * w1[1];
+                const Sample cwi = c[0] * w1[1] + c[1] * w1[0];
+                const Sample dwr = d[0] * w3[0] - d[1] * w3[1];
+                const Sample dwi = d[0] * w3[1] + d[1] * w3[0];
+                
+                const Sample sumAR = a[0] + bwr;
+                const Sample sumAI = a[1] + bwi;
+                const Sample diffAR = a[0] - bwr;
+                const Sample diffAI = a[1] - bwi;
+                const Sample sumCR = cwr + dwr;
+                const Sample sumCI = cwi + dwi;
+                const Sample diffCR = cwr - dwr;
+                const Sample diffCI = cwi - dwi;
+                
+                a[0] = sumAR + sumCR;
+                a[1] = sumAI + sumCI;
+                c[0] = sumAR - sumCR;
+                c[1] = sumAI - sumCI;
+                
+                // Multiplying (diffC) by -i gives (diffCI, -diffCR)
+                b[0] = diffAR + diffCI;
+                b[1] = diffAI - diffCR;
+                d[0] = diffAR - diffCI;
+                d[1] = diffAI + diffCR;
+            }
+        }
+    }
+};
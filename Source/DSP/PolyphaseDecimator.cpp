@@ -0,0 +1,105 @@
+#include "PolyphaseDecimator.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+
+int PolyphaseDecimator::chooseFactor(double sampleRate, double minimumOutputRate)
+{
+    int newFactor = 1;
+    while (sampleRate / (newFactor * 2) >= minimumOutputRate)
+        newFactor *= 2;
+    
+    return newFactor;
+}
+
+void PolyphaseDecimator::prepare(int newFactor)
+{
+    factor = std::max(1, newFactor);
+    
+    phaseCoefficients.resize(static_cast<size_t>(factor * TAPS_PER_PHASE));
+    phaseHistory.resize(static_cast<size_t>(factor * TAPS_PER_PHASE * 2));
+    
+    designFilter();
+    reset();
+}
+
+void PolyphaseDecimator::reset()
+{
+    std::fill(phaseHistory.begin(), phaseHistory.end(), 0.0f);
+    historyIndex = 0;
+    inputPhase = 0;
+}
+
+void PolyphaseDecimator::designFilter()
+{
+    // Step 1: Blackman-windowed sinc prototype, cut off at CUTOFF_FRACTION of
+    // the output rate
+    const int numTaps = factor * TAPS_PER_PHASE;
+    const double cutoff = CUTOFF_FRACTION / factor;   // Cycles per input sample
+    const double centre = (numTaps - 1) * 0.5;
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
+    
+    std::vector<double> prototype(static_cast<size_t>(numTaps));
+    double sum = 0.0;
+    
+    for (int k = 0; k < numTaps; ++k)
+    {
+        double x = k - centre;
+        double sinc = (x == 0.0) ? 2.0 * cutoff : std::sin(twoPi * cutoff * x) / (juce::MathConstants<double>::pi * x);
+        double window = 0.42 - 0.5 * std::cos(twoPi * k / (numTaps - 1)) + 0.08 * std::cos(2.0 * twoPi * k / (numTaps - 1));
+        
+        prototype[static_cast<size_t>(k)] = sinc * window;
+        sum += prototype[static_cast<size_t>(k)];
+    }
+    
+    // Step 2: Split into polyphase sub-filters with unity DC gain overall.
+    // Tap k = q * factor + p belongs to phase p; each phase is stored
+    // reversed so it lines up with its oldest-first history
+    for (int p = 0; p < factor; ++p)
+    {
+        float* coefficients = phaseCoefficients.data() + p * TAPS_PER_PHASE;
+        
+        for (int q = 0; q < TAPS_PER_PHASE; ++q)
+            coefficients[TAPS_PER_PHASE - 1 - q] = static_cast<float>(prototype[static_cast<size_t>(q * factor + p)] / sum);
+    }
+}
+
+int PolyphaseDecimator::process(const float* input, int numInputSamples, float* output)
+{
+    if (factor == 1)
+    {
+        std::copy(input, input + numInputSamples, output);
+        return numInputSamples;
+    }
+    
+    int numOutputSamples = 0;
+    
+    for (int i = 0; i < numInputSamples; ++i)
+    {
+        // Step 1: Commutate - the newest sample of each period feeds phase 0,
+        // the oldest feeds phase factor - 1
+        int phase = factor - 1 - inputPhase;
+        float* history = phaseHistory.data() + phase * TAPS_PER_PHASE * 2;
+        history[historyIndex] = input[i];
+        history[historyIndex + TAPS_PER_PHASE] = input[i];
+        
+        if (++inputPhase < factor)
+            continue;
+        
+        // Step 2: One output per period, summed over the sub-filters
+        inputPhase = 0;
+        float sum = 0.0f;
+        
+        for (int p = 0; p < factor; ++p)
+        {
+            const float* window = phaseHistory.data() + p * TAPS_PER_PHASE * 2 + historyIndex + 1;
+            sum += kernels->dotProduct(phaseCoefficients.data() + p * TAPS_PER_PHASE, window, TAPS_PER_PHASE);
+        }
+        
+        output[numOutputSamples++] = sum;
+        
+        historyIndex = (historyIndex + 1) % TAPS_PER_PHASE;
+    }
+    
+    return numOutputSamples;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SimdKernels.h"
+#include <vector>
+
+// Anti-aliased integer-factor downsampler for the analysis front end.
+//
+// The pitch range tops out at a few hundred Hz, so the detectors don't need
+// the host rate. A windowed-sinc low-pass is split into `factor` polyphase
+// sub-filters; each input sample is routed to one of them and an output
+// sample is produced once every `factor` inputs, so only the samples that
+// survive decimation are ever filtered. Sub-filter histories are stored twice
+// over so every dot product reads one contiguous run of memory.
+class PolyphaseDecimator
+{
+public:
+    PolyphaseDecimator() = default;
+    ~PolyphaseDecimator() = default;
+    
+    // Largest power-of-two factor that keeps the output rate at or above
+    // minimumOutputRate (1 if the host rate is already that low)
+    static int chooseFactor(double sampleRate, double minimumOutputRate);
+    
+    // Design the filter and allocate the histories (not real-time safe)
+    void prepare(int factor);
+    
+    // Forget filter state and any partially collected output period
+    void reset();
+    
+    int getFactor() const { return factor; }
+    
+    // How far the linear-phase filter delays the signal, in input samples
+    double getLatency() const { return factor > 1 ? (factor * TAPS_PER_PHASE - 1) * 0.5 : 0.0; }
+    
+    // Output samples that numInputSamples can produce at most
+    int getMaxOutputSamples(int numInputSamples) const { return numInputSamples / factor + 1; }
+    
+    // Filter and downsample a block; returns the number of samples written
+    // to output (which needs room for getMaxOutputSamples(numInputSamples))
+    int process(const float* input, int numInputSamples, float* output);
+    
+    // Override the CPU-selected SIMD kernels (e.g. to validate a specific variant)
+    void setKernelTable(const SimdKernelTable& table) { kernels = &table; }
+
+private:
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    
+    int factor = 1;
+    std::vector<float> phaseCoefficients;   // [phase][tap], taps reversed to match oldest-first history
+    std::vector<float> phaseHistory;        // [phase][2 * TAPS_PER_PHASE], each value written twice
+    int historyIndex = 0;                   // Shared write position within each phase's history
+    int inputPhase = 0;                     // Input samples collected towards the next output
+    
+    // 32 taps per phase puts the Blackman transition band just below the
+    // output Nyquist, whatever the factor
+    static constexpr int TAPS_PER_PHASE = 32;
+    static constexpr double CUTOFF_FRACTION = 0.4;   // Of the output sample rate
+    
+    void designFilter();
+};
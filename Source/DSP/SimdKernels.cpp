@@ -0,0 +1,95 @@
+#include "SimdKernels.h"
+#include "SimdKernelsImpl.h"
+#include <juce_core/juce_core.h>
+#include <cmath>
+
+namespace
+{
+    // Portable four-lane fallback. Plain loops over a small fixed-size struct
+    // are auto-vectorised by the compiler on both x86 and ARM (NEON).
+    struct GenericOps
+    {
+        static constexpr int FLOATS_PER_VECTOR = 4;
+        struct Vec { float v[FLOATS_PER_VECTOR]; };
+        
+        static Vec load(const float* p) { Vec r; for (int i = 0; i < 4; ++i) r.v[i] = p[i]; return r; }
+        static void store(float* p, Vec a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+        static Vec zero() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+        static Vec ramp(float first) { return { { first, first + 1.0f, first + 2.0f, first + 3.0f } }; }
+        
+        static Vec add(Vec a, Vec b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+        static Vec sub(Vec a, Vec b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+        static Vec mul(Vec a, Vec b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+        static Vec div(Vec a, Vec b) { for (int i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+        static Vec sqrt(Vec a) { for (int i = 0; i < 4; ++i) a.v[i] = std::sqrt(a.v[i]); return a; }
+        static float sqrtScalar(float x) { return std::sqrt(x); }
+        static float horizontalSum(Vec a) { return (a.v[0] + a.v[2]) + (a.v[1] + a.v[3]); }
+        
+        static Vec pairwiseSum(Vec a, Vec b)
+        {
+            return { { a.v[0] + a.v[1], a.v[2] + a.v[3], b.v[0] + b.v[1], b.v[2] + b.v[3] } };
+        }
+        
+        static Vec complexMul(Vec a, Vec w)
+        {
+            Vec r;
+            for (int i = 0; i < 4; i += 2)
+            {
+                r.v[i] = a.v[i] * w.v[i] - a.v[i + 1] * w.v[i + 1];
+                r.v[i + 1] = a.v[i] * w.v[i + 1] + a.v[i + 1] * w.v[i];
+            }
+            return r;
+        }
+        
+        static Vec conjugate(Vec a) { a.v[1] = -a.v[1]; a.v[3] = -a.v[3]; return a; }
+        static Vec mulByMinusI(Vec a) { return { { a.v[1], -a.v[0], a.v[3], -a.v[2] } }; }
+    };
+    
+    constexpr SimdKernelTable genericTable = SimdKernelImpl<GenericOps>::makeTable(SimdInstructionSet::Generic, "Generic");
+}
+
+namespace SimdKernels
+{
+    SimdInstructionSet detectInstructionSet()
+    {
+       #if JUCE_INTEL
+        // JUCE reads these from CPUID once at startup
+        if (juce::SystemStats::hasAVX512F() && getSimdKernelTableAVX512() != nullptr)
+            return SimdInstructionSet::AVX512;
+        
+        if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3() && getSimdKernelTableAVX2() != nullptr)
+            return SimdInstructionSet::AVX2;
+        
+        if (juce::SystemStats::hasSSE2() && getSimdKernelTableSSE2() != nullptr)
+            return SimdInstructionSet::SSE2;
+       #endif
+        
+        return SimdInstructionSet::Generic;
+    }
+    
+    const SimdKernelTable* get(SimdInstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case SimdInstructionSet::Generic:
+                return &genericTable;
+           #if JUCE_INTEL
+            case SimdInstructionSet::SSE2:
+                return juce::SystemStats::hasSSE2() ? getSimdKernelTableSSE2() : nullptr;
+            case SimdInstructionSet::AVX2:
+                return (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3()) ? getSimdKernelTableAVX2() : nullptr;
+            case SimdInstructionSet::AVX512:
+                return juce::SystemStats::hasAVX512F() ? getSimdKernelTableAVX512() : nullptr;
+           #endif
+            default:
+                return nullptr;
+        }
+    }
+    
+    const SimdKernelTable& getActive()
+    {
+        // Function-local static: detected once, thread-safe initialisation
+        static const SimdKernelTable& active = *get(detectInstructionSet());
+        return active;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// Vectorised inner loops shared by the pitch detectors.
+//
+// Every kernel exists as a portable generic version (plain loops that the
+// compiler can auto-vectorise, including for NEON) plus SSE2, AVX2 and
+// AVX-512 versions on x86. The best variant the running CPU supports is
+// chosen once at startup, so a single binary is fast on every machine.
+enum class SimdInstructionSet
+{
+    Generic,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+struct SimdKernelTable
+{
+    SimdInstructionSet instructionSet;
+    const char* name;
+    
+    // out[i] = a[i] * b[i] (windowing)
+    void (*multiply)(const float* a, const float* b, float* out, int numSamples);
+    
+    // Sum of (a[i] - b[i])^2 (YIN difference function, direct form)
+    float (*sumOfSquaredDifferences)(const float* a, const float* b, int numSamples);
+    
+    // Sum of a[i] * b[i] (FIR filtering)
+    float (*dotProduct)(const float* a, const float* b, int numSamples);
+    
+    // out[t] = values[t] * (t + 1) / runningSums[t] for t in [start, end)
+    // (YIN cumulative mean normalisation; out may alias runningSums)
+    void (*divideByRunningMean)(const float* values, const float* runningSums, float* out, int start, int end);
+    
+    // out[k] = |spectrum[k]| for interleaved complex bins
+    void (*complexMagnitude)(const float* spectrum, float* out, int numBins);
+    
+    // out[k] = conj(a[k]) * b[k] for interleaved complex bins (cross-spectrum)
+    void (*complexMultiplyConjugate)(const float* a, const float* b, float* out, int numBins);
+    
+    // One radix-4 decimation-in-time pass over numComplex interleaved values.
+    // twiddles holds w1, w2 and w3 for k < quarterSpan as three consecutive
+    // blocks of quarterSpan interleaved complex values.
+    void (*radix4Stage)(float* data, const float* twiddles, int numComplex, int quarterSpan);
+};
+
+namespace SimdKernels
+{
+    // Best kernel set for this CPU (detected once, thread-safe)
+    const SimdKernelTable& getActive();
+    
+    // A specific kernel set, or nullptr if it was not compiled in or the CPU
+    // does not support it. Useful for validating variants against Generic.
+    const SimdKernelTable* get(SimdInstructionSet instructionSet);
+    
+    // Widest instruction set supported by the running CPU
+    SimdInstructionSet detectInstructionSet();
+}
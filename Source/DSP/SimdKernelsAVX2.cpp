@@ -0,0 +1,73 @@
+#include "SimdKernelsImpl.h"
+
+// Built with AVX2/FMA code generation (see CMakeLists.txt); only reached
+// after the dispatcher has confirmed CPU support
+#if (defined(__AVX2__) && defined(__FMA__)) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+
+#include <immintrin.h>
+
+namespace
+{
+    struct AVX2Ops
+    {
+        static constexpr int FLOATS_PER_VECTOR = 8;
+        using Vec = __m256;
+        
+        static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+        static void store(float* p, Vec a) { _mm256_storeu_ps(p, a); }
+        static Vec zero() { return _mm256_setzero_ps(); }
+        static Vec ramp(float first) { return _mm256_add_ps(_mm256_set1_ps(first), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)); }
+        
+        static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+        static Vec sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+        static float sqrtScalar(float x) { return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x))); }
+        
+        static float horizontalSum(Vec a)
+        {
+            __m128 quad = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+            __m128 pair = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+            return _mm_cvtss_f32(_mm_add_ss(pair, _mm_movehdup_ps(pair)));
+        }
+        
+        static Vec pairwiseSum(Vec a, Vec b)
+        {
+            // Shuffles stay within 128-bit lanes, so restore the order afterwards
+            Vec even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            Vec odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            __m256d sums = _mm256_castps_pd(_mm256_add_ps(even, odd));
+            return _mm256_castpd_ps(_mm256_permute4x64_pd(sums, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        
+        static Vec complexMul(Vec a, Vec w)
+        {
+            Vec real = _mm256_moveldup_ps(a);
+            Vec imag = _mm256_movehdup_ps(a);
+            Vec swapped = _mm256_permute_ps(w, _MM_SHUFFLE(2, 3, 0, 1));
+            return _mm256_fmaddsub_ps(real, w, _mm256_mul_ps(imag, swapped));
+        }
+        
+        static Vec conjugate(Vec a)
+        {
+            const Vec oddSign = _mm256_castsi256_ps(_mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL)));
+            return _mm256_xor_ps(a, oddSign);
+        }
+        
+        static Vec mulByMinusI(Vec a)
+        {
+            return conjugate(_mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    };
+    
+    constexpr SimdKernelTable avx2Table = SimdKernelImpl<AVX2Ops>::makeTable(SimdInstructionSet::AVX2, "AVX2");
+}
+
+const SimdKernelTable* getSimdKernelTableAVX2() { return &avx2Table; }
+
+#else
+
+const SimdKernelTable* getSimdKernelTableAVX2() { return nullptr; }
+
+#endif
@@ -0,0 +1,87 @@
+#include "SimdKernelsImpl.h"
+
+// Built with AVX-512F code generation (see CMakeLists.txt); only reached
+// after the dispatcher has confirmed CPU support
+#if defined(__AVX512F__) || (defined(_MSC_VER) && defined(_M_X64))
+
+// GCC 12's AVX-512 intrinsics pass _mm512_undefined_ps() and friends as the
+// unused source of their masked builtins, then report that source as
+// uninitialised wherever they are inlined. The warnings point into the
+// header, so silencing them around the include leaves our own code checked.
+#if defined(__GNUC__) && !defined(__clang__)
+ #pragma GCC diagnostic push
+ #pragma GCC diagnostic ignored "-Wuninitialized"
+ #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+ #include <immintrin.h>
+ #pragma GCC diagnostic pop
+#else
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    struct AVX512Ops
+    {
+        static constexpr int FLOATS_PER_VECTOR = 16;
+        using Vec = __m512;
+        
+        static Vec load(const float* p) { return _mm512_loadu_ps(p); }
+        static void store(float* p, Vec a) { _mm512_storeu_ps(p, a); }
+        static Vec zero() { return _mm512_setzero_ps(); }
+        
+        static Vec ramp(float first)
+        {
+            const Vec offsets = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                               8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+            return _mm512_add_ps(_mm512_set1_ps(first), offsets);
+        }
+        
+        static Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) { return _mm512_div_ps(a, b); }
+        static Vec sqrt(Vec a) { return _mm512_sqrt_ps(a); }
+        static float sqrtScalar(float x) { return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x))); }
+        static float horizontalSum(Vec a) { return _mm512_reduce_add_ps(a); }
+        
+        static Vec pairwiseSum(Vec a, Vec b)
+        {
+            // Shuffles stay within 128-bit lanes, so gather the a and b halves afterwards
+            Vec even = _mm512_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            Vec odd = _mm512_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            __m512d sums = _mm512_castps_pd(_mm512_add_ps(even, odd));
+            const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+            return _mm512_castpd_ps(_mm512_permutexvar_pd(order, sums));
+        }
+        
+        static Vec complexMul(Vec a, Vec w)
+        {
+            Vec real = _mm512_moveldup_ps(a);
+            Vec imag = _mm512_movehdup_ps(a);
+            Vec swapped = _mm512_permute_ps(w, _MM_SHUFFLE(2, 3, 0, 1));
+            return _mm512_fmaddsub_ps(real, w, _mm512_mul_ps(imag, swapped));
+        }
+        
+        static Vec conjugate(Vec a)
+        {
+            // Integer xor: _mm512_xor_ps would require AVX-512DQ
+            const __m512i oddSign = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+            return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), oddSign));
+        }
+        
+        static Vec mulByMinusI(Vec a)
+        {
+            return conjugate(_mm512_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    };
+    
+    constexpr SimdKernelTable avx512Table = SimdKernelImpl<AVX512Ops>::makeTable(SimdInstructionSet::AVX512, "AVX-512");
+}
+
+const SimdKernelTable* getSimdKernelTableAVX512() { return &avx512Table; }
+
+#else
+
+const SimdKernelTable* getSimdKernelTableAVX512() { return nullptr; }
+
+#endif
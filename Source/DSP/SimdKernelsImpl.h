@@ -0,0 +1,253 @@
+#pragma once
+
+#include "SimdKernels.h"
+
+// Shared kernel bodies, written once against a small vector abstraction.
+// Each SimdKernels*.cpp defines its Ops type in an anonymous namespace and is
+// built with its own compiler flags. Instantiating SimdKernelImpl with an
+// internal-linkage Ops keeps every instantiation internal too, so code built
+// for one instruction set is never merged with another's by the linker.
+//
+// Ops must provide:
+//   Vec, FLOATS_PER_VECTOR
+//   load, store, add, sub, mul, div, sqrt, zero, horizontalSum
+//   complexMul(a, w)      - interleaved complex product
+//   conjugate(a)          - interleaved complex conjugate
+//   mulByMinusI(a)        - interleaved complex a * -i
+//   pairwiseSum(a, b)     - [a0+a1, a2+a3, ..., b0+b1, b2+b3, ...]
+//   ramp(first)           - [first, first+1, first+2, ...]
+//   sqrtScalar(x)         - scalar square root without libm
+template <typename Ops>
+struct SimdKernelImpl
+{
+    using Vec = typename Ops::Vec;
+    static constexpr int W = Ops::FLOATS_PER_VECTOR;
+    static constexpr int COMPLEX_PER_VECTOR = W / 2;
+    
+    static void multiply(const float* a, const float* b, float* out, int numSamples)
+    {
+        int i = 0;
+        for (; i + W <= numSamples; i += W)
+            Ops::store(out + i, Ops::mul(Ops::load(a + i), Ops::load(b + i)));
+        
+        for (; i < numSamples; ++i)
+            out[i] = a[i] * b[i];
+    }
+    
+    static float sumOfSquaredDifferences(const float* a, const float* b, int numSamples)
+    {
+        // Two accumulators hide the add latency
+        Vec sum0 = Ops::zero();
+        Vec sum1 = Ops::zero();
+        int i = 0;
+        
+        for (; i + 2 * W <= numSamples; i += 2 * W)
+        {
+            Vec d0 = Ops::sub(Ops::load(a + i), Ops::load(b + i));
+            Vec d1 = Ops::sub(Ops::load(a + i + W), Ops::load(b + i + W));
+            sum0 = Ops::add(sum0, Ops::mul(d0, d0));
+            sum1 = Ops::add(sum1, Ops::mul(d1, d1));
+        }
+        
+        for (; i + W <= numSamples; i += W)
+        {
+            Vec d = Ops::sub(Ops::load(a + i), Ops::load(b + i));
+            sum0 = Ops::add(sum0, Ops::mul(d, d));
+        }
+        
+        float sum = Ops::horizontalSum(Ops::add(sum0, sum1));
+        
+        for (; i < numSamples; ++i)
+        {
+            float d = a[i] - b[i];
+            sum += d * d;
+        }
+        
+        return sum;
+    }
+    
+    static float dotProduct(const float* a, const float* b, int numSamples)
+    {
+        Vec sum0 = Ops::zero();
+        Vec sum1 = Ops::zero();
+        int i = 0;
+        
+        for (; i + 2 * W <= numSamples; i += 2 * W)
+        {
+            sum0 = Ops::add(sum0, Ops::mul(Ops::load(a + i), Ops::load(b + i)));
+            sum1 = Ops::add(sum1, Ops::mul(Ops::load(a + i + W), Ops::load(b + i + W)));
+        }
+        
+        for (; i + W <= numSamples; i += W)
+            sum0 = Ops::add(sum0, Ops::mul(Ops::load(a + i), Ops::load(b + i)));
+        
+        float sum = Ops::horizontalSum(Ops::add(sum0, sum1));
+        
+        for (; i < numSamples; ++i)
+            sum += a[i] * b[i];
+        
+        return sum;
+    }
+    
+    static void divideByRunningMean(const float* values, const float* runningSums, float* out, int start, int end)
+    {
+        int t = start;
+        for (; t + W <= end; t += W)
+        {
+            Vec count = Ops::ramp(static_cast<float>(t + 1));
+            Vec scaled = Ops::mul(Ops::load(values + t), count);
+            Ops::store(out + t, Ops::div(scaled, Ops::load(runningSums + t)));
+        }
+        
+        for (; t < end; ++t)
+            out[t] = values[t] * static_cast<float>(t + 1) / runningSums[t];
+    }
+    
+    static void complexMagnitude(const float* spectrum, float* out, int numBins)
+    {
+        int k = 0;
+        for (; k + W <= numBins; k += W)
+        {
+            Vec first = Ops::load(spectrum + k * 2);
+            Vec second = Ops::load(spectrum + k * 2 + W);
+            Vec power = Ops::pairwiseSum(Ops::mul(first, first), Ops::mul(second, second));
+            Ops::store(out + k, Ops::sqrt(power));
+        }
+        
+        for (; k < numBins; ++k)
+        {
+            float real = spectrum[k * 2];
+            float imag = spectrum[k * 2 + 1];
+            out[k] = Ops::sqrtScalar(real * real + imag * imag);
+        }
+    }
+    
+    static void complexMultiplyConjugate(const float* a, const float* b, float* out, int numBins)
+    {
+        int k = 0;
+        for (; k + COMPLEX_PER_VECTOR <= numBins; k += COMPLEX_PER_VECTOR)
+        {
+            Vec conjA = Ops::conjugate(Ops::load(a + k * 2));
+            Ops::store(out + k * 2, Ops::complexMul(Ops::load(b + k * 2), conjA));
+        }
+        
+        for (; k < numBins; ++k)
+        {
+            float ar = a[k * 2];
+            float ai = a[k * 2 + 1];
+            float br = b[k * 2];
+            float bi = b[k * 2 + 1];
+            
+            out[k * 2] = ar * br + ai * bi;
+            out[k * 2 + 1] = ar * bi - ai * br;
+        }
+    }
+    
+    static void radix4Stage(float* data, const float* twiddles, int numComplex, int quarterSpan)
+    {
+        if (quarterSpan < COMPLEX_PER_VECTOR)
+        {
+            radix4StageScalar(data, twiddles, numComplex, quarterSpan);
+            return;
+        }
+        
+        const int span = quarterSpan * 4;
+        const float* w1Table = twiddles;
+        const float* w2Table = twiddles + quarterSpan * 2;
+        const float* w3Table = twiddles + quarterSpan * 4;
+        
+        for (int group = 0; group < numComplex; group += span)
+        {
+            for (int k = 0; k < quarterSpan; k += COMPLEX_PER_VECTOR)
+            {
+                float* a = data + (group + k) * 2;
+                float* b = a + quarterSpan * 2;
+                float* c = b + quarterSpan * 2;
+                float* d = c + quarterSpan * 2;
+                
+                Vec av = Ops::load(a);
+                Vec bw = Ops::complexMul(Ops::load(b), Ops::load(w2Table + k * 2));
+                Vec cw = Ops::complexMul(Ops::load(c), Ops::load(w1Table + k * 2));
+                Vec dw = Ops::complexMul(Ops::load(d), Ops::load(w3Table + k * 2));
+                
+                Vec sumA = Ops::add(av, bw);
+                Vec diffA = Ops::sub(av, bw);
+                Vec sumC = Ops::add(cw, dw);
+                Vec diffC = Ops::mulByMinusI(Ops::sub(cw, dw));
+                
+                Ops::store(a, Ops::add(sumA, sumC));
+                Ops::store(c, Ops::sub(sumA, sumC));
+                Ops::store(b, Ops::add(diffA, diffC));
+                Ops::store(d, Ops::sub(diffA, diffC));
+            }
+        }
+    }
+    
+    static void radix4StageScalar(float* data, const float* twiddles, int numComplex, int quarterSpan)
+    {
+        const int span = quarterSpan * 4;
+        const float* w1Table = twiddles;
+        const float* w2Table = twiddles + quarterSpan * 2;
+        const float* w3Table = twiddles + quarterSpan * 4;
+        
+        for (int group = 0; group < numComplex; group += span)
+        {
+            for (int k = 0; k < quarterSpan; ++k)
+            {
+                float* a = data + (group + k) * 2;
+                float* b = a + quarterSpan * 2;
+                float* c = b + quarterSpan * 2;
+                float* d = c + quarterSpan * 2;
+                
+                const float* w1 = w1Table + k * 2;
+                const float* w2 = w2Table + k * 2;
+                const float* w3 = w3Table + k * 2;
+                
+                float bwr = b[0] * w2[0] - b[1] * w2[1];
+                float bwi = b[0] * w2[1] + b[1] * w2[0];
+                float cwr = c[0] * w1[0] - c[1] * w1[1];
+                float cwi = c[0] * w1[1] + c[1] * w1[0];
+                float dwr = d[0] * w3[0] - d[1] * w3[1];
+                float dwi = d[0] * w3[1] + d[1] * w3[0];
+                
+                float sumAR = a[0] + bwr;
+                float sumAI = a[1] + bwi;
+                float diffAR = a[0] - bwr;
+                float diffAI = a[1] - bwi;
+                float sumCR = cwr + dwr;
+                float sumCI = cwi + dwi;
+                float diffCR = cwr - dwr;
+                float diffCI = cwi - dwi;
+                
+                a[0] = sumAR + sumCR;
+                a[1] = sumAI + sumCI;
+                c[0] = sumAR - sumCR;
+                c[1] = sumAI - sumCI;
+                
+                // Multiplying (diffC) by -i gives (diffCI, -diffCR)
+                b[0] = diffAR + diffCI;
+                b[1] = diffAI - diffCR;
+                d[0] = diffAR - diffCI;
+                d[1] = diffAI + diffCR;
+            }
+        }
+    }
+    
+    static constexpr SimdKernelTable makeTable(SimdInstructionSet instructionSet, const char* name)
+    {
+        return { instructionSet, name,
+                 &multiply,
+                 &sumOfSquaredDifferences,
+                 &dotProduct,
+                 &divideByRunningMean,
+                 &complexMagnitude,
+                 &complexMultiplyConjugate,
+                 &radix4Stage };
+    }
+};
+
+// Per-instruction-set tables, defined in their own translation units.
+// Each returns nullptr when the variant is not available for this target.
+const SimdKernelTable* getSimdKernelTableSSE2();
+const SimdKernelTable* getSimdKernelTableAVX2();
+const SimdKernelTable* getSimdKernelTableAVX512();
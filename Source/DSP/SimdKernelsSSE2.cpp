@@ -0,0 +1,72 @@
+#include "SimdKernelsImpl.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+namespace
+{
+    struct SSE2Ops
+    {
+        static constexpr int FLOATS_PER_VECTOR = 4;
+        using Vec = __m128;
+        
+        static Vec load(const float* p) { return _mm_loadu_ps(p); }
+        static void store(float* p, Vec a) { _mm_storeu_ps(p, a); }
+        static Vec zero() { return _mm_setzero_ps(); }
+        static Vec ramp(float first) { return _mm_add_ps(_mm_set1_ps(first), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)); }
+        
+        static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+        static Vec sqrt(Vec a) { return _mm_sqrt_ps(a); }
+        static float sqrtScalar(float x) { return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x))); }
+        
+        static float horizontalSum(Vec a)
+        {
+            Vec high = _mm_movehl_ps(a, a);
+            Vec pair = _mm_add_ps(a, high);
+            Vec single = _mm_add_ss(pair, _mm_shuffle_ps(pair, pair, _MM_SHUFFLE(1, 1, 1, 1)));
+            return _mm_cvtss_f32(single);
+        }
+        
+        static Vec pairwiseSum(Vec a, Vec b)
+        {
+            Vec even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            Vec odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            return _mm_add_ps(even, odd);
+        }
+        
+        static Vec complexMul(Vec a, Vec w)
+        {
+            // SSE2 has no addsub, so flip the sign of the even lanes by hand
+            const Vec evenSign = _mm_castsi128_ps(_mm_setr_epi32(static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000), 0));
+            Vec real = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0));
+            Vec imag = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1));
+            Vec swapped = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 3, 0, 1));
+            return _mm_add_ps(_mm_mul_ps(real, w), _mm_xor_ps(_mm_mul_ps(imag, swapped), evenSign));
+        }
+        
+        static Vec conjugate(Vec a)
+        {
+            const Vec oddSign = _mm_castsi128_ps(_mm_setr_epi32(0, static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000)));
+            return _mm_xor_ps(a, oddSign);
+        }
+        
+        static Vec mulByMinusI(Vec a)
+        {
+            return conjugate(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    };
+    
+    constexpr SimdKernelTable sse2Table = SimdKernelImpl<SSE2Ops>::makeTable(SimdInstructionSet::SSE2, "SSE2");
+}
+
+const SimdKernelTable* getSimdKernelTableSSE2() { return &sse2Table; }
+
+#else
+
+const SimdKernelTable* getSimdKernelTableSSE2() { return nullptr; }
+
+#endif
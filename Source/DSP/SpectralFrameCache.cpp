@@ -0,0 +1,160 @@
+#include "SpectralFrameCache.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+void SpectralFrameCache::prepare(double newSampleRate, int newFrameSize, int newPaddingFactor)
+{
+    if (newSampleRate == sampleRate && newFrameSize == frameSize && newPaddingFactor <= paddingFactor)
+        return;
+    
+    sampleRate = newSampleRate;
+    frameSize = newFrameSize;
+    paddingFactor = newPaddingFactor;
+    
+    // Padding to twice the frame keeps the autocorrelation from wrapping
+    fftSize = 4;
+    while (fftSize < frameSize * paddingFactor)
+        fftSize <<= 1;
+    
+    fftEngine.prepare(fftSize);
+    
+    // Resize buffers
+    const size_t numBins = static_cast<size_t>(getNumBins());
+    frame.assign(static_cast<size_t>(frameSize), 0.0f);
+    window.resize(static_cast<size_t>(frameSize));
+    windowedFrame.assign(static_cast<size_t>(fftSize), 0.0f);
+    spectrum.assign(numBins * 2, 0.0f);
+    magnitudeSpectrum.assign(numBins, 0.0f);
+    powerSpectrum.assign(numBins, 0.0f);
+    autocorrelation.assign(static_cast<size_t>(fftSize), 0.0f);
+    cepstrum.assign(static_cast<size_t>(fftSize), 0.0f);
+    inverseInput.assign(numBins * 2, 0.0f);
+    
+    // Hann window over the frame itself, not the padded length
+    for (int i = 0; i < frameSize; ++i)
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / std::max(1, frameSize - 1));
+    
+    hasFrame = false;
+    validProducts = 0;
+    numTransforms = 0;
+}
+
+void SpectralFrameCache::setFrame(const AudioFrameView& samples)
+{
+    jassert(samples.getNumSamples() == frameSize);
+    
+    // Comparing is far cheaper than the FFT it can save
+    if (hasFrame && samples.matches(frame.data()))
+        return;
+    
+    samples.copyTo(frame.data());
+    hasFrame = true;
+    validProducts = 0;
+}
+
+const float* SpectralFrameCache::getWindowedFrame()
+{
+    if (!has(WindowedFrame))
+    {
+        // The padding beyond frameSize stays zero from prepare()
+        kernels->multiply(frame.data(), window.data(), windowedFrame.data(), frameSize);
+        validProducts |= WindowedFrame;
+    }
+    
+    return windowedFrame.data();
+}
+
+const float* SpectralFrameCache::getSpectrum()
+{
+    if (!has(Spectrum))
+    {
+        fftEngine.performRealForward(getWindowedFrame(), spectrum.data());
+        ++numTransforms;
+        validProducts |= Spectrum;
+    }
+    
+    return spectrum.data();
+}
+
+const float* SpectralFrameCache::getMagnitudeSpectrum()
+{
+    if (!has(Magnitude))
+    {
+        kernels->complexMagnitude(getSpectrum(), magnitudeSpectrum.data(), getNumBins());
+        validProducts |= Magnitude;
+    }
+    
+    return magnitudeSpectrum.data();
+}
+
+const float* SpectralFrameCache::getPowerSpectrum()
+{
+    if (!has(Power))
+    {
+        const float* bins = getSpectrum();
+        for (int k = 0; k < getNumBins(); ++k)
+            powerSpectrum[static_cast<size_t>(k)] = bins[2 * k] * bins[2 * k] + bins[2 * k + 1] * bins[2 * k + 1];
+        
+        validProducts |= Power;
+    }
+    
+    return powerSpectrum.data();
+}
+
+const float* SpectralFrameCache::getAutocorrelation()
+{
+    if (!has(Autocorrelation))
+    {
+        // Wiener-Khinchin: r = IFFT(|X|^2)
+        inverseOfRealSpectrum(getPowerSpectrum(), autocorrelation.data());
+        validProducts |= Autocorrelation;
+    }
+    
+    return autocorrelation.data();
+}
+
+const float* SpectralFrameCache::getCepstrum()
+{
+    if (!has(Cepstrum))
+    {
+        // Real cepstrum: c = IFFT(log |X|)
+        const float* magnitude = getMagnitudeSpectrum();
+        const int numBins = getNumBins();
+        
+        float largest = *std::max_element(magnitude, magnitude + numBins);
+        float floor = std::max(largest * CEPSTRUM_FLOOR, std::numeric_limits<float>::min());
+        
+        for (int k = 0; k < numBins; ++k)
+        {
+            inverseInput[static_cast<size_t>(2 * k)] = std::log(std::max(magnitude[k], floor));
+            inverseInput[static_cast<size_t>(2 * k + 1)] = 0.0f;
+        }
+        
+        fftEngine.performRealInverse(inverseInput.data(), cepstrum.data());
+        ++numTransforms;
+        validProducts |= Cepstrum;
+    }
+    
+    return cepstrum.data();
+}
+
+void SpectralFrameCache::inverseOfRealSpectrum(const float* values, float* output)
+{
+    for (int k = 0; k < getNumBins(); ++k)
+    {
+        inverseInput[static_cast<size_t>(2 * k)] = values[k];
+        inverseInput[static_cast<size_t>(2 * k + 1)] = 0.0f;
+    }
+    
+    fftEngine.performRealInverse(inverseInput.data(), output);
+    ++numTransforms;
+}
+
+void SpectralFrameCache::setKernelTable(const SimdKernelTable& table)
+{
+    kernels = &table;
+    fftEngine.setKernelTable(table);
+}
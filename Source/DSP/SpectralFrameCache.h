@@ -0,0 +1,108 @@
+#pragma once
+
+#include "FFTEngine.h"
+#include "SimdKernels.h"
+#include "../Utilities/AudioFrameView.h"
+#include <cstdint>
+#include <vector>
+
+// Spectral products of one analysis frame, computed on first use and shared
+// by every detector that asks for them.
+//
+// setFrame() hands over the next frame. Each product is only computed when
+// some consumer first asks for it, and is kept until a frame with different
+// samples arrives, so several spectral detectors looking at the same frame
+// pay for one window and one forward FFT between them:
+//
+//     windowed frame -> spectrum -> magnitude -> cepstrum
+//                                -> power     -> autocorrelation
+//
+// The frame is Hann-windowed and zero-padded to a power of two at least
+// paddingFactor times its length. Padding to twice the length (the default)
+// makes the autocorrelation linear rather than circular for every lag below
+// the frame size. Like FFTEngine, one instance must only be used from one
+// thread at a time.
+class SpectralFrameCache
+{
+public:
+    SpectralFrameCache() = default;
+    ~SpectralFrameCache() = default;
+    
+    // Size for frames of frameSize samples, padded at least paddingFactor
+    // times (1 or 2). Does nothing when already prepared for the same sizes
+    // with as much padding, so every sharer can call it and a shared cache
+    // ends up with the most padding any of them asked for.
+    void prepare(double sampleRate, int frameSize, int paddingFactor = 2);
+    
+    // Frame whose products the getters return next, read once from the view
+    // into the cache's own copy. Products already computed for identical
+    // samples are kept.
+    void setFrame(const AudioFrameView& samples);
+    void setFrame(const float* samples) { setFrame(AudioFrameView(samples, frameSize)); }
+    
+    // Views valid until the next setFrame() or prepare()
+    const float* getWindowedFrame();      // getFFTSize() samples
+    const float* getSpectrum();           // getNumBins() interleaved complex bins
+    const float* getMagnitudeSpectrum();  // getNumBins() values
+    const float* getPowerSpectrum();      // getNumBins() values
+    const float* getAutocorrelation();    // getNumLags() lags of the windowed frame
+    const float* getCepstrum();           // getNumLags() quefrencies (real cepstrum)
+    
+    double getSampleRate() const { return sampleRate; }
+    int getFrameSize() const { return frameSize; }
+    int getFFTSize() const { return fftSize; }
+    int getNumBins() const { return fftSize / 2 + 1; }
+    int getNumLags() const { return fftSize / 2; }
+    
+    float binToFrequency(float bin) const { return static_cast<float>(bin * sampleRate / fftSize); }
+    float frequencyToBin(float frequency) const { return static_cast<float>(frequency * fftSize / sampleRate); }
+    
+    // FFTs run since prepare(), forward and inverse, to check sharing
+    int getNumTransforms() const { return numTransforms; }
+    
+    // Override the CPU-selected SIMD kernels (e.g. to validate a specific variant)
+    void setKernelTable(const SimdKernelTable& table);
+
+private:
+    enum Product : uint32_t
+    {
+        WindowedFrame = 1 << 0,
+        Spectrum = 1 << 1,
+        Magnitude = 1 << 2,
+        Power = 1 << 3,
+        Autocorrelation = 1 << 4,
+        Cepstrum = 1 << 5
+    };
+    
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    FFTEngine fftEngine;
+    
+    double sampleRate = 0.0;
+    int frameSize = 0;
+    int paddingFactor = 0;
+    int fftSize = 0;
+    
+    std::vector<float> frame;              // Raw samples of the current frame
+    std::vector<float> window;             // Hann window over frameSize samples
+    std::vector<float> windowedFrame;      // fftSize samples, zero-padded
+    std::vector<float> spectrum;           // Interleaved complex bins
+    std::vector<float> magnitudeSpectrum;
+    std::vector<float> powerSpectrum;
+    std::vector<float> autocorrelation;    // fftSize samples, first half used
+    std::vector<float> cepstrum;           // fftSize samples, first half used
+    std::vector<float> inverseInput;       // Interleaved real-valued spectrum for an inverse FFT
+    
+    bool hasFrame = false;
+    uint32_t validProducts = 0;
+    int numTransforms = 0;
+    
+    // Log magnitudes are floored this far below the largest bin, so noise
+    // between the harmonics doesn't mask their ripple in the cepstrum
+    static constexpr float CEPSTRUM_FLOOR = 3.0e-2f;    // -30 dB
+    
+    // Stage-level timing in the benchmark tool
+    friend class DetectorStageBenchmarks;
+    
+    bool has(Product product) const { return (validProducts & product) != 0; }
+    void inverseOfRealSpectrum(const float* values, float* output);
+};
@@ -0,0 +1,360 @@
+#include "RealtimeSafetyChecker.h"
+
+#if PITCH_DETECTION_REALTIME_CHECKS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <malloc.h>
+#else
+ #include <execinfo.h>
+#endif
+
+#if defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #define PITCH_DETECTION_INTERCEPT_LIBC 1
+ // The checker's own thread-locals must not need an allocation on first use
+ // in a dlopen'd plugin, or reading them from malloc would recurse
+ #define PITCH_DETECTION_CHECKER_TLS __attribute__((tls_model("initial-exec")))
+#else
+ #define PITCH_DETECTION_INTERCEPT_LIBC 0
+ #define PITCH_DETECTION_CHECKER_TLS
+#endif
+
+#if PITCH_DETECTION_INTERCEPT_LIBC
+// glibc's allocator under its internal names, so the replacements below can
+// reach it without calling themselves
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+}
+#endif
+
+namespace
+{
+    using namespace RealtimeSafetyChecker;
+    
+    struct ViolationRecord
+    {
+        ViolationType type = Allocation;
+        int numFrames = 0;
+        void* frames[MAX_STACK_FRAMES] {};
+        std::atomic<bool> isComplete { false };
+    };
+    
+    thread_local int audioThreadDepth PITCH_DETECTION_CHECKER_TLS = 0;   // ScopedAudioThreads alive on this thread
+    thread_local bool isRecording PITCH_DETECTION_CHECKER_TLS = false;   // Capturing a stack, which may allocate itself
+    
+    std::atomic<int> violationCounts[NUM_VIOLATION_TYPES] {};
+    std::atomic<int> numRecordsClaimed { 0 };
+    ViolationRecord records[MAX_RECORDED_VIOLATIONS];
+    
+    int captureStack(void** frames)
+    {
+       #if JUCE_WINDOWS
+        return static_cast<int>(CaptureStackBackTrace(0, MAX_STACK_FRAMES, frames, nullptr));
+       #else
+        return backtrace(frames, MAX_STACK_FRAMES);
+       #endif
+    }
+    
+    // The first backtrace() loads the unwinder, which allocates, so that
+    // happens at startup rather than in the first violation
+    struct StackCapturePrimer
+    {
+        StackCapturePrimer()
+        {
+            void* frames[MAX_STACK_FRAMES];
+            captureStack(frames);
+        }
+    } stackCapturePrimer;
+    
+    // Count a violation if the calling thread is marked, and keep its stack
+    // while there's room. Lock-free and allocation-free, so it can run inside
+    // the allocator.
+    void recordViolation(ViolationType type)
+    {
+        if (audioThreadDepth == 0 || isRecording)
+            return;
+        
+        isRecording = true;
+        violationCounts[type].fetch_add(1, std::memory_order_relaxed);
+        
+        const int index = numRecordsClaimed.fetch_add(1, std::memory_order_relaxed);
+        if (index < MAX_RECORDED_VIOLATIONS)
+        {
+            ViolationRecord& record = records[index];
+            record.type = type;
+            record.numFrames = captureStack(record.frames);
+            record.isComplete.store(true, std::memory_order_release);
+        }
+        
+        isRecording = false;
+    }
+    
+    // The allocator underneath the interception
+    void* allocateUnchecked(size_t size)
+    {
+       #if PITCH_DETECTION_INTERCEPT_LIBC
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+    
+    void freeUnchecked(void* pointer)
+    {
+       #if PITCH_DETECTION_INTERCEPT_LIBC
+        __libc_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+    
+    void* allocateAlignedUnchecked(size_t size, size_t alignment)
+    {
+       #if PITCH_DETECTION_INTERCEPT_LIBC
+        return __libc_memalign(alignment, size);
+       #elif JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+       #endif
+    }
+    
+    void freeAlignedUnchecked(void* pointer)
+    {
+       #if JUCE_WINDOWS && !PITCH_DETECTION_INTERCEPT_LIBC
+        _aligned_free(pointer);
+       #else
+        freeUnchecked(pointer);
+       #endif
+    }
+    
+    void* checkedNew(size_t size)
+    {
+        recordViolation(Allocation);
+        
+        if (void* pointer = allocateUnchecked(size == 0 ? 1 : size))
+            return pointer;
+        
+        throw std::bad_alloc();
+    }
+    
+    void* checkedAlignedNew(size_t size, std::align_val_t alignment)
+    {
+        recordViolation(Allocation);
+        
+        if (void* pointer = allocateAlignedUnchecked(size == 0 ? 1 : size, static_cast<size_t>(alignment)))
+            return pointer;
+        
+        throw std::bad_alloc();
+    }
+    
+    void checkedDelete(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+        
+        recordViolation(Deallocation);
+        freeUnchecked(pointer);
+    }
+    
+    void checkedAlignedDelete(void* pointer)
+    {
+        if (pointer == nullptr)
+            return;
+        
+        recordViolation(Deallocation);
+        freeAlignedUnchecked(pointer);
+    }
+    
+    const char* getViolationName(ViolationType type)
+    {
+        switch (type)
+        {
+            case Allocation:    return "allocation";
+            case Deallocation:  return "deallocation";
+            case MutexLock:     return "mutex lock";
+            default:            return "violation";
+        }
+    }
+}
+
+//==============================================================================
+// Replacements of the global allocation functions for the whole binary
+void* operator new(size_t size)                                        { return checkedNew(size); }
+void* operator new[](size_t size)                                      { return checkedNew(size); }
+void* operator new(size_t size, std::align_val_t alignment)            { return checkedAlignedNew(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment)          { return checkedAlignedNew(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    recordViolation(Allocation);
+    return allocateUnchecked(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    recordViolation(Allocation);
+    return allocateUnchecked(size == 0 ? 1 : size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    recordViolation(Allocation);
+    return allocateAlignedUnchecked(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    recordViolation(Allocation);
+    return allocateAlignedUnchecked(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept                                           { checkedDelete(pointer); }
+void operator delete[](void* pointer) noexcept                                         { checkedDelete(pointer); }
+void operator delete(void* pointer, size_t) noexcept                                   { checkedDelete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept                                 { checkedDelete(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept                    { checkedDelete(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept                  { checkedDelete(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept                         { checkedAlignedDelete(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept                       { checkedAlignedDelete(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept                 { checkedAlignedDelete(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept               { checkedAlignedDelete(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept  { checkedAlignedDelete(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { checkedAlignedDelete(pointer); }
+
+#if PITCH_DETECTION_INTERCEPT_LIBC
+//==============================================================================
+// C allocation and mutex locking (glibc only)
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        recordViolation(Allocation);
+        return __libc_malloc(size);
+    }
+    
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        recordViolation(Allocation);
+        return __libc_calloc(count, size);
+    }
+    
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        recordViolation(Allocation);
+        return __libc_realloc(pointer, size);
+    }
+    
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            recordViolation(Deallocation);
+        
+        __libc_free(pointer);
+    }
+    
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        // The real one is looked up on first use; a plain atomic rather than a
+        // function-local static, whose guard could itself lock a mutex
+        using MutexLockFunction = int (*)(pthread_mutex_t*);
+        static std::atomic<MutexLockFunction> realMutexLock { nullptr };
+        
+        MutexLockFunction lock = realMutexLock.load(std::memory_order_acquire);
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realMutexLock.store(lock, std::memory_order_release);
+        }
+        
+        recordViolation(MutexLock);
+        return lock(mutex);
+    }
+}
+#endif
+
+//==============================================================================
+namespace RealtimeSafetyChecker
+{
+    ScopedAudioThread::ScopedAudioThread()
+    {
+        ++audioThreadDepth;
+    }
+    
+    ScopedAudioThread::~ScopedAudioThread()
+    {
+        --audioThreadDepth;
+    }
+    
+    int getNumViolations(ViolationType type)
+    {
+        return violationCounts[type].load(std::memory_order_relaxed);
+    }
+    
+    int getNumViolations()
+    {
+        int total = 0;
+        for (int type = 0; type < NUM_VIOLATION_TYPES; ++type)
+            total += getNumViolations(static_cast<ViolationType>(type));
+        return total;
+    }
+    
+    juce::String getReport()
+    {
+        juce::String report;
+        report << "Real-time safety violations on the audio thread: "
+               << getNumViolations(Allocation) << " allocations, "
+               << getNumViolations(Deallocation) << " deallocations, "
+               << getNumViolations(MutexLock) << " mutex locks" << "\n";
+        
+        const int numRecords = std::min(numRecordsClaimed.load(std::memory_order_relaxed), MAX_RECORDED_VIOLATIONS);
+        for (int i = 0; i < numRecords; ++i)
+        {
+            const ViolationRecord& record = records[i];
+            if (!record.isComplete.load(std::memory_order_acquire))
+                continue;
+            
+            report << "\n#" << (i + 1) << " " << getViolationName(record.type) << "\n";
+            
+            // Innermost first, starting with the checker's own frames
+           #if JUCE_WINDOWS
+            for (int frame = 0; frame < record.numFrames; ++frame)
+                report << "    0x" << juce::String::toHexString(reinterpret_cast<juce::pointer_sized_int>(record.frames[frame])) << "\n";
+           #else
+            if (char** symbols = backtrace_symbols(record.frames, record.numFrames))
+            {
+                for (int frame = 0; frame < record.numFrames; ++frame)
+                    report << "    " << symbols[frame] << "\n";
+                std::free(symbols);
+            }
+           #endif
+        }
+        
+        return report;
+    }
+    
+    void reset()
+    {
+        for (auto& count : violationCounts)
+            count.store(0, std::memory_order_relaxed);
+        
+        for (auto& record : records)
+            record.isComplete.store(false, std::memory_order_relaxed);
+        numRecordsClaimed.store(0, std::memory_order_relaxed);
+    }
+}
+
+#endif
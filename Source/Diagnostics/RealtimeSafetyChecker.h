@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#ifndef PITCH_DETECTION_REALTIME_CHECKS
+ #define PITCH_DETECTION_REALTIME_CHECKS 0
+#endif
+
+// Debug aid that catches real-time-safety violations on the audio thread.
+//
+// Built with PITCH_DETECTION_REALTIME_CHECKS=1 (the CMake option of the same
+// name), the plugin replaces operator new/delete and, on glibc, malloc,
+// calloc, realloc, free and pthread_mutex_lock. While a ScopedAudioThread is
+// alive on a thread, every call of those on it is counted and, for the first
+// MAX_RECORDED_VIOLATIONS, its call stack is kept in preallocated memory.
+// getReport() symbolises them later, off the audio thread.
+//
+// Without the option everything here is an empty inline function, so the
+// markers can stay in processBlock.
+namespace RealtimeSafetyChecker
+{
+    enum ViolationType
+    {
+        Allocation,
+        Deallocation,
+        MutexLock,
+        NUM_VIOLATION_TYPES
+    };
+    
+    constexpr int MAX_RECORDED_VIOLATIONS = 32;
+    constexpr int MAX_STACK_FRAMES = 24;
+   
+   #if PITCH_DETECTION_REALTIME_CHECKS
+    // Marks the calling thread as the audio thread for the object's lifetime
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+    
+    constexpr bool isEnabled() { return true; }
+    
+    // Violations counted since the last reset (any thread)
+    int getNumViolations(ViolationType type);
+    int getNumViolations();
+    
+    // Counts and recorded call stacks as text (allocates; not on the audio thread)
+    juce::String getReport();
+    
+    // Forget everything counted so far (while no audio thread is marked)
+    void reset();
+   #else
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread() {}
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+    
+    constexpr bool isEnabled() { return false; }
+    inline int getNumViolations(ViolationType) { return 0; }
+    inline int getNumViolations() { return 0; }
+    inline juce::String getReport() { return {}; }
+    inline void reset() {}
+   #endif
+}
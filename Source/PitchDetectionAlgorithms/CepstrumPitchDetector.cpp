@@ -0,0 +1,71 @@
+#include "CepstrumPitchDetector.h"
+#include <cmath>
+#include <algorithm>
+
+float CepstrumPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
+{
+    return detectPitchInFrame(AudioFrameView(buffer));
+}
+
+float CepstrumPitchDetector::detectPitchInFrame(const AudioFrameView& input)
+{
+    SpectralFrameCache* frame = analyseFrame(input);
+    
+    if (frame == nullptr)
+        return 0.0f;
+    
+    confidence = 0.0f;
+    
+    // Step 1: Quefrencies of the frequency range, one extra on each side for
+    // interpolation
+    const float* cepstrum = frame->getCepstrum();
+    int minLag = std::max(2, static_cast<int>(std::floor(sampleRate / maxFrequency)));
+    int maxLag = std::min(frame->getNumLags() - 2, static_cast<int>(std::ceil(sampleRate / minFrequency)));
+    
+    if (minLag >= maxLag)
+        return 0.0f;
+    
+    // Step 2: Highest cepstral peak in the range
+    int peakLag = minLag;
+    double sumOfSquares = 0.0;
+    
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        sumOfSquares += static_cast<double>(cepstrum[lag]) * cepstrum[lag];
+        
+        if (cepstrum[lag] > cepstrum[peakLag])
+            peakLag = lag;
+    }
+    
+    // Step 3: A flat cepstrum has no harmonic structure to find
+    float rms = static_cast<float>(std::sqrt(sumOfSquares / (maxLag - minLag + 1)));
+    float peak = cepstrum[peakLag];
+    
+    if (peak <= 0.0f || peak < MIN_PEAK_TO_RMS * rms)
+        return 0.0f;
+    
+    // Step 4: Refine and convert to frequency
+    float frequency = static_cast<float>(sampleRate) / parabolicInterpolation(cepstrum, peakLag);
+    
+    if (frequency < minFrequency || frequency > maxFrequency)
+        return 0.0f;
+    
+    // Step 5: Confidence grows with how far the peak stands out
+    confidence = juce::jlimit(0.0f, 1.0f, 1.0f - MIN_PEAK_TO_RMS * rms / (2.0f * peak));
+    
+    return frequency;
+}
+
+float CepstrumPitchDetector::parabolicInterpolation(const float* cepstrum, int index) const
+{
+    float alpha = cepstrum[index - 1];
+    float beta = cepstrum[index];
+    float gamma = cepstrum[index + 1];
+    
+    if (alpha - 2.0f * beta + gamma == 0.0f)
+        return static_cast<float>(index);
+    
+    float peak = 0.5f * (alpha - gamma) / (alpha - 2.0f * beta + gamma);
+    
+    return static_cast<float>(index) + peak;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "SpectralPitchDetector.h"
+
+// Cepstral pitch detection: the harmonics of a periodic signal ripple the
+// log spectrum with a spacing of f0, which the inverse FFT turns into a peak
+// at the quefrency of the period. Shares the window and forward FFT with the
+// other spectral detectors and adds one inverse FFT of its own.
+class CepstrumPitchDetector : public SpectralPitchDetector
+{
+public:
+    CepstrumPitchDetector() = default;
+    ~CepstrumPitchDetector() override = default;
+    
+    float detectPitch(const juce::AudioBuffer<float>& buffer) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
+    juce::String getName() const override { return "Cepstrum"; }
+    float getConfidence() const override { return confidence; }
+
+private:
+    float confidence = 0.0f;
+    
+    // Peaks less than this many times the cepstrum's RMS over the search
+    // range are taken as unvoiced
+    static constexpr float MIN_PEAK_TO_RMS = 4.0f;
+    
+    float parabolicInterpolation(const float* cepstrum, int index) const;
+};
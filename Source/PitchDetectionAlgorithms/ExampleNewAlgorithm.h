@@ -15,14 +15,21 @@ public:
     float detectPitch(const juce::AudioBuffer<float>& buffer) override;
     juce::String getName() const override { return "Example Algorithm"; }
     float getConfidence() const override;
+    
+    // The plugin's audio thread calls this with frames that may wrap around
+    // its circular buffer. Copy the view into `buffer` with frame.copyTo()
+    // (or read its spans directly) rather than relying on PitchDetector's
+    // default, which allocates a scratch buffer the first time a frame wraps.
+    // detectPitch can then forward an AudioFrameView of its AudioBuffer here,
+    // as MPMPitchDetector does.
+    float detectPitchInFrame(const AudioFrameView& frame) override;
 
 private:
-    std::vector<float> buffer;
+    std::vector<float> buffer;  // bufferSize samples, sized in prepare()
     float confidence = 1.0f;
     
-    // Algorithm-specific parameters - Updated for full bass guitar range
-    static constexpr float MIN_FREQUENCY = 30.0f;   // Hz (B0 on 5-string bass)
-    static constexpr float MAX_FREQUENCY = 400.0f;  // Hz (bass guitar range)
+    // The search range is minFrequency/maxFrequency from PitchDetector, so
+    // the multi-resolution wrapper can narrow it per window
     
     // Example algorithm methods
     float calculatePitch(const float* samples, int numSamples);
@@ -32,25 +39,18 @@ private:
 /*
 To integrate this new algorithm:
 
-1. Add the header include to PluginProcessor.h:
-   #include "PitchDetectionAlgorithms/ExampleNewAlgorithm.h"
-
-2. Add member variable to PluginProcessor class:
-   std::unique_ptr<ExampleNewAlgorithm> exampleDetector;
-
-3. Initialize in constructor:
-   exampleDetector = std::make_unique<ExampleNewAlgorithm>();
+1. Add the header include to PitchDetectorFactory.cpp:
+   #include "ExampleNewAlgorithm.h"
 
-4. Add to setPitchDetectionAlgorithm() method:
-   case 2: // Example Algorithm
-       currentPitchDetector = std::make_unique<ExampleNewAlgorithm>();
-       break;
+2. Register it in PitchDetectorFactory::createAll():
+   detectors.push_back(std::make_unique<ExampleNewAlgorithm>());
 
-5. Update getAlgorithmNames():
-   return {"YIN", "FFT", "Example Algorithm"};
+3. Add the .cpp file to target_sources in CMakeLists.txt.
 
-6. Prepare in prepareToPlay():
-   if (exampleDetector) exampleDetector->prepare(sampleRate, ANALYSIS_BUFFER_SIZE);
+That's it - prepareToPlay() prepares every registered detector, the UI lists
+them by getName() and the command-line tools pick them up too. Switching
+between detectors never allocates, provided prepare() sizes every buffer and
+detectPitchInFrame() reads the frame without allocating, as above.
 
 This modular design makes it easy to add new algorithms without modifying existing code!
-*/ 
\ No newline at end of file
+*/
\ No newline at end of file
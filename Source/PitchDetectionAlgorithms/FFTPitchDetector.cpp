@@ -2,69 +2,29 @@
 #include <cmath>
 #include <algorithm>
 
-// Define M_PI if not already defined (Windows doesn't define it by default)
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 FFTPitchDetector::FFTPitchDetector()
 {
 }
 
-void FFTPitchDetector::prepare(double newSampleRate, int newBufferSize)
+float FFTPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
 {
-    this->sampleRate = newSampleRate;
-    this->bufferSize = newBufferSize;
-    
-    // Use power of 2 FFT size for efficiency
-    fftSize = 1;
-    while (fftSize < bufferSize)
-        fftSize <<= 1;
-    
-    // Resize buffers
-    fftBuffer.resize(fftSize * 2); // Complex FFT buffer
-    magnitudeSpectrum.resize(fftSize / 2);
-    windowBuffer.resize(fftSize);
-    
-    // Create Hann window
-    for (int i = 0; i < fftSize; ++i)
-    {
-        windowBuffer[i] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * i / (fftSize - 1));
-    }
-    
-    // Clear buffers
-    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
-    std::fill(magnitudeSpectrum.begin(), magnitudeSpectrum.end(), 0.0f);
+    return detectPitchInFrame(AudioFrameView(buffer));
 }
 
-float FFTPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
+float FFTPitchDetector::detectPitchInFrame(const AudioFrameView& input)
 {
-    if (buffer.getNumSamples() != bufferSize)
-        return 0.0f;
-    
-    const float* inputBuffer = buffer.getReadPointer(0);
+    SpectralFrameCache* frame = analyseFrame(input);
     
-    // Copy input to FFT buffer and apply window
-    for (int i = 0; i < fftSize; ++i)
-    {
-        float sample = (i < bufferSize) ? inputBuffer[i] : 0.0f;
-        fftBuffer[i * 2] = sample * windowBuffer[i];     // Real part
-        fftBuffer[i * 2 + 1] = 0.0f;                    // Imaginary part
-    }
-    
-    // Simple FFT implementation (avoiding JUCE's FFT for threading issues)
-    performFFT(fftBuffer.data(), fftSize);
+    if (frame == nullptr)
+        return 0.0f;
     
-    // Calculate magnitude spectrum
-    for (int i = 0; i < fftSize / 2; ++i)
-    {
-        float real = fftBuffer[i * 2];
-        float imag = fftBuffer[i * 2 + 1];
-        magnitudeSpectrum[i] = std::sqrt(real * real + imag * imag);
-    }
+    // Windowed magnitude spectrum, computed once per frame for every
+    // spectral detector sharing the cache
+    const float* magnitudeSpectrum = frame->getMagnitudeSpectrum();
+    const int numBins = frame->getNumBins();
     
     // Find peak frequency in bass guitar range
-    int peakBin = findPeakFrequency();
+    int peakBin = findPeakFrequency(*frame, magnitudeSpectrum);
     
     if (peakBin == -1)
     {
@@ -73,13 +33,13 @@ float FFTPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
     }
     
     // Parabolic interpolation for better precision
-    float interpolatedBin = parabolicInterpolation(peakBin);
+    float interpolatedBin = parabolicInterpolation(magnitudeSpectrum, numBins, peakBin);
     
     // Convert to frequency
-    float frequency = binToFrequency(interpolatedBin);
+    float frequency = frame->binToFrequency(interpolatedBin);
     
     // Check if frequency is in valid range
-    if (frequency < MIN_FREQUENCY || frequency > MAX_FREQUENCY)
+    if (frequency < minFrequency || frequency > maxFrequency)
     {
         confidence = 0.0f;
         return 0.0f;
@@ -87,78 +47,20 @@ float FFTPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
     
     // Calculate confidence based on peak magnitude
     float peakMagnitude = magnitudeSpectrum[peakBin];
-    float maxMagnitude = *std::max_element(magnitudeSpectrum.begin(), magnitudeSpectrum.end());
+    float maxMagnitude = *std::max_element(magnitudeSpectrum, magnitudeSpectrum + numBins);
     confidence = (maxMagnitude > 0.0f) ? peakMagnitude / maxMagnitude : 0.0f;
     
     return frequency;
 }
 
-void FFTPitchDetector::performFFT(float* buffer, int size)
-{
-    // Simple FFT implementation using Cooley-Tukey algorithm
-    // This avoids any threading issues with JUCE's FFT
-    
-    // Bit-reversal permutation
-    int j = 0;
-    for (int i = 0; i < size - 1; ++i)
-    {
-        if (i < j)
-        {
-            std::swap(buffer[i * 2], buffer[j * 2]);
-            std::swap(buffer[i * 2 + 1], buffer[j * 2 + 1]);
-        }
-        
-        int k = size >> 1;
-        while (k <= j)
-        {
-            j -= k;
-            k >>= 1;
-        }
-        j += k;
-    }
-    
-    // FFT computation
-    for (int step = 1; step < size; step <<= 1)
-    {
-        float omega = -static_cast<float>(M_PI) / step;
-        
-        for (int group = 0; group < size; group += step << 1)
-        {
-            for (int pair = group; pair < group + step; ++pair)
-            {
-                int match = pair + step;
-                float cos_val = std::cos(omega * (pair - group));
-                float sin_val = std::sin(omega * (pair - group));
-                
-                float real_temp = buffer[match * 2] * cos_val - buffer[match * 2 + 1] * sin_val;
-                float imag_temp = buffer[match * 2] * sin_val + buffer[match * 2 + 1] * cos_val;
-                
-                buffer[match * 2] = buffer[pair * 2] - real_temp;
-                buffer[match * 2 + 1] = buffer[pair * 2 + 1] - imag_temp;
-                
-                buffer[pair * 2] += real_temp;
-                buffer[pair * 2 + 1] += imag_temp;
-            }
-        }
-    }
-}
-
-void FFTPitchDetector::applyWindow(float* buffer, int size)
-{
-    for (int i = 0; i < size; ++i)
-    {
-        buffer[i] *= windowBuffer[i];
-    }
-}
-
-int FFTPitchDetector::findPeakFrequency() const
+int FFTPitchDetector::findPeakFrequency(const SpectralFrameCache& frame, const float* magnitudeSpectrum) const
 {
-    int minBin = static_cast<int>(frequencyToBin(MAX_FREQUENCY));
-    int maxBin = static_cast<int>(frequencyToBin(MIN_FREQUENCY));
+    int minBin = static_cast<int>(std::floor(frame.frequencyToBin(minFrequency)));
+    int maxBin = static_cast<int>(std::ceil(frame.frequencyToBin(maxFrequency)));
     
     // Ensure bounds
     minBin = std::max(1, minBin);
-    maxBin = std::min(static_cast<int>(magnitudeSpectrum.size()) - 2, maxBin);
+    maxBin = std::min(frame.getNumBins() - 2, maxBin);
     
     if (minBin >= maxBin)
         return -1;
@@ -181,9 +83,9 @@ int FFTPitchDetector::findPeakFrequency() const
     return peakBin;
 }
 
-float FFTPitchDetector::parabolicInterpolation(int index) const
+float FFTPitchDetector::parabolicInterpolation(const float* magnitudeSpectrum, int numBins, int index) const
 {
-    if (index <= 0 || index >= static_cast<int>(magnitudeSpectrum.size()) - 1)
+    if (index <= 0 || index >= numBins - 1)
         return static_cast<float>(index);
     
     float alpha = magnitudeSpectrum[index - 1];
@@ -198,17 +100,7 @@ float FFTPitchDetector::parabolicInterpolation(int index) const
     return static_cast<float>(index) + peak;
 }
 
-float FFTPitchDetector::frequencyToBin(float frequency) const
-{
-    return static_cast<float>(frequency * fftSize / sampleRate);
-}
-
-float FFTPitchDetector::binToFrequency(float bin) const
-{
-    return static_cast<float>(bin * sampleRate / fftSize);
-}
-
 float FFTPitchDetector::getConfidence() const
 {
     return confidence;
-} 
\ No newline at end of file
+}
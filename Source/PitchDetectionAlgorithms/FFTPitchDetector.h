@@ -1,36 +1,34 @@
 #pragma once
 
-#include "PitchDetector.h"
-#include <vector>
+#include "SpectralPitchDetector.h"
 
-class FFTPitchDetector : public PitchDetector
+// Picks the strongest spectral peak in the frequency range from the shared
+// magnitude spectrum
+class FFTPitchDetector : public SpectralPitchDetector
 {
 public:
     FFTPitchDetector();
     ~FFTPitchDetector() override = default;
     
-    void prepare(double sampleRate, int bufferSize) override;
     float detectPitch(const juce::AudioBuffer<float>& buffer) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
     juce::String getName() const override { return "FFT"; }
     float getConfidence() const override;
+    
+    // The peak search needs no autocorrelation, so on its own cache the
+    // frame is only padded to the next power of two (half the FFT of the
+    // other spectral detectors)
+    int getPaddingFactor() const override { return 1; }
 
 private:
-    std::vector<float> fftBuffer;
-    std::vector<float> magnitudeSpectrum;
-    std::vector<float> windowBuffer;
-    
     float confidence = 1.0f;
-    int fftSize = 2048;
     
-    // FFT algorithm parameters - Updated for full bass guitar range
-    static constexpr float MIN_FREQUENCY = 30.0f;   // Hz (B0 on 5-string bass)
-    static constexpr float MAX_FREQUENCY = 400.0f;  // Hz (bass guitar range)
+    // FFT algorithm parameters (the frequency range lives in PitchDetector)
     static constexpr float MIN_MAGNITUDE_THRESHOLD = 0.01f;
     
-    void performFFT(float* buffer, int size);
-    void applyWindow(float* buffer, int size);
-    int findPeakFrequency() const;
-    float parabolicInterpolation(int index) const;
-    float frequencyToBin(float frequency) const;
-    float binToFrequency(float bin) const;
-}; 
\ No newline at end of file
+    // Stage-level timing in the benchmark tool
+    friend class DetectorStageBenchmarks;
+    
+    int findPeakFrequency(const SpectralFrameCache& frame, const float* magnitudeSpectrum) const;
+    float parabolicInterpolation(const float* magnitudeSpectrum, int numBins, int index) const;
+};
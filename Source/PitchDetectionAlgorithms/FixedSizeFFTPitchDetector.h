@@ -0,0 +1,173 @@
+#pragma once
+
+#include "PitchDetector.h"
+#include "../DSP/FixedSizeFFT.h"
+#include "../DSP/SimdKernels.h"
+#include "../Utilities/ConstexprMath.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+// FFTPitchDetector specialised at compile time for frames of FrameSize
+// samples.
+//
+// Gives the same pitches as FFTPitchDetector (to rounding): the frame is
+// Hann-windowed, zero-padded to the next power of two and the strongest peak
+// in the frequency range is interpolated. The window is a constexpr
+// table, the FFT a FixedSizeFFT and the working storage std::array inside
+// the detector; float frames still go through the SimdKernels. It computes
+// its own spectrum rather than sharing a SpectralFrameCache. prepare() must
+// be given FrameSize; frames of any other size find no pitch.
+template <int FrameSize, typename Sample = float>
+class FixedSizeFFTPitchDetector : public PitchDetector
+{
+public:
+    static_assert(FrameSize >= 4, "Frames this short have no spectrum to search");
+    
+    FixedSizeFFTPitchDetector() { bufferSize = FrameSize; }
+    ~FixedSizeFFTPitchDetector() override = default;
+    
+    void prepare(double newSampleRate, int newBufferSize) override
+    {
+        jassert(newBufferSize == FrameSize);
+        this->sampleRate = newSampleRate;
+        this->bufferSize = newBufferSize;
+        
+        // Search range in bins, kept clear of both ends for the neighbour test
+        minBin = std::max(1, static_cast<int>(std::floor(minFrequency * FFT_SIZE / sampleRate)));
+        maxBin = std::min(FFT::NUM_BINS - 2, static_cast<int>(std::ceil(maxFrequency * FFT_SIZE / sampleRate)));
+    }
+    
+    float detectPitch(const juce::AudioBuffer<float>& buffer) override
+    {
+        return detectPitchInFrame(AudioFrameView(buffer));
+    }
+    
+    float detectPitchInFrame(const AudioFrameView& frame) override
+    {
+        if (frame.getNumSamples() != FrameSize || bufferSize != FrameSize || minBin >= maxBin)
+            return 0.0f;
+        
+        // Step 1: Window the frame into the zero-padded FFT input
+        if constexpr (IS_FLOAT)
+        {
+            frame.copyTo(windowedFrame.data());
+            kernels->multiply(windowedFrame.data(), WINDOW.data(), windowedFrame.data(), FrameSize);
+        }
+        else
+        {
+            for (int i = 0; i < FrameSize; ++i)
+                windowedFrame[static_cast<size_t>(i)] = static_cast<Sample>(frame[i]) * WINDOW[static_cast<size_t>(i)];
+        }
+        
+        // Step 2: Magnitude spectrum (the padding stays zero)
+        fft.performRealForward(windowedFrame.data(), spectrum.data());
+        
+        if constexpr (IS_FLOAT)
+        {
+            kernels->complexMagnitude(spectrum.data(), magnitudeSpectrum.data(), FFT::NUM_BINS);
+        }
+        else
+        {
+            for (int k = 0; k < FFT::NUM_BINS; ++k)
+            {
+                const Sample re = spectrum[static_cast<size_t>(k * 2)];
+                const Sample im = spectrum[static_cast<size_t>(k * 2 + 1)];
+                magnitudeSpectrum[static_cast<size_t>(k)] = std::sqrt(re * re + im * im);
+            }
+        }
+        
+        // Step 3: Strongest local maximum in the frequency range
+        int peakBin = -1;
+        auto peakMagnitude = static_cast<Sample>(MIN_MAGNITUDE_THRESHOLD);
+        
+        for (int i = minBin; i <= maxBin; ++i)
+        {
+            const Sample magnitude = magnitudeSpectrum[static_cast<size_t>(i)];
+            if (magnitude > peakMagnitude
+                && magnitude > magnitudeSpectrum[static_cast<size_t>(i - 1)]
+                && magnitude > magnitudeSpectrum[static_cast<size_t>(i + 1)])
+            {
+                peakBin = i;
+                peakMagnitude = magnitude;
+            }
+        }
+        
+        if (peakBin == -1)
+        {
+            confidence = 0.0f;
+            return 0.0f;
+        }
+        
+        // Step 4: Parabolic interpolation, then frequency
+        const auto alpha = static_cast<float>(magnitudeSpectrum[static_cast<size_t>(peakBin - 1)]);
+        const auto beta = static_cast<float>(peakMagnitude);
+        const auto gamma = static_cast<float>(magnitudeSpectrum[static_cast<size_t>(peakBin + 1)]);
+        
+        float interpolatedBin = static_cast<float>(peakBin);
+        if (alpha - 2.0f * beta + gamma != 0.0f)
+            interpolatedBin += 0.5f * (alpha - gamma) / (alpha - 2.0f * beta + gamma);
+        
+        const float frequency = static_cast<float>(interpolatedBin * sampleRate / FFT_SIZE);
+        
+        if (frequency < minFrequency || frequency > maxFrequency)
+        {
+            confidence = 0.0f;
+            return 0.0f;
+        }
+        
+        // Step 5: Confidence from the peak against the largest bin
+        const Sample maxMagnitude = *std::max_element(magnitudeSpectrum.begin(), magnitudeSpectrum.end());
+        confidence = maxMagnitude > Sample(0) ? static_cast<float>(peakMagnitude / maxMagnitude) : 0.0f;
+        
+        return frequency;
+    }
+    
+    juce::String getName() const override { return "FFT"; }
+    float getConfidence() const override { return confidence; }
+    
+    static constexpr int FRAME_SIZE = FrameSize;
+
+private:
+    // float frames use the same SIMD kernels as the dynamic detectors
+    static constexpr bool IS_FLOAT = std::is_same_v<Sample, float>;
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    
+    // Padding to the next power of two, as FFTPitchDetector asks of its
+    // SpectralFrameCache
+    static constexpr int getFFTSize()
+    {
+        int size = 8;
+        while (size < FrameSize)
+            size <<= 1;
+        return size;
+    }
+    
+    using FFT = FixedSizeFFT<getFFTSize(), Sample>;
+    static constexpr int FFT_SIZE = getFFTSize();
+    
+    // Hann window over the frame itself, not the padded length
+    static constexpr std::array<Sample, FrameSize> makeWindow()
+    {
+        std::array<Sample, FrameSize> window {};
+        
+        for (int i = 0; i < FrameSize; ++i)
+            window[static_cast<size_t>(i)] = static_cast<Sample>(0.5 - 0.5 * ConstexprMath::cos(2.0 * ConstexprMath::PI * i / (FrameSize - 1)));
+        
+        return window;
+    }
+    
+    static constexpr std::array<Sample, FrameSize> WINDOW = makeWindow();
+    
+    FFT fft;
+    alignas(64) std::array<Sample, FFT_SIZE> windowedFrame {};
+    alignas(64) std::array<Sample, FFT::NUM_BINS * 2> spectrum {};
+    alignas(64) std::array<Sample, FFT::NUM_BINS> magnitudeSpectrum {};
+    
+    int minBin = 1;
+    int maxBin = 0;
+    float confidence = 1.0f;
+    
+    static constexpr float MIN_MAGNITUDE_THRESHOLD = 0.01f;
+};
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "PitchDetector.h"
+#include "../DSP/FixedSizeFFT.h"
+#include "../DSP/SimdKernels.h"
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+// YinPitchDetector's FFT difference function, specialised at compile time
+// for frames of FrameSize samples.
+//
+// Gives the same pitches as YinPitchDetector (to rounding), but all working
+// storage is std::array inside the detector, the FFT is a FixedSizeFFT and
+// every loop runs a constant number of times. prepare() must be given
+// FrameSize; frames of any other size find no pitch. PitchDetectorFactory
+// substitutes it for YinPitchDetector when the analysis frame size has a
+// specialisation.
+template <int FrameSize, typename Sample = float>
+class FixedSizeYinPitchDetector : public PitchDetector
+{
+public:
+    static_assert(FrameSize >= 8, "Frames this short can't hold a period");
+    
+    FixedSizeYinPitchDetector() { bufferSize = FrameSize; }
+    ~FixedSizeYinPitchDetector() override = default;
+    
+    void prepare(double newSampleRate, int newBufferSize) override
+    {
+        jassert(newBufferSize == FrameSize);
+        this->sampleRate = newSampleRate;
+        this->bufferSize = newBufferSize;
+    }
+    
+    float detectPitch(const juce::AudioBuffer<float>& buffer) override
+    {
+        return detectPitchInFrame(AudioFrameView(buffer));
+    }
+    
+    float detectPitchInFrame(const AudioFrameView& frame) override
+    {
+        if (frame.getNumSamples() != FrameSize || bufferSize != FrameSize)
+            return 0.0f;
+        
+        // Step 1: The frame goes straight into the zero-padded FFT input
+        if constexpr (IS_FLOAT)
+        {
+            frame.copyTo(fftBuffer.data());
+        }
+        else
+        {
+            for (int i = 0; i < FrameSize; ++i)
+                fftBuffer[static_cast<size_t>(i)] = static_cast<Sample>(frame[i]);
+        }
+        
+        computeDifferenceFunction();
+        return estimatePitchFromDifference();
+    }
+    
+    void detectPitchBatch(const float* frames, int numFrames, int frameStride,
+                          float* frequencies, float* confidences) override
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            frequencies[i] = detectPitchInFrame(AudioFrameView(frames + static_cast<size_t>(i) * static_cast<size_t>(frameStride), FrameSize));
+            confidences[i] = frequencies[i] > 0.0f ? confidence : 0.0f;
+        }
+    }
+    
+    juce::String getName() const override { return "YIN"; }
+    float getConfidence() const override { return confidence; }
+    
+    static constexpr int FRAME_SIZE = FrameSize;
+
+private:
+    static constexpr int HALF_FRAME_SIZE = FrameSize / 2;
+    
+    // The lags we need (< FrameSize / 2) never wrap around a circular
+    // correlation of this length, so no extra zero padding is required
+    static constexpr int getFFTSize()
+    {
+        int size = 8;
+        while (size < FrameSize)
+            size <<= 1;
+        return size;
+    }
+    
+    using FFT = FixedSizeFFT<getFFTSize(), Sample>;
+    static constexpr int FFT_SIZE = getFFTSize();
+    
+    FFT fft;
+    alignas(64) std::array<Sample, FFT_SIZE> fftBuffer {};
+    alignas(64) std::array<Sample, FFT::NUM_BINS * 2> frameSpectrum {};
+    alignas(64) std::array<Sample, FFT::NUM_BINS * 2> halfFrameSpectrum {};
+    std::array<double, FrameSize + 1> energyPrefixSum {};
+    alignas(64) std::array<Sample, HALF_FRAME_SIZE> differenceBuffer {};
+    alignas(64) std::array<Sample, HALF_FRAME_SIZE> cumulativeMeanNormalizedDifference {};
+    
+    // float frames use the same SIMD kernels as YinPitchDetector
+    static constexpr bool IS_FLOAT = std::is_same_v<Sample, float>;
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    
+    static constexpr float THRESHOLD = 0.15f;
+    float confidence = 1.0f;
+    
+    // d(t) = sum x[i]^2 + sum x[i+t]^2 - 2 * r(t), as in
+    // YinPitchDetector::computeDifferenceFunctionFFT, on the frame already in
+    // fftBuffer
+    void computeDifferenceFunction()
+    {
+        std::fill(fftBuffer.begin() + FrameSize, fftBuffer.end(), Sample(0));
+        
+        // Step 1: Running energy sums
+        energyPrefixSum[0] = 0.0;
+        for (int i = 0; i < FrameSize; ++i)
+        {
+            const auto sample = static_cast<double>(fftBuffer[static_cast<size_t>(i)]);
+            energyPrefixSum[static_cast<size_t>(i + 1)] = energyPrefixSum[static_cast<size_t>(i)] + sample * sample;
+        }
+        
+        // Step 2: Spectra of the whole frame and of its zero-padded first half
+        fft.performRealForward(fftBuffer.data(), frameSpectrum.data());
+        
+        std::fill(fftBuffer.begin() + HALF_FRAME_SIZE, fftBuffer.begin() + FrameSize, Sample(0));
+        fft.performRealForward(fftBuffer.data(), halfFrameSpectrum.data());
+        
+        // Step 3: Cross-spectrum conj(A) * X
+        if constexpr (IS_FLOAT)
+        {
+            kernels->complexMultiplyConjugate(halfFrameSpectrum.data(), frameSpectrum.data(), frameSpectrum.data(), FFT::NUM_BINS);
+        }
+        else
+        {
+            for (int k = 0; k < FFT::NUM_BINS; ++k)
+            {
+                const Sample ar = halfFrameSpectrum[static_cast<size_t>(k * 2)];
+                const Sample ai = halfFrameSpectrum[static_cast<size_t>(k * 2 + 1)];
+                const Sample br = frameSpectrum[static_cast<size_t>(k * 2)];
+                const Sample bi = frameSpectrum[static_cast<size_t>(k * 2 + 1)];
+                
+                frameSpectrum[static_cast<size_t>(k * 2)] = ar * br + ai * bi;
+                frameSpectrum[static_cast<size_t>(k * 2 + 1)] = ar * bi - ai * br;
+            }
+        }
+        
+        // Step 4: Inverse FFT gives the cross-correlation r(t)
+        fft.performRealInverse(frameSpectrum.data(), fftBuffer.data());
+        
+        // Step 5: Combine energy terms with the correlation
+        const double firstHalfEnergy = energyPrefixSum[HALF_FRAME_SIZE];
+        
+        for (int t = 0; t < HALF_FRAME_SIZE; ++t)
+        {
+            const double laggedEnergy = energyPrefixSum[static_cast<size_t>(t + HALF_FRAME_SIZE)] - energyPrefixSum[static_cast<size_t>(t)];
+            const auto correlation = static_cast<double>(fftBuffer[static_cast<size_t>(t)]);
+            
+            // Rounding can push near-zero values slightly negative
+            differenceBuffer[static_cast<size_t>(t)] = static_cast<Sample>(std::max(0.0, firstHalfEnergy + laggedEnergy - 2.0 * correlation));
+        }
+    }
+    
+    // Steps 2-7 of YinPitchDetector::detectPitch
+    float estimatePitchFromDifference()
+    {
+        // Step 1: Cumulative mean normalized difference, d[t] / (sum / (t + 1))
+        cumulativeMeanNormalizedDifference[0] = Sample(1);
+        Sample runningSum = differenceBuffer[0];
+        
+        for (int t = 1; t < HALF_FRAME_SIZE; ++t)
+        {
+            runningSum += differenceBuffer[static_cast<size_t>(t)];
+            cumulativeMeanNormalizedDifference[static_cast<size_t>(t)] = differenceBuffer[static_cast<size_t>(t)] * static_cast<Sample>(t + 1) / runningSum;
+        }
+        
+        // Step 2: First dip below the threshold, followed to its minimum
+        int minIndex = -1;
+        for (int i = 2; i < HALF_FRAME_SIZE; ++i) // Start from 2 to avoid DC
+        {
+            if (cumulativeMeanNormalizedDifference[static_cast<size_t>(i)] < THRESHOLD)
+            {
+                minIndex = i;
+                while (minIndex + 1 < HALF_FRAME_SIZE
+                       && cumulativeMeanNormalizedDifference[static_cast<size_t>(minIndex + 1)] < cumulativeMeanNormalizedDifference[static_cast<size_t>(minIndex)])
+                    ++minIndex;
+                break;
+            }
+        }
+        
+        if (minIndex == -1)
+        {
+            confidence = 0.0f;
+            return 0.0f;
+        }
+        
+        // Step 3: Parabolic interpolation, then frequency
+        float interpolatedIndex = static_cast<float>(minIndex);
+        if (minIndex < HALF_FRAME_SIZE - 1)
+        {
+            const auto alpha = static_cast<float>(cumulativeMeanNormalizedDifference[static_cast<size_t>(minIndex - 1)]);
+            const auto beta = static_cast<float>(cumulativeMeanNormalizedDifference[static_cast<size_t>(minIndex)]);
+            const auto gamma = static_cast<float>(cumulativeMeanNormalizedDifference[static_cast<size_t>(minIndex + 1)]);
+            interpolatedIndex += 0.5f * (alpha - gamma) / (alpha - 2.0f * beta + gamma);
+        }
+        
+        const float frequency = static_cast<float>(sampleRate) / interpolatedIndex;
+        
+        // Step 4: Bass range only, with confidence from the dip's depth
+        if (frequency < minFrequency || frequency > maxFrequency)
+        {
+            confidence = 0.0f;
+            return 0.0f;
+        }
+        
+        const auto minValue = static_cast<float>(cumulativeMeanNormalizedDifference[static_cast<size_t>(minIndex)]);
+        confidence = std::max(0.0f, 1.0f - minValue / THRESHOLD);
+        return frequency;
+    }
+};
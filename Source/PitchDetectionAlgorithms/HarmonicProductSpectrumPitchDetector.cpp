@@ -0,0 +1,116 @@
+#include "HarmonicProductSpectrumPitchDetector.h"
+#include <cmath>
+#include <algorithm>
+
+void HarmonicProductSpectrumPitchDetector::prepare(double newSampleRate, int newBufferSize)
+{
+    SpectralPitchDetector::prepare(newSampleRate, newBufferSize);
+    logProduct.assign(static_cast<size_t>(spectralFrame->getNumBins()), 0.0f);
+}
+
+float HarmonicProductSpectrumPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
+{
+    return detectPitchInFrame(AudioFrameView(buffer));
+}
+
+float HarmonicProductSpectrumPitchDetector::detectPitchInFrame(const AudioFrameView& input)
+{
+    SpectralFrameCache* frame = analyseFrame(input);
+    
+    if (frame == nullptr || static_cast<int>(logProduct.size()) != frame->getNumBins())
+        return 0.0f;
+    
+    confidence = 0.0f;
+    
+    const float* magnitude = frame->getMagnitudeSpectrum();
+    const int numBins = frame->getNumBins();
+    
+    // Step 1: Candidate bins, and as many harmonics as fit below Nyquist for
+    // all of them so every candidate is scored on the same terms
+    int minBin = std::max(1, static_cast<int>(std::floor(frame->frequencyToBin(minFrequency))));
+    int maxBin = std::min(numBins - 2, static_cast<int>(std::ceil(frame->frequencyToBin(maxFrequency))));
+    int numHarmonics = std::min(NUM_HARMONICS, (numBins - 1) / std::max(1, maxBin));
+    
+    if (minBin >= maxBin || numHarmonics < 2)
+        return 0.0f;
+    
+    float largest = *std::max_element(magnitude, magnitude + numBins);
+    
+    if (largest <= 0.0f)
+        return 0.0f;
+    
+    // Step 2: Log of the harmonic product per candidate, floored so one
+    // empty bin can't veto a note
+    const float floor = largest * LOG_FLOOR;
+    int peakBin = minBin;
+    
+    for (int k = minBin; k <= maxBin; ++k)
+    {
+        float sum = 0.0f;
+        for (int h = 1; h <= numHarmonics; ++h)
+            sum += std::log(std::max(magnitude[k * h], floor));
+        
+        logProduct[static_cast<size_t>(k)] = sum;
+        
+        if (sum > logProduct[static_cast<size_t>(peakBin)])
+            peakBin = k;
+    }
+    
+    // Step 3: The geometric mean of the harmonics relative to the largest
+    // bin is the voicing measure
+    float level = std::exp(logProduct[static_cast<size_t>(peakBin)] / numHarmonics) / largest;
+    
+    if (level < MIN_HARMONIC_LEVEL)
+        return 0.0f;
+    
+    // Step 4: The product's bin is coarse, so refine from the harmonic peaks
+    float frequency = refineFrequency(*frame, magnitude, peakBin, numHarmonics);
+    
+    if (frequency < minFrequency || frequency > maxFrequency)
+        return 0.0f;
+    
+    confidence = juce::jlimit(0.0f, 1.0f, level);
+    
+    return frequency;
+}
+
+float HarmonicProductSpectrumPitchDetector::refineFrequency(const SpectralFrameCache& frame, const float* magnitudeSpectrum,
+                                                            int fundamentalBin, int numHarmonics) const
+{
+    // Magnitude-weighted average of each harmonic's interpolated peak,
+    // divided by its harmonic number
+    const int numBins = frame.getNumBins();
+    double weightedSum = 0.0;
+    double totalWeight = 0.0;
+    
+    for (int h = 1; h <= numHarmonics; ++h)
+    {
+        // The h-th harmonic lies within h/2 bins of h times the fundamental's bin
+        int centre = fundamentalBin * h;
+        int reach = std::max(1, h / 2);
+        int peak = centre;
+        
+        for (int k = std::max(1, centre - reach); k <= std::min(numBins - 2, centre + reach); ++k)
+        {
+            if (magnitudeSpectrum[k] > magnitudeSpectrum[peak])
+                peak = k;
+        }
+        
+        if (peak <= 0 || peak >= numBins - 1)
+            continue;
+        
+        float alpha = magnitudeSpectrum[peak - 1];
+        float beta = magnitudeSpectrum[peak];
+        float gamma = magnitudeSpectrum[peak + 1];
+        float denominator = alpha - 2.0f * beta + gamma;
+        float offset = (denominator != 0.0f) ? 0.5f * (alpha - gamma) / denominator : 0.0f;
+        
+        weightedSum += beta * (peak + juce::jlimit(-0.5f, 0.5f, offset)) / h;
+        totalWeight += beta;
+    }
+    
+    if (totalWeight <= 0.0)
+        return frame.binToFrequency(static_cast<float>(fundamentalBin));
+    
+    return frame.binToFrequency(static_cast<float>(weightedSum / totalWeight));
+}
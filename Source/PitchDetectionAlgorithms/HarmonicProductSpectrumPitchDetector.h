@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SpectralPitchDetector.h"
+#include <vector>
+
+// Harmonic product spectrum: the magnitude spectrum multiplied by copies of
+// itself compressed by 2, 3, ... NUM_HARMONICS, so only a frequency whose
+// harmonics are all present stands out. Summed as logs to stay in range.
+// Uses the magnitude spectrum shared with the other spectral detectors, so
+// it adds no FFT of its own.
+class HarmonicProductSpectrumPitchDetector : public SpectralPitchDetector
+{
+public:
+    HarmonicProductSpectrumPitchDetector() = default;
+    ~HarmonicProductSpectrumPitchDetector() override = default;
+    
+    void prepare(double sampleRate, int bufferSize) override;
+    float detectPitch(const juce::AudioBuffer<float>& buffer) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
+    juce::String getName() const override { return "HPS"; }
+    float getConfidence() const override { return confidence; }
+
+private:
+    std::vector<float> logProduct;   // Per candidate bin, sum of log harmonic magnitudes
+    float confidence = 0.0f;
+    
+    static constexpr int NUM_HARMONICS = 5;
+    static constexpr float MIN_HARMONIC_LEVEL = 0.02f;   // Geometric mean vs the largest bin
+    static constexpr float LOG_FLOOR = 1.0e-6f;          // -120 dB below the largest bin
+    
+    float refineFrequency(const SpectralFrameCache& frame, const float* magnitudeSpectrum, int fundamentalBin,
+                          int numHarmonics) const;
+};
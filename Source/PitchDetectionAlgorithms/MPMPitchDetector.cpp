@@ -0,0 +1,210 @@
+#include "MPMPitchDetector.h"
+#include <cmath>
+#include <algorithm>
+
+MPMPitchDetector::MPMPitchDetector()
+{
+}
+
+void MPMPitchDetector::prepare(double newSampleRate, int newBufferSize)
+{
+    this->sampleRate = newSampleRate;
+    this->bufferSize = newBufferSize;
+    
+    // Only the newest PERIODS_PER_WINDOW periods of the lowest note are
+    // needed, which also keeps latency down when the frame is sized for YIN
+    windowSize = std::min(bufferSize, static_cast<int>(std::ceil(PERIODS_PER_WINDOW * sampleRate / minFrequency)));
+    
+    // Lags searched, with one extra on each side for interpolation
+    minLag = std::max(1, static_cast<int>(std::floor(sampleRate / maxFrequency)) - 1);
+    maxLag = std::min(windowSize - 2, static_cast<int>(std::ceil(sampleRate / minFrequency)) + 1);
+    
+    // Enough zero padding that the circular autocorrelation doesn't wrap
+    // into the lags we use
+    fftSize = 1;
+    while (fftSize < windowSize + maxLag + 2)
+        fftSize <<= 1;
+    
+    fftEngine.prepare(fftSize);
+    
+    // Resize buffers
+    centredWindow.resize(static_cast<size_t>(windowSize));
+    fftBuffer.resize(fftSize);
+    spectrumBuffer.resize(fftEngine.getNumBins() * 2);
+    nsdf.resize(static_cast<size_t>(std::max(0, maxLag + 2)));
+    keyMaxima.reserve(nsdf.size());
+    
+    // Clear buffers
+    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+    std::fill(nsdf.begin(), nsdf.end(), 0.0f);
+}
+
+float MPMPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
+{
+    return detectPitchInFrame(AudioFrameView(buffer));
+}
+
+float MPMPitchDetector::detectPitchInFrame(const AudioFrameView& frame)
+{
+    if (frame.getNumSamples() != bufferSize || maxLag <= minLag)
+        return 0.0f;
+    
+    // Step 1: NSDF of the newest windowSize samples
+    computeNormalizedSquareDifference(frame.getSubView(bufferSize - windowSize, windowSize));
+    
+    // Step 2: Key maximum picking
+    int peakIndex = findKeyMaximum();
+    
+    if (peakIndex == -1)
+    {
+        confidence = 0.0f;
+        return 0.0f;
+    }
+    
+    // Step 3: Parabolic interpolation for better precision
+    float interpolatedLag = parabolicInterpolation(peakIndex);
+    
+    // Step 4: Convert to frequency
+    float frequency = static_cast<float>(sampleRate) / interpolatedLag;
+    
+    // Step 5: Check if frequency is in valid range for bass guitar
+    if (frequency < minFrequency || frequency > maxFrequency)
+    {
+        confidence = 0.0f;
+        return 0.0f;
+    }
+    
+    // Step 6: The NSDF peak height is MPM's clarity measure
+    confidence = juce::jlimit(0.0f, 1.0f, nsdf[static_cast<size_t>(peakIndex)]);
+    
+    return frequency;
+}
+
+void MPMPitchDetector::computeNormalizedSquareDifference(const AudioFrameView& newestWindow)
+{
+    // Step 1a: Remove the mean, or a DC offset keeps n(t) positive at every
+    // lag and no lobe ever closes. The window is centred in its own copy, so
+    // the view is read just once.
+    newestWindow.copyTo(centredWindow.data());
+    
+    double sum = 0.0;
+    for (int i = 0; i < windowSize; ++i)
+        sum += centredWindow[static_cast<size_t>(i)];
+    
+    const float mean = static_cast<float>(sum / windowSize);
+    for (int i = 0; i < windowSize; ++i)
+        centredWindow[static_cast<size_t>(i)] -= mean;
+    
+    const float* window = centredWindow.data();
+    
+    // Step 1b: Autocorrelation r(t) as the inverse FFT of the power spectrum
+    std::copy(window, window + windowSize, fftBuffer.begin());
+    std::fill(fftBuffer.begin() + windowSize, fftBuffer.end(), 0.0f);
+    
+    fftEngine.performRealForward(fftBuffer.data(), spectrumBuffer.data());
+    
+    // conj(X) * X = |X|^2
+    kernels->complexMultiplyConjugate(spectrumBuffer.data(), spectrumBuffer.data(),
+                                      spectrumBuffer.data(), fftEngine.getNumBins());
+    
+    fftEngine.performRealInverse(spectrumBuffer.data(), fftBuffer.data());
+    
+    // Step 1c: m(t) starts at twice the window energy and loses one sample
+    // from each end per lag
+    double energyTerm = 2.0 * fftBuffer[0];
+    
+    for (int t = 0; t < static_cast<int>(nsdf.size()); ++t)
+    {
+        if (t > 0)
+        {
+            double leavingStart = window[t - 1];
+            double leavingEnd = window[windowSize - t];
+            energyTerm -= leavingStart * leavingStart + leavingEnd * leavingEnd;
+        }
+        
+        nsdf[static_cast<size_t>(t)] = energyTerm > 0.0 ? static_cast<float>(2.0 * fftBuffer[static_cast<size_t>(t)] / energyTerm) : 0.0f;
+    }
+}
+
+int MPMPitchDetector::findKeyMaximum()
+{
+    // Key maxima are the highest points of each positive lobe after the
+    // first negative-going zero crossing (which ends the lobe around lag 0)
+    keyMaxima.clear();
+    
+    int t = 1;
+    while (t < maxLag && nsdf[static_cast<size_t>(t)] > 0.0f)
+        ++t;
+    
+    t = std::max(t, minLag);
+    
+    int lobeMaximum = -1;
+    
+    for (; t <= maxLag; ++t)
+    {
+        float value = nsdf[static_cast<size_t>(t)];
+        
+        if (value > 0.0f)
+        {
+            if (lobeMaximum == -1 || value > nsdf[static_cast<size_t>(lobeMaximum)])
+                lobeMaximum = t;
+        }
+        else if (lobeMaximum != -1)
+        {
+            keyMaxima.push_back(lobeMaximum);
+            lobeMaximum = -1;
+        }
+    }
+    
+    // A lobe still open at the end of the search range counts too
+    if (lobeMaximum != -1)
+        keyMaxima.push_back(lobeMaximum);
+    
+    if (keyMaxima.empty())
+        return -1;
+    
+    // The first key maximum close to the highest one is the period; later
+    // ones are its multiples
+    float highest = 0.0f;
+    for (int index : keyMaxima)
+        highest = std::max(highest, nsdf[static_cast<size_t>(index)]);
+    
+    if (highest < MIN_CLARITY)
+        return -1;
+    
+    for (int index : keyMaxima)
+    {
+        if (nsdf[static_cast<size_t>(index)] >= KEY_MAXIMUM_THRESHOLD * highest)
+            return index;
+    }
+    
+    return -1;
+}
+
+float MPMPitchDetector::parabolicInterpolation(int index) const
+{
+    if (index <= 0 || index >= static_cast<int>(nsdf.size()) - 1)
+        return static_cast<float>(index);
+    
+    float alpha = nsdf[static_cast<size_t>(index - 1)];
+    float beta = nsdf[static_cast<size_t>(index)];
+    float gamma = nsdf[static_cast<size_t>(index + 1)];
+    
+    if (alpha - 2.0f * beta + gamma == 0.0f)
+        return static_cast<float>(index);
+    
+    float peak = 0.5f * (alpha - gamma) / (alpha - 2.0f * beta + gamma);
+    
+    return static_cast<float>(index) + peak;
+}
+
+void MPMPitchDetector::setKernelTable(const SimdKernelTable& table)
+{
+    kernels = &table;
+    fftEngine.setKernelTable(table);
+}
+
+float MPMPitchDetector::getConfidence() const
+{
+    return confidence;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "PitchDetector.h"
+#include "../DSP/FFTEngine.h"
+#include "../DSP/SimdKernels.h"
+#include <vector>
+
+// McLeod Pitch Method: picks the period from the normalised square
+// difference function (NSDF)
+//
+//     n(t) = 2 r(t) / m(t),  r(t) = sum x[j] x[j + t],  m(t) = sum x[j]^2 + x[j + t]^2
+//
+// over the overlapping part of the window, after removing its mean. The
+// normalisation keeps n(t) in [-1, 1] whatever the lag, so unlike YIN's fixed
+// half-window integration the full window is usable and fewer periods are
+// needed. r(t) comes from one FFT round trip of the power spectrum, m(t) from
+// a running sum. The period is the first "key maximum" (highest point of each
+// positive lobe) within KEY_MAXIMUM_THRESHOLD of the highest one.
+class MPMPitchDetector : public PitchDetector
+{
+public:
+    MPMPitchDetector();
+    ~MPMPitchDetector() override = default;
+    
+    void prepare(double sampleRate, int bufferSize) override;
+    float detectPitch(const juce::AudioBuffer<float>& buffer) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
+    juce::String getName() const override { return "MPM"; }
+    float getConfidence() const override;
+    
+    // Override the CPU-selected SIMD kernels (e.g. to validate a specific variant)
+    void setKernelTable(const SimdKernelTable& table);
+
+private:
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    FFTEngine fftEngine;
+    std::vector<float> centredWindow;   // Analysed samples with the mean removed
+    std::vector<float> fftBuffer;       // Zero-padded window, then the autocorrelation
+    std::vector<float> spectrumBuffer;  // Interleaved complex bins
+    std::vector<float> nsdf;
+    std::vector<int> keyMaxima;
+    
+    int windowSize = 0;                 // Newest samples of the frame that are analysed
+    int fftSize = 0;
+    int minLag = 0;
+    int maxLag = 0;
+    float confidence = 0.0f;
+    
+    // MPM algorithm parameters
+    static constexpr double PERIODS_PER_WINDOW = 1.5;      // vs 2.2 for YIN
+    static constexpr float KEY_MAXIMUM_THRESHOLD = 0.9f;   // Of the highest key maximum
+    static constexpr float MIN_CLARITY = 0.5f;             // Weaker peaks are unvoiced
+    
+    void computeNormalizedSquareDifference(const AudioFrameView& newestWindow);
+    int findKeyMaximum();
+    float parabolicInterpolation(int index) const;
+};
@@ -0,0 +1,75 @@
+#include "MultiResolutionPitchDetector.h"
+
+MultiResolutionPitchDetector::MultiResolutionPitchDetector(DetectorCreator creator, const juce::String& detectorName)
+    : createDetector(std::move(creator)), name(detectorName)
+{
+}
+
+void MultiResolutionPitchDetector::prepare(double newSampleRate, int newBufferSize)
+{
+    this->sampleRate = newSampleRate;
+    this->bufferSize = newBufferSize;
+    
+    // Step 1: Octave-spaced floors, highest first. A tier is only worth
+    // having if its window is shorter than the next one's.
+    tiers.clear();
+    
+    for (int i = MAX_TIERS - 1; i >= 0; --i)
+    {
+        float floorFrequency = minFrequency * static_cast<float>(1 << i);
+        int frameSize = (i == 0) ? bufferSize : getFrameSizeForFrequency(sampleRate, floorFrequency);
+        
+        if (floorFrequency >= maxFrequency || (i > 0 && frameSize >= bufferSize))
+            continue;
+        
+        Tier tier;
+        tier.detector = createDetector();
+        tier.detector->setFrequencyRange(floorFrequency, maxFrequency);
+        tier.detector->prepare(sampleRate, frameSize);
+        tier.frameSize = frameSize;
+        tiers.push_back(std::move(tier));
+    }
+    
+    confidence = 0.0f;
+    lastTierIndex = -1;
+    startTierIndex = 0;
+}
+
+float MultiResolutionPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
+{
+    return detectPitchInFrame(AudioFrameView(buffer));
+}
+
+float MultiResolutionPitchDetector::detectPitchInFrame(const AudioFrameView& frame)
+{
+    if (frame.getNumSamples() != bufferSize)
+        return 0.0f;
+    
+    // Step 2: Shortest useful window first; a tier's detector only reports
+    // notes at or above its floor, so anything lower falls through to the next
+    for (size_t i = static_cast<size_t>(startTierIndex); i < tiers.size(); ++i)
+    {
+        Tier& tier = tiers[i];
+        float frequency = tier.detector->detectPitchInFrame(frame.getSubView(bufferSize - tier.frameSize, tier.frameSize));
+        
+        if (frequency > 0.0f)
+        {
+            confidence = tier.detector->getConfidence();
+            lastTierIndex = static_cast<int>(i);
+            
+            // Step 3: Next frame starts at the shortest tier whose floor is
+            // below this note
+            startTierIndex = lastTierIndex;
+            while (startTierIndex > 0 && tiers[static_cast<size_t>(startTierIndex - 1)].detector->getMinFrequency() <= frequency)
+                --startTierIndex;
+            
+            return frequency;
+        }
+    }
+    
+    // Unvoiced: the next note could be anywhere
+    confidence = 0.0f;
+    lastTierIndex = -1;
+    startTierIndex = 0;
+    return 0.0f;
+}
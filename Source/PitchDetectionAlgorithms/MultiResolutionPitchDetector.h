@@ -0,0 +1,53 @@
+#pragma once
+
+#include "PitchDetector.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Runs one detector type at several window lengths, shortest first.
+//
+// A window only has to hold a couple of periods of the lowest note it looks
+// for, so each tier covers an octave-spaced floor (4x, 2x and 1x the lowest
+// frequency) with a window sized for that floor, taken from the most recent
+// end of the frame. Higher notes are answered by a short window - less
+// latency and CPU - and only notes below a tier's floor fall through to the
+// longer windows, down to the full frame for B0. Notes are sustained, so
+// each frame starts at the shortest tier that can hold the previous pitch
+// rather than re-trying windows that are known to be too short.
+class MultiResolutionPitchDetector : public PitchDetector
+{
+public:
+    using DetectorCreator = std::function<std::unique_ptr<PitchDetector>()>;
+    
+    MultiResolutionPitchDetector(DetectorCreator createDetector, const juce::String& name);
+    ~MultiResolutionPitchDetector() override = default;
+    
+    // bufferSize is the longest window; shorter tiers use the end of it
+    void prepare(double sampleRate, int bufferSize) override;
+    float detectPitch(const juce::AudioBuffer<float>& buffer) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
+    juce::String getName() const override { return name; }
+    float getConfidence() const override { return confidence; }
+    
+    // Tier that answered the last frame (0 = shortest window), -1 if unvoiced
+    int getLastTierIndex() const { return lastTierIndex; }
+    int getNumTiers() const { return static_cast<int>(tiers.size()); }
+    int getTierFrameSize(int tierIndex) const { return tiers[static_cast<size_t>(tierIndex)].frameSize; }
+
+private:
+    struct Tier
+    {
+        std::unique_ptr<PitchDetector> detector;
+        int frameSize = 0;  // Read from the end of each frame in place
+    };
+    
+    DetectorCreator createDetector;
+    juce::String name;
+    std::vector<Tier> tiers;    // Shortest window first
+    float confidence = 0.0f;
+    int lastTierIndex = -1;
+    int startTierIndex = 0;     // Where the next frame's search begins
+    
+    static constexpr int MAX_TIERS = 3;     // Floors at 4x, 2x and 1x minFrequency
+};
@@ -2,6 +2,7 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "../Utilities/AudioFrameView.h"
 
 class PitchDetector
 {
@@ -14,13 +15,77 @@ public:
     // Detect pitch from audio buffer (returns frequency in Hz, 0.0 if no pitch detected)
     virtual float detectPitch(const juce::AudioBuffer<float>& buffer) = 0;
     
+    // Detect pitch in a frame of bufferSize samples read where it lies, e.g.
+    // straight out of a circular buffer. The default hands a contiguous
+    // frame to detectPitch without copying and copies any other into a
+    // scratch buffer. That buffer is allocated on first use, so the default
+    // is not real-time safe: detectors the plugin runs override it to read
+    // the view themselves.
+    virtual float detectPitchInFrame(const AudioFrameView& frame)
+    {
+        if (frame.isContiguous())
+        {
+            float* samples = const_cast<float*>(frame.getContiguousData());
+            const juce::AudioBuffer<float> frameBuffer(&samples, 1, frame.getNumSamples());
+            return detectPitch(frameBuffer);
+        }
+        
+        frameScratch.setSize(1, frame.getNumSamples(), false, false, true);
+        frame.copyTo(frameScratch.getWritePointer(0));
+        return detectPitch(frameScratch);
+    }
+    
     // Get algorithm name for UI
     virtual juce::String getName() const = 0;
     
     // Optional: Get confidence value (0.0 to 1.0)
     virtual float getConfidence() const { return 1.0f; }
     
+    // Detect pitch in numFrames frames of bufferSize samples laid out
+    // frameStride samples apart (frame i starts at frames + i * frameStride),
+    // e.g. every hop of a file with frameStride = hop. Writes one frequency
+    // and confidence per frame (confidence 0 where no pitch was found).
+    // The default runs detectPitchInFrame on each frame in place; detectors
+    // override it where a run of frames can share work.
+    virtual void detectPitchBatch(const float* frames, int numFrames, int frameStride,
+                                  float* frequencies, float* confidences)
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            frequencies[i] = detectPitchInFrame(AudioFrameView(frames + static_cast<size_t>(i) * static_cast<size_t>(frameStride), bufferSize));
+            confidences[i] = frequencies[i] > 0.0f ? getConfidence() : 0.0f;
+        }
+    }
+    
+    // Range of frequencies the detector reports (the bass range by default).
+    // Takes effect at the next prepare().
+    virtual void setFrequencyRange(float newMinFrequency, float newMaxFrequency)
+    {
+        minFrequency = newMinFrequency;
+        maxFrequency = newMaxFrequency;
+    }
+    
+    float getMinFrequency() const { return minFrequency; }
+    float getMaxFrequency() const { return maxFrequency; }
+    
+    // Analysis window that holds PERIODS_PER_WINDOW cycles of lowestFrequency:
+    // YIN compares two periods, plus a little room for interpolation
+    static double getWindowSeconds(float lowestFrequency) { return PERIODS_PER_WINDOW / lowestFrequency; }
+    static int getFrameSizeForFrequency(double sampleRate, float lowestFrequency)
+    {
+        return static_cast<int>(std::ceil(getWindowSeconds(lowestFrequency) * sampleRate));
+    }
+    
+    static constexpr float DEFAULT_MIN_FREQUENCY = 30.0f;   // Hz (B0 on 5-string bass)
+    static constexpr float DEFAULT_MAX_FREQUENCY = 400.0f;  // Hz (bass guitar range)
+    static constexpr double PERIODS_PER_WINDOW = 2.2;
+    
 protected:
     double sampleRate = 44100.0;
     int bufferSize = 2048;
+    float minFrequency = DEFAULT_MIN_FREQUENCY;
+    float maxFrequency = DEFAULT_MAX_FREQUENCY;
+    
+private:
+    juce::AudioBuffer<float> frameScratch;  // For views detectPitch can't take in place
 }; 
\ No newline at end of file
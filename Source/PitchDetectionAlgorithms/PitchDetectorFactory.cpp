@@ -0,0 +1,91 @@
+#include "PitchDetectorFactory.h"
+#include "YinPitchDetector.h"
+#include "FFTPitchDetector.h"
+#include "MultiResolutionPitchDetector.h"
+#include "SlidingYinPitchDetector.h"
+#include "MPMPitchDetector.h"
+#include "CepstrumPitchDetector.h"
+#include "HarmonicProductSpectrumPitchDetector.h"
+#include "FixedSizeYinPitchDetector.h"
+#include "FixedSizeFFTPitchDetector.h"
+
+namespace
+{
+    // Frame sizes with compile-time specialisations: the plugin's analysis
+    // frames, 2.2 periods of B0 at the decimated rate of the 44.1 kHz family
+    // (5512.5 Hz) and of the 48 kHz family (6000 Hz)
+    template <int... FrameSizes>
+    struct FrameSizeList {};
+    
+    using SpecialisedFrameSizes = FrameSizeList<405, 440>;
+    
+    // Detector<FrameSize> for the size in the list that matches, or nullptr
+    template <template <int, typename> class Detector, int... FrameSizes>
+    std::unique_ptr<PitchDetector> createForFrameSize(int frameSize, FrameSizeList<FrameSizes...>)
+    {
+        std::unique_ptr<PitchDetector> detector;
+        ((frameSize == FrameSizes ? (void) (detector = std::make_unique<Detector<FrameSizes, float>>()) : (void) 0), ...);
+        return detector;
+    }
+}
+
+namespace PitchDetectorFactory
+{
+    std::vector<std::unique_ptr<PitchDetector>> createAll()
+    {
+        std::vector<std::unique_ptr<PitchDetector>> detectors;
+        detectors.push_back(std::make_unique<YinPitchDetector>());
+        detectors.push_back(std::make_unique<FFTPitchDetector>());
+        detectors.push_back(std::make_unique<MultiResolutionPitchDetector>(
+            [] { return std::make_unique<YinPitchDetector>(); }, "YIN Multi-Res"));
+        detectors.push_back(std::make_unique<SlidingYinPitchDetector>());
+        detectors.push_back(std::make_unique<MPMPitchDetector>());
+        detectors.push_back(std::make_unique<CepstrumPitchDetector>());
+        detectors.push_back(std::make_unique<HarmonicProductSpectrumPitchDetector>());
+        return detectors;
+    }
+    
+    std::vector<std::unique_ptr<PitchDetector>> createAll(int frameSize)
+    {
+        std::vector<std::unique_ptr<PitchDetector>> detectors = createAll();
+        
+        // Specialisations take the place of the dynamic detector of the same name
+        for (auto& specialised : createFixedSize(frameSize))
+        {
+            for (auto& detector : detectors)
+            {
+                if (detector->getName() == specialised->getName())
+                {
+                    detector = std::move(specialised);
+                    break;
+                }
+            }
+        }
+        
+        return detectors;
+    }
+    
+    std::vector<std::unique_ptr<PitchDetector>> createFixedSize(int frameSize)
+    {
+        std::vector<std::unique_ptr<PitchDetector>> detectors;
+        
+        if (auto yin = createForFrameSize<FixedSizeYinPitchDetector>(frameSize, SpecialisedFrameSizes()))
+            detectors.push_back(std::move(yin));
+        
+        if (auto fft = createForFrameSize<FixedSizeFFTPitchDetector>(frameSize, SpecialisedFrameSizes()))
+            detectors.push_back(std::move(fft));
+        
+        return detectors;
+    }
+    
+    void shareSpectralFrameCache(const std::vector<std::unique_ptr<PitchDetector>>& detectors)
+    {
+        auto cache = std::make_shared<SpectralFrameCache>();
+        
+        for (const auto& detector : detectors)
+        {
+            if (auto* spectral = dynamic_cast<SpectralPitchDetector*>(detector.get()))
+                spectral->setSpectralFrameCache(cache);
+        }
+    }
+}
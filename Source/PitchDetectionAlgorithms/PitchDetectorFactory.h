@@ -0,0 +1,27 @@
+#pragma once
+
+#include "PitchDetector.h"
+#include <memory>
+#include <vector>
+
+// Single list of the available pitch detection algorithms, shared by the
+// plugin and the command-line tools
+namespace PitchDetectorFactory
+{
+    // One new instance of every algorithm, in UI order (the first is the default)
+    std::vector<std::unique_ptr<PitchDetector>> createAll();
+    
+    // The same list for frames of frameSize samples: algorithms with a
+    // compile-time specialisation for that size get it, the rest are the
+    // dynamic versions
+    std::vector<std::unique_ptr<PitchDetector>> createAll(int frameSize);
+    
+    // Only the specialisations for frameSize (empty when it has none)
+    std::vector<std::unique_ptr<PitchDetector>> createFixedSize(int frameSize);
+    
+    // Point every spectral detector in the list at one SpectralFrameCache, so
+    // a frame passed to each of them in turn is windowed and transformed once.
+    // Only for detectors run one after another on the same thread; call
+    // before prepare().
+    void shareSpectralFrameCache(const std::vector<std::unique_ptr<PitchDetector>>& detectors);
+}
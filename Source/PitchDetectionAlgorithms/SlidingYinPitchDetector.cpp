@@ -0,0 +1,144 @@
+#include "SlidingYinPitchDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void SlidingYinPitchDetector::prepare(double newSampleRate, int newBufferSize)
+{
+    YinPitchDetector::prepare(newSampleRate, newBufferSize);
+    
+    previousFrame.assign(static_cast<size_t>(bufferSize), 0.0f);
+    currentFrame.assign(static_cast<size_t>(bufferSize), 0.0f);
+    runningDifference.assign(static_cast<size_t>(bufferSize / 2), 0.0);
+    hasPreviousFrame = false;
+    lastShift = 0;
+    samplesSinceFullUpdate = 0;
+    
+    // Sliding costs ~lags x shift, recomputing ~fftSize log2(fftSize)
+    const int halfBufferSize = bufferSize / 2;
+    double fullCost = UPDATE_TO_FFT_COST_RATIO * fftSize * std::log2(static_cast<double>(fftSize));
+    maxShift = juce::jlimit(0, halfBufferSize, static_cast<int>(fullCost / std::max(1, halfBufferSize)));
+}
+
+float SlidingYinPitchDetector::detectPitchInFrame(const AudioFrameView& view)
+{
+    if (view.getNumSamples() != bufferSize)
+        return 0.0f;
+    
+    // The frame is kept as the next one's previous frame anyway, so a view
+    // that isn't contiguous is gathered straight into the buffer that
+    // becomes previousFrame
+    const bool gathered = !view.isContiguous();
+    if (gathered)
+        view.copyTo(currentFrame.data());
+    
+    const float* frame = gathered ? currentFrame.data() : view.getContiguousData();
+    float frequency = detectPitchWithShift(frame, previousFrame.data(), findShift(frame));
+    
+    if (gathered)
+        std::swap(previousFrame, currentFrame);
+    else
+        std::memcpy(previousFrame.data(), frame, sizeof(float) * static_cast<size_t>(bufferSize));
+    
+    hasPreviousFrame = true;
+    return frequency;
+}
+
+void SlidingYinPitchDetector::detectPitchBatch(const float* frames, int numFrames, int frameStride,
+                                               float* frequencies, float* confidences)
+{
+    if (numFrames <= 0)
+        return;
+    
+    // The first frame may continue the last one of the previous call
+    frequencies[0] = detectPitchWithShift(frames, previousFrame.data(), findShift(frames));
+    confidences[0] = frequencies[0] > 0.0f ? confidence : 0.0f;
+    
+    // The rest continue the frame before them in place
+    const int shift = (frameStride > 0 && frameStride <= maxShift) ? frameStride : -1;
+    
+    for (int i = 1; i < numFrames; ++i)
+    {
+        const float* frame = frames + static_cast<size_t>(i) * static_cast<size_t>(frameStride);
+        frequencies[i] = detectPitchWithShift(frame, frame - frameStride, shift);
+        confidences[i] = frequencies[i] > 0.0f ? confidence : 0.0f;
+    }
+    
+    // Remember the last frame so the next call can continue it
+    const float* lastFrame = frames + static_cast<size_t>(numFrames - 1) * static_cast<size_t>(frameStride);
+    std::memcpy(previousFrame.data(), lastFrame, sizeof(float) * static_cast<size_t>(bufferSize));
+    hasPreviousFrame = true;
+}
+
+float SlidingYinPitchDetector::detectPitchWithShift(const float* frame, const float* previous, int shift)
+{
+    // Step 1: Slide the difference function if this frame continues the
+    // previous one by `shift` samples, otherwise start over
+    if (shift > 0 && samplesSinceFullUpdate + shift < bufferSize)
+    {
+        updateDifference(previous, frame, shift);
+        samplesSinceFullUpdate += shift;
+        lastShift = shift;
+    }
+    else
+    {
+        computeFullDifference(frame);
+        samplesSinceFullUpdate = 0;
+        lastShift = 0;
+    }
+    
+    // Steps 2-7 are plain YIN's
+    return estimatePitchFromDifference();
+}
+
+int SlidingYinPitchDetector::findShift(const float* frame) const
+{
+    if (!hasPreviousFrame)
+        return -1;
+    
+    // Hops rarely change, so try the last one before scanning
+    if (lastShift > 0 && continuesPreviousFrame(frame, lastShift))
+        return lastShift;
+    
+    for (int shift = 1; shift <= maxShift; ++shift)
+    {
+        if (previousFrame[static_cast<size_t>(shift)] == frame[0] && continuesPreviousFrame(frame, shift))
+            return shift;
+    }
+    
+    return -1;
+}
+
+bool SlidingYinPitchDetector::continuesPreviousFrame(const float* frame, int shift) const
+{
+    // Frames are copied from the same stream, so the overlap matches exactly
+    return std::memcmp(frame, previousFrame.data() + shift, sizeof(float) * static_cast<size_t>(bufferSize - shift)) == 0;
+}
+
+void SlidingYinPitchDetector::computeFullDifference(const float* frame)
+{
+    computeDifferenceFunction(frame, bufferSize);
+    
+    for (size_t t = 0; t < runningDifference.size(); ++t)
+        runningDifference[t] = differenceBuffer[t];
+}
+
+void SlidingYinPitchDetector::updateDifference(const float* previous, const float* frame, int shift)
+{
+    // d(t) sums (x[i] - x[i + t])^2 over the first half of the frame. Moving
+    // on by `shift` drops the first `shift` terms of the previous frame and
+    // adds the last `shift` terms of the new one's window.
+    const int halfBufferSize = bufferSize / 2;
+    const float* leaving = previous;
+    const float* entering = frame + halfBufferSize - shift;
+    
+    for (int t = 0; t < halfBufferSize; ++t)
+    {
+        double removed = kernels->sumOfSquaredDifferences(leaving, leaving + t, shift);
+        double added = kernels->sumOfSquaredDifferences(entering, entering + t, shift);
+        runningDifference[static_cast<size_t>(t)] += added - removed;
+        
+        // Rounding can push near-zero values slightly negative
+        differenceBuffer[static_cast<size_t>(t)] = static_cast<float>(std::max(0.0, runningDifference[static_cast<size_t>(t)]));
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "YinPitchDetector.h"
+#include <vector>
+
+// YIN that carries its difference function from one overlapping frame to
+// the next.
+//
+// When a frame is the previous one advanced by `shift` samples, each lag's
+// sum of squared differences only loses the `shift` terms that left the
+// integration window and gains the `shift` terms that entered it, so the
+// update costs O(lags x shift) instead of a full recomputation. The shift
+// is found by matching the new frame against the previous one, so callers
+// just pass frames as usual; any frame that doesn't continue the last one
+// (a gap, a hop change, the first frame) is computed in full by plain
+// YIN. Running sums are kept in double and rebuilt once a whole frame has
+// slid past, so rounding never accumulates.
+class SlidingYinPitchDetector : public YinPitchDetector
+{
+public:
+    SlidingYinPitchDetector() = default;
+    ~SlidingYinPitchDetector() override = default;
+    
+    void prepare(double sampleRate, int bufferSize) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
+    juce::String getName() const override { return "YIN Sliding"; }
+    
+    // Frames in a batch are known to continue each other by frameStride, so
+    // they slide without being matched against or copied to previousFrame
+    void detectPitchBatch(const float* frames, int numFrames, int frameStride,
+                          float* frequencies, float* confidences) override;
+    
+    // Shift the last frame was updated by, or 0 if it was computed in full
+    int getLastShift() const { return lastShift; }
+
+private:
+    std::vector<float> previousFrame;
+    std::vector<float> currentFrame;        // A view that isn't contiguous, gathered
+    std::vector<double> runningDifference;  // Per lag, carried between frames
+    bool hasPreviousFrame = false;
+    int lastShift = 0;
+    int samplesSinceFullUpdate = 0;
+    int maxShift = 0;                       // Beyond this a full recomputation is cheaper
+    
+    // Measured: one lag x shift step of the update costs about a third of
+    // one fftSize * log2(fftSize) unit of the FFT difference function
+    static constexpr double UPDATE_TO_FFT_COST_RATIO = 3.0;
+    
+    int findShift(const float* frame) const;
+    bool continuesPreviousFrame(const float* frame, int shift) const;
+    float detectPitchWithShift(const float* frame, const float* previous, int shift);
+    void computeFullDifference(const float* frame);
+    void updateDifference(const float* previous, const float* frame, int shift);
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PitchDetector.h"
+#include "../DSP/SpectralFrameCache.h"
+#include <memory>
+
+// Base for detectors that work from a frame's spectral products.
+//
+// Each detector starts with a cache of its own. Detectors that analyse the
+// same frames on the same thread can be handed one shared cache (see
+// PitchDetectorFactory::shareSpectralFrameCache), and then only the first of
+// them to ask for a product pays for computing it.
+class SpectralPitchDetector : public PitchDetector
+{
+public:
+    void prepare(double newSampleRate, int newBufferSize) override
+    {
+        this->sampleRate = newSampleRate;
+        this->bufferSize = newBufferSize;
+        spectralFrame->prepare(newSampleRate, newBufferSize, getPaddingFactor());
+    }
+    
+    // How much zero padding the detector needs (see SpectralFrameCache);
+    // sharers get the most any of them needs
+    virtual int getPaddingFactor() const { return 2; }
+    
+    // Analyse through this cache from now on (takes effect at the next prepare())
+    void setSpectralFrameCache(std::shared_ptr<SpectralFrameCache> cache) { spectralFrame = std::move(cache); }
+    SpectralFrameCache& getSpectralFrameCache() { return *spectralFrame; }
+    
+    // Override the CPU-selected SIMD kernels (e.g. to validate a specific variant)
+    void setKernelTable(const SimdKernelTable& table) { spectralFrame->setKernelTable(table); }
+
+protected:
+    // Hands the frame to the cache, or returns nullptr if the cache was
+    // prepared for a different frame size
+    SpectralFrameCache* analyseFrame(const AudioFrameView& frame)
+    {
+        if (frame.getNumSamples() != bufferSize || spectralFrame->getFrameSize() != bufferSize)
+            return nullptr;
+        
+        spectralFrame->setFrame(frame);
+        return spectralFrame.get();
+    }
+    
+    std::shared_ptr<SpectralFrameCache> spectralFrame = std::make_shared<SpectralFrameCache>();
+};
@@ -16,6 +16,18 @@ void YinPitchDetector::prepare(double newSampleRate, int newBufferSize)
     differenceBuffer.resize(bufferSize / 2);
     cumulativeMeanNormalizedDifference.resize(bufferSize / 2);
     
+    // The lags we need (< bufferSize / 2) never wrap around a circular
+    // correlation of this length, so no extra zero padding is required
+    fftSize = 1;
+    while (fftSize < bufferSize)
+        fftSize <<= 1;
+    
+    fftEngine.prepare(fftSize);
+    fftBuffer.resize(fftSize);
+    halfFrameSpectrum.resize(fftEngine.getNumBins() * 2);
+    frameSpectrum.resize(fftEngine.getNumBins() * 2);
+    energyPrefixSum.resize(bufferSize + 1);
+    
     // Clear buffers
     std::fill(yinBuffer.begin(), yinBuffer.end(), 0.0f);
     std::fill(differenceBuffer.begin(), differenceBuffer.end(), 0.0f);
@@ -24,14 +36,35 @@ void YinPitchDetector::prepare(double newSampleRate, int newBufferSize)
 
 float YinPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
 {
-    if (buffer.getNumSamples() != bufferSize)
+    return detectPitchInFrame(AudioFrameView(buffer));
+}
+
+float YinPitchDetector::detectPitchInFrame(const AudioFrameView& frame)
+{
+    if (frame.getNumSamples() != bufferSize)
         return 0.0f;
     
-    const float* inputBuffer = buffer.getReadPointer(0);
-    
     // Step 1: Compute difference function
-    computeDifferenceFunction(inputBuffer, bufferSize);
+    computeDifferenceFunction(frame);
     
+    return estimatePitchFromDifference();
+}
+
+void YinPitchDetector::detectPitchBatch(const float* frames, int numFrames, int frameStride,
+                                        float* frequencies, float* confidences)
+{
+    // Frames are read in place, one after the other through the same FFT
+    // tables and working buffers
+    for (int i = 0; i < numFrames; ++i)
+    {
+        computeDifferenceFunction(frames + static_cast<size_t>(i) * static_cast<size_t>(frameStride), bufferSize);
+        frequencies[i] = estimatePitchFromDifference();
+        confidences[i] = frequencies[i] > 0.0f ? confidence : 0.0f;
+    }
+}
+
+float YinPitchDetector::estimatePitchFromDifference()
+{
     // Step 2: Compute cumulative mean normalized difference
     computeCumulativeMeanNormalizedDifference();
     
@@ -51,7 +84,7 @@ float YinPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
     float frequency = static_cast<float>(sampleRate) / interpolatedIndex;
     
     // Step 6: Check if frequency is in valid range for bass guitar
-    if (frequency < MIN_FREQUENCY || frequency > MAX_FREQUENCY)
+    if (frequency < minFrequency || frequency > maxFrequency)
     {
         confidence = 0.0f;
         return 0.0f;
@@ -64,19 +97,71 @@ float YinPitchDetector::detectPitch(const juce::AudioBuffer<float>& buffer)
     return frequency;
 }
 
-void YinPitchDetector::computeDifferenceFunction(const float* buffer, int inputBufferSize)
+void YinPitchDetector::computeDifferenceFunction(const AudioFrameView& frame)
 {
+    if (differenceMethod == DifferenceMethod::FFT)
+        computeDifferenceFunctionFFT(frame);
+    else
+        computeDifferenceFunctionDirect(frame);
+}
+
+void YinPitchDetector::computeDifferenceFunctionDirect(const AudioFrameView& frame)
+{
+    int halfBufferSize = frame.getNumSamples() / 2;
+    
+    // The kernels need adjacent samples; fftBuffer is only scratch here
+    const float* buffer = frame.isContiguous() ? frame.getContiguousData() : fftBuffer.data();
+    if (!frame.isContiguous())
+        frame.copyTo(fftBuffer.data());
+    
+    for (int t = 0; t < halfBufferSize; ++t)
+    {
+        differenceBuffer[t] = kernels->sumOfSquaredDifferences(buffer, buffer + t, halfBufferSize);
+    }
+}
+
+void YinPitchDetector::computeDifferenceFunctionFFT(const AudioFrameView& frame)
+{
+    // d(t) = sum (x[i] - x[i+t])^2
+    //      = sum x[i]^2 + sum x[i+t]^2 - 2 * r(t)
+    // where r(t) is the cross-correlation of the first half of the frame with
+    // the whole frame, and both energy terms come from one prefix sum.
+    const int inputBufferSize = frame.getNumSamples();
     int halfBufferSize = inputBufferSize / 2;
     
+    // Step 1: The frame goes straight into the zero-padded FFT input, its
+    // only copy
+    frame.copyTo(fftBuffer.data());
+    std::fill(fftBuffer.begin() + inputBufferSize, fftBuffer.end(), 0.0f);
+    
+    // Step 2: Running energy sums
+    energyPrefixSum[0] = 0.0;
+    for (int i = 0; i < inputBufferSize; ++i)
+        energyPrefixSum[i + 1] = energyPrefixSum[i] + static_cast<double>(fftBuffer[i]) * fftBuffer[i];
+    
+    // Step 3: Spectra of the whole frame and of its zero-padded first half
+    fftEngine.performRealForward(fftBuffer.data(), frameSpectrum.data());
+    
+    std::fill(fftBuffer.begin() + halfBufferSize, fftBuffer.begin() + inputBufferSize, 0.0f);
+    fftEngine.performRealForward(fftBuffer.data(), halfFrameSpectrum.data());
+    
+    // Step 4: Cross-spectrum conj(A) * X
+    kernels->complexMultiplyConjugate(halfFrameSpectrum.data(), frameSpectrum.data(),
+                                      frameSpectrum.data(), fftEngine.getNumBins());
+    
+    // Step 5: Inverse FFT gives the cross-correlation r(t)
+    fftEngine.performRealInverse(frameSpectrum.data(), fftBuffer.data());
+    
+    const double firstHalfEnergy = energyPrefixSum[halfBufferSize];
+    
+    // Step 6: Combine energy terms with the autocorrelation
     for (int t = 0; t < halfBufferSize; ++t)
     {
-        differenceBuffer[t] = 0.0f;
+        double laggedEnergy = energyPrefixSum[t + halfBufferSize] - energyPrefixSum[t];
+        double correlation = fftBuffer[t];
         
-        for (int i = 0; i < halfBufferSize; ++i)
-        {
-            float diff = buffer[i] - buffer[i + t];
-            differenceBuffer[t] += diff * diff;
-        }
+        // Rounding can push near-zero values slightly negative
+        differenceBuffer[t] = static_cast<float>(std::max(0.0, firstHalfEnergy + laggedEnergy - 2.0 * correlation));
     }
 }
 
@@ -87,14 +172,18 @@ void YinPitchDetector::computeCumulativeMeanNormalizedDifference()
     // First value
     cumulativeMeanNormalizedDifference[0] = 1.0f;
     
-    // Compute running sum
+    // Compute running sum (inherently serial, stored in place)
     float runningSum = differenceBuffer[0];
     
     for (int t = 1; t < halfBufferSize; ++t)
     {
         runningSum += differenceBuffer[t];
-        cumulativeMeanNormalizedDifference[t] = differenceBuffer[t] / (runningSum / (t + 1));
+        cumulativeMeanNormalizedDifference[t] = runningSum;
     }
+    
+    // Normalise by the running mean: d[t] / (sum / (t + 1))
+    kernels->divideByRunningMean(differenceBuffer.data(), cumulativeMeanNormalizedDifference.data(),
+                                 cumulativeMeanNormalizedDifference.data(), 1, halfBufferSize);
 }
 
 int YinPitchDetector::findMinimumIndex() const
@@ -140,6 +229,12 @@ float YinPitchDetector::parabolicInterpolation(int index) const
     return static_cast<float>(index) + peak;
 }
 
+void YinPitchDetector::setKernelTable(const SimdKernelTable& table)
+{
+    kernels = &table;
+    fftEngine.setKernelTable(table);
+}
+
 float YinPitchDetector::getConfidence() const
 {
     return confidence;
@@ -1,33 +1,68 @@
 #pragma once
 
 #include "PitchDetector.h"
+#include "../DSP/FFTEngine.h"
+#include "../DSP/SimdKernels.h"
 #include <vector>
 
 class YinPitchDetector : public PitchDetector
 {
 public:
+    // How the YIN difference function is evaluated
+    enum class DifferenceMethod
+    {
+        Direct, // O(N^2) reference implementation, kept for validation
+        FFT     // O(N log N) via autocorrelation and running energy sums
+    };
+    
     YinPitchDetector();
     ~YinPitchDetector() override = default;
     
     void prepare(double sampleRate, int bufferSize) override;
     float detectPitch(const juce::AudioBuffer<float>& buffer) override;
+    float detectPitchInFrame(const AudioFrameView& frame) override;
+    void detectPitchBatch(const float* frames, int numFrames, int frameStride,
+                          float* frequencies, float* confidences) override;
     juce::String getName() const override { return "YIN"; }
     float getConfidence() const override;
+    
+    // Select the difference function implementation (FFT by default)
+    void setDifferenceMethod(DifferenceMethod method) { differenceMethod = method; }
+    DifferenceMethod getDifferenceMethod() const { return differenceMethod; }
+    
+    // Override the CPU-selected SIMD kernels (e.g. to validate a specific variant)
+    void setKernelTable(const SimdKernelTable& table);
 
-private:
+protected:
     std::vector<float> yinBuffer;
     std::vector<float> differenceBuffer;
     std::vector<float> cumulativeMeanNormalizedDifference;
     
+    const SimdKernelTable* kernels = &SimdKernels::getActive();
+    
+    // Working storage for the FFT difference function
+    FFTEngine fftEngine;
+    std::vector<float> fftBuffer;        // Real FFT input/output
+    std::vector<float> halfFrameSpectrum;
+    std::vector<float> frameSpectrum;
+    std::vector<double> energyPrefixSum;
+    int fftSize = 2048;
+    
+    DifferenceMethod differenceMethod = DifferenceMethod::FFT;
     float threshold = 0.15f;
     float confidence = 1.0f;
     
-    // YIN algorithm parameters - Updated for full bass guitar range
-    static constexpr float MIN_FREQUENCY = 30.0f;   // Hz (B0 on 5-string bass)
-    static constexpr float MAX_FREQUENCY = 400.0f;  // Hz (bass guitar range)
+    // Stage-level timing in the benchmark tool
+    friend class DetectorStageBenchmarks;
+    
+    // Steps 2-7 of detectPitch, on the difference function already in differenceBuffer
+    float estimatePitchFromDifference();
     
-    void computeDifferenceFunction(const float* buffer, int bufferSize);
+    void computeDifferenceFunction(const float* buffer, int bufferSize) { computeDifferenceFunction(AudioFrameView(buffer, bufferSize)); }
+    void computeDifferenceFunction(const AudioFrameView& frame);
+    void computeDifferenceFunctionDirect(const AudioFrameView& frame);
+    void computeDifferenceFunctionFFT(const AudioFrameView& frame);
     void computeCumulativeMeanNormalizedDifference();
     int findMinimumIndex() const;
     float parabolicInterpolation(int index) const;
-}; 
\ No newline at end of file
+};
@@ -7,7 +7,9 @@ PitchDetectionTesterAudioProcessorEditor::PitchDetectionTesterAudioProcessorEdit
     setupUI();
     
     // Set window size
-    setSize(600, 500);
+    setSize(860, 640);
+    
+    startTimerHz(10); // Pipeline counters don't need the full statistics rate
 }
 
 PitchDetectionTesterAudioProcessorEditor::~PitchDetectionTesterAudioProcessorEditor()
@@ -40,17 +42,35 @@ void PitchDetectionTesterAudioProcessorEditor::resized()
     
     // Top control panel
     auto controlPanel = bounds.removeFromTop(80);
+    auto algorithmRow = controlPanel.removeFromTop(35);
+    controlPanel.removeFromTop(10); // Spacing
+    auto analysisRow = controlPanel;
     
     // Algorithm selector
-    algorithmLabel.setBounds(controlPanel.removeFromLeft(120));
-    algorithmSelector.setBounds(controlPanel.removeFromLeft(150));
+    algorithmLabel.setBounds(algorithmRow.removeFromLeft(120));
+    algorithmSelector.setBounds(algorithmRow.removeFromLeft(150));
     
-    controlPanel.removeFromLeft(20); // Spacing
+    algorithmRow.removeFromLeft(20); // Spacing
     
     // Buttons
-    resetButton.setBounds(controlPanel.removeFromLeft(100));
-    controlPanel.removeFromLeft(20); // Spacing
-    helpButton.setBounds(controlPanel.removeFromLeft(100));
+    resetButton.setBounds(algorithmRow.removeFromLeft(100));
+    algorithmRow.removeFromLeft(20); // Spacing
+    helpButton.setBounds(algorithmRow.removeFromLeft(100));
+    algorithmRow.removeFromLeft(20); // Spacing
+    
+    // Channel selector
+    channelLabel.setBounds(algorithmRow.removeFromLeft(70));
+    channelSelector.setBounds(algorithmRow);
+    
+    // Hop size selector
+    hopSizeLabel.setBounds(analysisRow.removeFromLeft(120));
+    hopSizeSelector.setBounds(analysisRow.removeFromLeft(150));
+    analysisRow.removeFromLeft(20); // Spacing
+    backgroundAnalysisToggle.setBounds(analysisRow.removeFromLeft(100));
+    comparisonToggle.setBounds(analysisRow.removeFromLeft(100));
+    historyToggle.setBounds(analysisRow.removeFromLeft(80));
+    recordToggle.setBounds(analysisRow.removeFromLeft(80));
+    pipelineStatusLabel.setBounds(analysisRow);
     
     bounds.removeFromTop(20); // Spacing
     
@@ -65,6 +85,14 @@ void PitchDetectionTesterAudioProcessorEditor::comboBoxChanged(juce::ComboBox* c
     {
         algorithmChanged();
     }
+    else if (comboBox == &hopSizeSelector)
+    {
+        hopSizeChanged();
+    }
+    else if (comboBox == &channelSelector)
+    {
+        channelChanged();
+    }
 }
 
 void PitchDetectionTesterAudioProcessorEditor::setupUI()
@@ -81,6 +109,64 @@ void PitchDetectionTesterAudioProcessorEditor::setupUI()
     algorithmSelector.addListener(this);
     addAndMakeVisible(algorithmSelector);
     
+    // Hop size label
+    hopSizeLabel.setText("Hop Size:", juce::dontSendNotification);
+    hopSizeLabel.setFont(juce::Font(16.0f, juce::Font::bold));
+    hopSizeLabel.setColour(juce::Label::textColourId, textColor);
+    hopSizeLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(hopSizeLabel);
+    
+    // Hop size selector
+    updateHopSizeSelector();
+    hopSizeSelector.addListener(this);
+    addAndMakeVisible(hopSizeSelector);
+    
+    // Channel label
+    channelLabel.setText("Channel:", juce::dontSendNotification);
+    channelLabel.setFont(juce::Font(16.0f, juce::Font::bold));
+    channelLabel.setColour(juce::Label::textColourId, textColor);
+    channelLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(channelLabel);
+    
+    // Channel selector
+    updateChannelSelector();
+    channelSelector.addListener(this);
+    addAndMakeVisible(channelSelector);
+    
+    // Background analysis toggle
+    backgroundAnalysisToggle.setButtonText("Background");
+    backgroundAnalysisToggle.setColour(juce::ToggleButton::textColourId, textColor);
+    backgroundAnalysisToggle.setToggleState(audioProcessor.isBackgroundAnalysisEnabled(), juce::dontSendNotification);
+    backgroundAnalysisToggle.onClick = [this] { backgroundAnalysisChanged(); };
+    addAndMakeVisible(backgroundAnalysisToggle);
+    
+    // Comparison mode toggle
+    comparisonToggle.setButtonText("Compare");
+    comparisonToggle.setColour(juce::ToggleButton::textColourId, textColor);
+    comparisonToggle.setToggleState(audioProcessor.isComparisonModeEnabled(), juce::dontSendNotification);
+    comparisonToggle.onClick = [this] { comparisonModeChanged(); };
+    addAndMakeVisible(comparisonToggle);
+    
+    // Pitch history plot toggle
+    historyToggle.setButtonText("History");
+    historyToggle.setColour(juce::ToggleButton::textColourId, textColor);
+    historyToggle.onClick = [this] { updateDisplayMode(); };
+    addAndMakeVisible(historyToggle);
+    
+    // Session log toggle
+    recordToggle.setButtonText("Record");
+    recordToggle.setColour(juce::ToggleButton::textColourId, textColor);
+    recordToggle.setToggleState(audioProcessor.isSessionRecording(), juce::dontSendNotification);
+    recordToggle.onClick = [this] { recordingChanged(); };
+    addAndMakeVisible(recordToggle);
+    
+    // Pipeline status label
+    pipelineStatusLabel.setFont(juce::Font(12.0f));
+    pipelineStatusLabel.setColour(juce::Label::textColourId, textColor.withAlpha(0.7f));
+    pipelineStatusLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(pipelineStatusLabel);
+    updatePipelineStatus();
+    
     // Reset button
     resetButton.setButtonText("Reset Stats");
     resetButton.onClick = [this] { resetStatistics(); };
@@ -96,10 +182,26 @@ void PitchDetectionTesterAudioProcessorEditor::setupUI()
     addAndMakeVisible(helpButton);
     
     // Statistics display
-    statisticsDisplay = std::make_unique<StatisticsDisplay>(audioProcessor.getStatisticsManager());
+    statisticsDisplay = std::make_unique<StatisticsDisplay>(audioProcessor.getChannelAnalyzer(0).getStatisticsManager());
+    showChannel(displayedChannel);
+    updateDisplayMode();
+    
     addAndMakeVisible(statisticsDisplay.get());
 }
 
+void PitchDetectionTesterAudioProcessorEditor::showChannel(int channel)
+{
+    displayedChannel = channel;
+    ChannelAnalyzer& analyzer = audioProcessor.getChannelAnalyzer(channel);
+    
+    juce::Array<StatisticsManager*> comparisonStatistics;
+    for (int i = 0; i < analyzer.getNumDetectors(); ++i)
+        comparisonStatistics.add(&analyzer.getComparisonStatistics(i));
+    
+    statisticsDisplay->setStatisticsSource(analyzer.getStatisticsManager());
+    statisticsDisplay->setComparisonSources(audioProcessor.getAlgorithmNames(), comparisonStatistics);
+}
+
 void PitchDetectionTesterAudioProcessorEditor::updateAlgorithmSelector()
 {
     algorithmSelector.clear();
@@ -114,6 +216,32 @@ void PitchDetectionTesterAudioProcessorEditor::updateAlgorithmSelector()
     algorithmSelector.setSelectedId(audioProcessor.getCurrentAlgorithmIndex() + 1, juce::dontSendNotification);
 }
 
+void PitchDetectionTesterAudioProcessorEditor::updateHopSizeSelector()
+{
+    hopSizeSelector.clear();
+    
+    juce::Array<int> hopSizes = PitchDetectionTesterAudioProcessor::getAvailableHopSizes();
+    for (int i = 0; i < hopSizes.size(); ++i)
+    {
+        hopSizeSelector.addItem(juce::String(hopSizes[i]) + " samples", hopSizes[i]);
+    }
+    
+    // Set current selection
+    hopSizeSelector.setSelectedId(audioProcessor.getHopSize(), juce::dontSendNotification);
+}
+
+void PitchDetectionTesterAudioProcessorEditor::updateChannelSelector()
+{
+    channelSelector.clear(juce::dontSendNotification);
+    
+    for (int channel = 0; channel < audioProcessor.getNumAnalysisChannels(); ++channel)
+        channelSelector.addItem(juce::String(channel + 1), channel + 1);
+    
+    // Keep the current channel if the host still provides it
+    displayedChannel = juce::jmin(displayedChannel, audioProcessor.getNumAnalysisChannels() - 1);
+    channelSelector.setSelectedId(displayedChannel + 1, juce::dontSendNotification);
+}
+
 void PitchDetectionTesterAudioProcessorEditor::algorithmChanged()
 {
     int selectedIndex = algorithmSelector.getSelectedId() - 1;
@@ -123,9 +251,126 @@ void PitchDetectionTesterAudioProcessorEditor::algorithmChanged()
     }
 }
 
+void PitchDetectionTesterAudioProcessorEditor::hopSizeChanged()
+{
+    int selectedHopSize = hopSizeSelector.getSelectedId();
+    if (selectedHopSize > 0)
+    {
+        audioProcessor.setHopSize(selectedHopSize);
+    }
+}
+
+void PitchDetectionTesterAudioProcessorEditor::channelChanged()
+{
+    int selectedChannel = channelSelector.getSelectedId() - 1;
+    if (selectedChannel >= 0)
+    {
+        showChannel(selectedChannel);
+        updatePipelineStatus();
+    }
+}
+
+void PitchDetectionTesterAudioProcessorEditor::backgroundAnalysisChanged()
+{
+    audioProcessor.setBackgroundAnalysisEnabled(backgroundAnalysisToggle.getToggleState());
+    updatePipelineStatus();
+}
+
+void PitchDetectionTesterAudioProcessorEditor::comparisonModeChanged()
+{
+    audioProcessor.setComparisonModeEnabled(comparisonToggle.getToggleState());
+    updateDisplayMode();
+    updatePipelineStatus();
+}
+
+void PitchDetectionTesterAudioProcessorEditor::updateDisplayMode()
+{
+    // The comparison table takes over while comparing
+    if (comparisonToggle.getToggleState())
+        statisticsDisplay->setDisplayMode(StatisticsDisplay::Comparison);
+    else if (historyToggle.getToggleState())
+        statisticsDisplay->setDisplayMode(StatisticsDisplay::History);
+    else
+        statisticsDisplay->setDisplayMode(StatisticsDisplay::RealTime);
+}
+
+void PitchDetectionTesterAudioProcessorEditor::recordingChanged()
+{
+    if (!recordToggle.getToggleState())
+    {
+        audioProcessor.stopSessionRecording();
+        updatePipelineStatus();
+        return;
+    }
+    
+    // A new log per recording, next to the user's documents
+    juce::File file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                          .getChildFile("Pitch Detection Tester")
+                          .getChildFile("Session " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S") + ".pdtlog");
+    
+    juce::Result result = audioProcessor.startSessionRecording(file);
+    if (result.failed())
+    {
+        recordToggle.setToggleState(false, juce::dontSendNotification);
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Recording failed",
+                                               result.getErrorMessage(), "OK");
+    }
+    
+    updatePipelineStatus();
+}
+
+void PitchDetectionTesterAudioProcessorEditor::timerCallback()
+{
+    // The host can change the number of inputs while the editor is open
+    if (channelSelector.getNumItems() != audioProcessor.getNumAnalysisChannels())
+    {
+        updateChannelSelector();
+        showChannel(displayedChannel);
+    }
+    
+    updatePipelineStatus();
+}
+
+void PitchDetectionTesterAudioProcessorEditor::updatePipelineStatus()
+{
+    ChannelAnalyzer& analyzer = audioProcessor.getChannelAnalyzer(displayedChannel);
+    
+    if (audioProcessor.isSessionRecording())
+    {
+        const SessionRecorder& recorder = audioProcessor.getSessionRecorder();
+        pipelineStatusLabel.setText("Recording: " + juce::String(recorder.getNumRecordsWritten()) + " frames, dropped: "
+                                    + juce::String(recorder.getDroppedRecords()), juce::dontSendNotification);
+        return;
+    }
+    
+    if (audioProcessor.isComparisonModeEnabled())
+    {
+        int droppedFrames = 0;
+        for (int i = 0; i < analyzer.getNumDetectors(); ++i)
+            droppedFrames += analyzer.getComparisonPipeline(i).getDroppedFrames();
+        
+        pipelineStatusLabel.setText(juce::String(audioProcessor.getWorkerPool().getNumWorkers()) + " workers, dropped: "
+                                    + juce::String(droppedFrames), juce::dontSendNotification);
+        return;
+    }
+    
+    if (!audioProcessor.isBackgroundAnalysisEnabled())
+    {
+        pipelineStatusLabel.setText("Analysis on audio thread", juce::dontSendNotification);
+        return;
+    }
+    
+    const AnalysisPipeline& pipeline = analyzer.getAnalysisPipeline();
+    pipelineStatusLabel.setText("Queue: " + juce::String(pipeline.getQueueDepth())
+                                + " (max " + juce::String(pipeline.getMaxQueueDepth())
+                                + "/" + juce::String(pipeline.getQueueCapacity())
+                                + "), dropped: " + juce::String(pipeline.getDroppedFrames()),
+                                juce::dontSendNotification);
+}
+
 void PitchDetectionTesterAudioProcessorEditor::resetStatistics()
 {
-    audioProcessor.getStatisticsManager().reset();
+    audioProcessor.requestStatisticsReset();
 }
 
 void PitchDetectionTesterAudioProcessorEditor::showHelp()
@@ -137,10 +382,21 @@ void PitchDetectionTesterAudioProcessorEditor::showHelp()
         "1. Select an algorithm from the dropdown menu\n"
         "2. Play your bass guitar through the plugin\n"
         "3. View real-time statistics and performance metrics\n"
-        "4. Compare different algorithms' performance\n\n"
+        "4. Compare different algorithms' performance\n"
+        "5. Lower the hop size for faster pitch updates\n"
+        "6. Enable Background to run detection off the audio thread\n"
+        "7. Enable Compare to run every algorithm on the same audio side by side\n"
+        "8. Pick a channel to see each input's statistics separately\n"
+        "9. Enable History to plot the pitch over the whole session\n"
+        "10. Enable Record to log every measurement to Documents/Pitch Detection Tester\n\n"
         "Available Algorithms:\n"
         "• YIN: Robust pitch detection using autocorrelation\n"
-        "• FFT: Fast Fourier Transform based detection\n\n"
+        "• FFT: Fast Fourier Transform based detection\n"
+        "• YIN Multi-Res: YIN with shorter windows for higher notes\n"
+        "• YIN Sliding: YIN that updates incrementally between frames\n"
+        "• MPM: McLeod method, shorter window than YIN\n"
+        "• Cepstrum: Harmonic spacing from the log spectrum\n"
+        "• HPS: Harmonic product spectrum\n\n"
         "Statistics:\n"
         "• Current Pitch: Real-time detected frequency\n"
         "• Stability: How consistent the detection is\n"
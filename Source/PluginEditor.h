@@ -5,12 +5,13 @@
 #include "PluginProcessor.h"
 #include "UI/StatisticsDisplay.h"
 
-class PitchDetectionTesterAudioProcessorEditor : public juce::AudioProcessorEditor, public juce::ComboBox::Listener
+class PitchDetectionTesterAudioProcessorEditor : public juce::AudioProcessorEditor, public juce::ComboBox::Listener,
+                                                 private juce::Timer
 {
 public:
     PitchDetectionTesterAudioProcessorEditor(PitchDetectionTesterAudioProcessor&);
     ~PitchDetectionTesterAudioProcessorEditor() override;
-
+    
     void paint(juce::Graphics&) override;
     void resized() override;
     
@@ -23,11 +24,21 @@ private:
     // UI Components
     juce::ComboBox algorithmSelector;
     juce::Label algorithmLabel;
+    juce::ComboBox hopSizeSelector;
+    juce::Label hopSizeLabel;
+    juce::ComboBox channelSelector;
+    juce::Label channelLabel;
+    juce::ToggleButton backgroundAnalysisToggle;
+    juce::ToggleButton comparisonToggle;
+    juce::ToggleButton historyToggle;
+    juce::ToggleButton recordToggle;
+    juce::Label pipelineStatusLabel;
     juce::TextButton resetButton;
     juce::TextButton helpButton;
     
-    // Statistics display
+    // Statistics display, showing one input channel at a time
     std::unique_ptr<StatisticsDisplay> statisticsDisplay;
+    int displayedChannel = 0;
     
     // Colors
     juce::Colour backgroundColor = juce::Colour(0xFF1E1E1E);
@@ -37,12 +48,25 @@ private:
     
     // Callbacks
     void algorithmChanged();
+    void hopSizeChanged();
+    void channelChanged();
+    void backgroundAnalysisChanged();
+    void comparisonModeChanged();
+    void updateDisplayMode();
+    void recordingChanged();
     void resetStatistics();
     void showHelp();
     
     // Helper methods
     void setupUI();
     void updateAlgorithmSelector();
-
+    void updateHopSizeSelector();
+    void updateChannelSelector();
+    void showChannel(int channel);
+    void updatePipelineStatus();
+    
+    // Timer callback for the pipeline counters
+    void timerCallback() override;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDetectionTesterAudioProcessorEditor)
 }; 
\ No newline at end of file
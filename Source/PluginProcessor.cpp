@@ -1,22 +1,27 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Diagnostics/RealtimeSafetyChecker.h"
 
 PitchDetectionTesterAudioProcessor::PitchDetectionTesterAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 {
-    // Initialize pitch detectors
-    yinDetector = std::make_unique<YinPitchDetector>();
-    fftDetector = std::make_unique<FFTPitchDetector>();
-    
-    // Set default algorithm
-    currentPitchDetector = std::make_unique<YinPitchDetector>();
-    currentAlgorithmIndex = 0;
+    // Each analyzer creates its own set of pitch detectors
+    for (int channel = 0; channel < MAX_ANALYSIS_CHANNELS; ++channel)
+    {
+        channelAnalyzers.push_back(std::make_unique<ChannelAnalyzer>(workerPool));
+        channelAnalyzers.back()->setSessionRecorder(&sessionRecorder, channel);
+    }
 }
 
 PitchDetectionTesterAudioProcessor::~PitchDetectionTesterAudioProcessor()
 {
+    // Workers stop before the pipelines they service go away
+    workerPool.stop();
+    
+    // Finish the log with whatever the audio thread queued last
+    sessionRecorder.stop();
 }
 
 const juce::String PitchDetectionTesterAudioProcessor::getName() const
@@ -75,74 +80,70 @@ void PitchDetectionTesterAudioProcessor::prepareToPlay(double newSampleRate, int
     this->sampleRate = newSampleRate;
     this->bufferSize = samplesPerBlock;
     
-    // Prepare analysis buffer
-    analysisBuffer.setSize(1, ANALYSIS_BUFFER_SIZE);
-    analysisBuffer.clear();
-    analysisBufferIndex = 0;
+    // Pick the largest decimation factor that keeps the whole pitch range
+    // (and a few harmonics) below the analysis Nyquist. Hops keep their
+    // host-rate duration, so they shrink by the same factor.
+    decimationFactor = PolyphaseDecimator::chooseFactor(newSampleRate, MIN_ANALYSIS_SAMPLE_RATE);
     
-    // Prepare pitch detectors
-    if (yinDetector) yinDetector->prepare(newSampleRate, ANALYSIS_BUFFER_SIZE);
-    if (fftDetector) fftDetector->prepare(newSampleRate, ANALYSIS_BUFFER_SIZE);
-    if (currentPitchDetector) currentPitchDetector->prepare(newSampleRate, ANALYSIS_BUFFER_SIZE);
+    // Prepare one analyzer per input channel (stops their pipelines while
+    // reallocating); the rest stay idle
+    int numChannels = juce::jlimit(1, MAX_ANALYSIS_CHANNELS, getTotalNumInputChannels());
+    for (int channel = 0; channel < numChannels; ++channel)
+        channelAnalyzers[static_cast<size_t>(channel)]->prepare(newSampleRate, decimationFactor, requestedHopSize.load(),
+                                                                requestedAlgorithmIndex.load());
     
-    // Reset statistics
-    statisticsManager.reset();
+    numAnalysisChannels.store(numChannels);
+    isPrepared.store(true);
+    updatePipelines(comparisonModeEnabled.load(), backgroundAnalysisEnabled.load());
 }
 
 void PitchDetectionTesterAudioProcessor::releaseResources()
 {
-    analysisBuffer.setSize(0, 0);
+    isPrepared.store(false);
+    updatePipelines(comparisonModeEnabled.load(), backgroundAnalysisEnabled.load());
+    
+    // Only ever non-zero in a PITCH_DETECTION_REALTIME_CHECKS build
+    if (RealtimeSafetyChecker::getNumViolations() > 0)
+    {
+        juce::Logger::writeToLog(RealtimeSafetyChecker::getReport());
+        jassertfalse; // processBlock allocated or locked; see the report above
+        RealtimeSafetyChecker::reset();
+    }
+}
+
+bool PitchDetectionTesterAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    const int numInputs = layouts.getMainInputChannels();
+    return numInputs >= 1 && numInputs <= MAX_ANALYSIS_CHANNELS && layouts.getMainOutputChannelSet() == layouts.getMainInputChannelSet();
 }
 
 void PitchDetectionTesterAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
     
+    // In a PITCH_DETECTION_REALTIME_CHECKS build, any allocation or mutex
+    // lock from here on is reported
+    RealtimeSafetyChecker::ScopedAudioThread audioThread;
+    
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
-
+    
     // Clear unused output channels
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
-
-    // Get input audio for analysis
-    const float* inputChannel = buffer.getReadPointer(0);
-    int numSamples = buffer.getNumSamples();
     
-    // Fill analysis buffer
-    for (int i = 0; i < numSamples; ++i)
-    {
-        analysisBuffer.setSample(0, analysisBufferIndex, inputChannel[i]);
-        analysisBufferIndex++;
-        
-        // When buffer is full, perform pitch detection
-        if (analysisBufferIndex >= ANALYSIS_BUFFER_SIZE)
-        {
-            // Check if there's enough signal
-            float rms = 0.0f;
-            for (int j = 0; j < ANALYSIS_BUFFER_SIZE; ++j)
-            {
-                float sample = analysisBuffer.getSample(0, j);
-                rms += sample * sample;
-            }
-            rms = std::sqrt(rms / ANALYSIS_BUFFER_SIZE);
-            
-            if (rms > MIN_AMPLITUDE_THRESHOLD && currentPitchDetector)
-            {
-                float detectedPitch = currentPitchDetector->detectPitch(analysisBuffer);
-                
-                if (detectedPitch > 0.0f)
-                {
-                    // Update statistics
-                    statisticsManager.addPitchMeasurement(detectedPitch, rms);
-                }
-            }
-            
-            // Reset buffer index
-            analysisBufferIndex = 0;
-        }
-    }
+    // Settings from the UI, the same for every channel this block
+    ChannelAnalyzer::BlockSettings settings;
+    settings.hopSize = requestedHopSize.load(std::memory_order_relaxed);
+    settings.algorithmIndex = requestedAlgorithmIndex.load(std::memory_order_relaxed);
+    settings.backgroundAnalysis = backgroundAnalysisEnabled.load(std::memory_order_relaxed);
+    settings.comparisonMode = comparisonModeEnabled.load(std::memory_order_relaxed);
+    
+    // Each input channel feeds its own analyzer
+    int numChannels = std::min(numAnalysisChannels.load(std::memory_order_relaxed), totalNumInputChannels);
+    for (int channel = 0; channel < numChannels; ++channel)
+        channelAnalyzers[static_cast<size_t>(channel)]->processBlock(buffer.getReadPointer(channel), buffer.getNumSamples(), settings);
 }
 
 bool PitchDetectionTesterAudioProcessor::hasEditor() const
@@ -167,34 +168,86 @@ void PitchDetectionTesterAudioProcessor::setStateInformation(const void* data, i
 
 void PitchDetectionTesterAudioProcessor::setPitchDetectionAlgorithm(int algorithmIndex)
 {
-    if (algorithmIndex == currentAlgorithmIndex)
+    if (algorithmIndex < 0 || algorithmIndex >= getNumDetectors())
+        algorithmIndex = 0;
+    
+    requestedAlgorithmIndex.store(algorithmIndex);
+}
+
+void PitchDetectionTesterAudioProcessor::setHopSize(int newHopSize)
+{
+    requestedHopSize.store(juce::jlimit(MIN_HOP_SIZE, MAX_HOP_SIZE, newHopSize));
+}
+
+void PitchDetectionTesterAudioProcessor::setBackgroundAnalysisEnabled(bool shouldBeEnabled)
+{
+    // The pipeline stops (waiting out a frame in flight) before the audio
+    // thread goes back to running the detector itself, and is running before
+    // the audio thread hands frames to it
+    updatePipelines(comparisonModeEnabled.load(), shouldBeEnabled);
+    backgroundAnalysisEnabled.store(shouldBeEnabled);
+}
+
+void PitchDetectionTesterAudioProcessor::setComparisonModeEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == comparisonModeEnabled.load())
         return;
-        
-    currentAlgorithmIndex = algorithmIndex;
     
-    switch (algorithmIndex)
+    // Start each comparison from fresh statistics
+    if (shouldBeEnabled)
     {
-        case 0: // YIN
-            currentPitchDetector = std::make_unique<YinPitchDetector>();
-            break;
-        case 1: // FFT
-            currentPitchDetector = std::make_unique<FFTPitchDetector>();
-            break;
-        default:
-            currentPitchDetector = std::make_unique<YinPitchDetector>();
-            break;
+        for (auto& analyzer : channelAnalyzers)
+            analyzer->resetComparison();
     }
     
-    if (currentPitchDetector)
-        currentPitchDetector->prepare(sampleRate, ANALYSIS_BUFFER_SIZE);
-        
-    // Reset statistics when changing algorithm
-    statisticsManager.reset();
+    // A detector must never run on two threads at once, so the pipelines
+    // that were using the detectors stop (waiting out frames in flight)
+    // before the audio thread sees the new mode
+    updatePipelines(shouldBeEnabled, backgroundAnalysisEnabled.load());
+    comparisonModeEnabled.store(shouldBeEnabled);
+}
+
+void PitchDetectionTesterAudioProcessor::updatePipelines(bool comparing, bool background)
+{
+    // Before prepareToPlay everything stays stopped and is started there
+    // instead. Each analyzer stops the pipelines that were using its
+    // detectors before starting the others.
+    bool useWorkers = isPrepared.load() && (comparing || background);
+    
+    for (int channel = 0; channel < MAX_ANALYSIS_CHANNELS; ++channel)
+    {
+        if (useWorkers && channel < numAnalysisChannels.load())
+            channelAnalyzers[static_cast<size_t>(channel)]->startPipelines(comparing);
+        else
+            channelAnalyzers[static_cast<size_t>(channel)]->stopPipelines();
+    }
+    
+    if (useWorkers)
+        workerPool.start();
+    else
+        workerPool.stop();
+}
+
+void PitchDetectionTesterAudioProcessor::requestStatisticsReset()
+{
+    // Applied by the audio thread so it never races with new measurements
+    for (auto& analyzer : channelAnalyzers)
+        analyzer->requestStatisticsReset();
+}
+
+juce::Result PitchDetectionTesterAudioProcessor::startSessionRecording(const juce::File& file)
+{
+    return sessionRecorder.start(file);
+}
+
+void PitchDetectionTesterAudioProcessor::stopSessionRecording()
+{
+    sessionRecorder.stop();
 }
 
 juce::StringArray PitchDetectionTesterAudioProcessor::getAlgorithmNames() const
 {
-    return {"YIN", "FFT"};
+    return channelAnalyzers.front()->getAlgorithmNames();
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -2,70 +2,125 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "PitchDetectionAlgorithms/PitchDetector.h"
-#include "PitchDetectionAlgorithms/YinPitchDetector.h"
-#include "PitchDetectionAlgorithms/FFTPitchDetector.h"
-#include "Statistics/StatisticsManager.h"
+#include "Analysis/AnalysisWorkerPool.h"
+#include "Analysis/ChannelAnalyzer.h"
+#include "Statistics/SessionRecorder.h"
 
 class PitchDetectionTesterAudioProcessor : public juce::AudioProcessor
 {
 public:
     PitchDetectionTesterAudioProcessor();
     ~PitchDetectionTesterAudioProcessor() override;
-
+    
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
+    
+    // Any number of inputs up to MAX_ANALYSIS_CHANNELS, passed straight through
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
-
+    
     const juce::String getName() const override;
-
+    
     bool acceptsMidi() const override;
     bool producesMidi() const override;
     bool isMidiEffect() const override;
     double getTailLengthSeconds() const override;
-
+    
     int getNumPrograms() override;
     int getCurrentProgram() override;
     void setCurrentProgram(int index) override;
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String& newName) override;
-
+    
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
-
-    // Pitch detection methods
+    
+    // Pitch detection methods (the switch is applied by the audio thread at the next block)
     void setPitchDetectionAlgorithm(int algorithmIndex);
-    int getCurrentAlgorithmIndex() const { return currentAlgorithmIndex; }
+    int getCurrentAlgorithmIndex() const { return requestedAlgorithmIndex.load(); }
+    
+    // Analysis hop (samples between overlapping frames), picked up by the audio thread
+    void setHopSize(int newHopSize);
+    int getHopSize() const { return requestedHopSize.load(); }
+    static juce::Array<int> getAvailableHopSizes() { return { 64, 128, 256, 512, 1024 }; }
+    
+    // Run pitch detection on the worker pool instead of inside processBlock
+    void setBackgroundAnalysisEnabled(bool shouldBeEnabled);
+    bool isBackgroundAnalysisEnabled() const { return backgroundAnalysisEnabled.load(); }
+    
+    // Rate the detectors run at after the anti-aliasing decimator
+    double getAnalysisSampleRate() const { return sampleRate / decimationFactor; }
+    int getDecimationFactor() const { return decimationFactor; }
+    
+    // Run every registered detector on the same frames, spread over the worker pool
+    void setComparisonModeEnabled(bool shouldBeEnabled);
+    bool isComparisonModeEnabled() const { return comparisonModeEnabled.load(); }
+    int getNumDetectors() const { return channelAnalyzers.front()->getNumDetectors(); }
+    
+    // Every input channel is analysed independently, with its own detectors,
+    // statistics and pipelines
+    int getNumAnalysisChannels() const { return numAnalysisChannels.load(); }
+    ChannelAnalyzer& getChannelAnalyzer(int channel) { return *channelAnalyzers[static_cast<size_t>(channel)]; }
+    const AnalysisWorkerPool& getWorkerPool() const { return workerPool; }
     
     // Statistics access
-    StatisticsManager& getStatisticsManager() { return statisticsManager; }
+    void requestStatisticsReset();
+    
+    // Log every measurement of every channel to a file, for replay with
+    // SessionLogReader (message thread; the audio thread only queues records)
+    juce::Result startSessionRecording(const juce::File& file);
+    void stopSessionRecording();
+    bool isSessionRecording() const { return sessionRecorder.isRecording(); }
+    const SessionRecorder& getSessionRecorder() const { return sessionRecorder; }
     
     // Algorithm names for UI
     juce::StringArray getAlgorithmNames() const;
+    
+    static constexpr int MAX_ANALYSIS_CHANNELS = 8;
 
 private:
     // Audio processing
     double sampleRate = 44100.0;
     int bufferSize = 512;
     
-    // Pitch detection
-    std::unique_ptr<PitchDetector> currentPitchDetector;
-    std::unique_ptr<YinPitchDetector> yinDetector;
-    std::unique_ptr<FFTPitchDetector> fftDetector;
-    int currentAlgorithmIndex = 0;
+    // Low-pass and downsample ahead of the detectors: the pitch range ends at
+    // 400 Hz, so anything much above a few kHz is wasted work
+    int decimationFactor = 1;
+    
+    // Settings picked up by the audio thread at the next block
+    std::atomic<int> requestedAlgorithmIndex { 0 };
+    std::atomic<int> requestedHopSize { DEFAULT_HOP_SIZE };
+    std::atomic<bool> backgroundAnalysisEnabled { false };
+    std::atomic<bool> comparisonModeEnabled { false };
+    
+    // Set between prepareToPlay and releaseResources (host thread), read by
+    // the UI's mode switches
+    std::atomic<bool> isPrepared { false };
+    
+    // Threads shared by every channel's pipelines (declared before the
+    // channels, which unregister from it when destroyed)
+    AnalysisWorkerPool workerPool;
     
-    // Statistics
-    StatisticsManager statisticsManager;
+    // Session log the analyzers feed (declared before them, so it outlives
+    // them)
+    SessionRecorder sessionRecorder;
     
-    // Audio buffer for analysis
-    juce::AudioBuffer<float> analysisBuffer;
-    int analysisBufferIndex = 0;
+    // One analyzer per possible input channel, created up front so the UI
+    // can hold on to their statistics; the first numAnalysisChannels are used
+    std::vector<std::unique_ptr<ChannelAnalyzer>> channelAnalyzers;
+    std::atomic<int> numAnalysisChannels { 1 };
     
     // Processing parameters
-    static constexpr int ANALYSIS_BUFFER_SIZE = 2048;
-    static constexpr float MIN_AMPLITUDE_THRESHOLD = 0.01f;
-
+    static constexpr int DEFAULT_HOP_SIZE = 256;        // ~5.8 ms at 44.1 kHz
+    static constexpr double MIN_ANALYSIS_SAMPLE_RATE = 4000.0;  // 10x the highest pitch
+    static constexpr int MIN_HOP_SIZE = 64;
+    static constexpr int MAX_HOP_SIZE = 1024;
+    
+    // Start or stop every channel's pipelines for these modes (message thread)
+    void updatePipelines(bool comparing, bool background);
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDetectionTesterAudioProcessor)
 }; 
\ No newline at end of file
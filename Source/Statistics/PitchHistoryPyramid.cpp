@@ -0,0 +1,146 @@
+#include "PitchHistoryPyramid.h"
+#include <algorithm>
+
+void PitchHistoryPyramid::prepare()
+{
+    // The size never changes, so preparing again only clears
+    if (!isPrepared())
+    {
+        for (auto& level : levels)
+        {
+            level.minimums.reset(new std::atomic<float>[LEVEL_CAPACITY]);
+            level.maximums.reset(new std::atomic<float>[LEVEL_CAPACITY]);
+        }
+    }
+    
+    clear();
+}
+
+void PitchHistoryPyramid::clear()
+{
+    for (auto& level : levels)
+    {
+        level.numBins.store(0, std::memory_order_release);
+        level.pending = Range();
+        level.numPending = 0;
+    }
+    
+    firstTimestamp.store(0, std::memory_order_relaxed);
+    newestTimestamp.store(0, std::memory_order_relaxed);
+}
+
+void PitchHistoryPyramid::push(float frequency, juce::int64 timestamp)
+{
+    if (!isPrepared())
+        return;
+    
+    if (levels[0].numBins.load(std::memory_order_relaxed) == 0)
+        firstTimestamp.store(timestamp, std::memory_order_relaxed);
+    newestTimestamp.store(timestamp, std::memory_order_relaxed);
+    
+    Range range;
+    if (frequency > 0.0f)
+        range = { frequency, frequency };
+    
+    // Complete a bin at each level until one only adds to a pending bin
+    for (int index = 0; index < NUM_LEVELS; ++index)
+    {
+        Level& level = levels[static_cast<size_t>(index)];
+        
+        // Step 1: Store the bin, then publish it
+        const juce::int64 numBins = level.numBins.load(std::memory_order_relaxed);
+        const auto slot = static_cast<size_t>(numBins % LEVEL_CAPACITY);
+        level.minimums[slot].store(range.minimum, std::memory_order_relaxed);
+        level.maximums[slot].store(range.maximum, std::memory_order_relaxed);
+        level.numBins.store(numBins + 1, std::memory_order_release);
+        
+        if (index + 1 == NUM_LEVELS)
+            break;
+        
+        // Step 2: Fold it into the next level's bin, which is complete every
+        // BRANCHING bins
+        Level& above = levels[static_cast<size_t>(index + 1)];
+        above.pending = merge(above.pending, range);
+        
+        if (++above.numPending < BRANCHING)
+            break;
+        
+        range = above.pending;
+        above.pending = Range();
+        above.numPending = 0;
+    }
+}
+
+double PitchHistoryPyramid::getDurationSeconds() const
+{
+    return juce::Time::highResolutionTicksToSeconds(newestTimestamp.load(std::memory_order_relaxed)
+                                                    - firstTimestamp.load(std::memory_order_relaxed));
+}
+
+juce::int64 PitchHistoryPyramid::render(Range* columns, int numColumns) const
+{
+    const juce::int64 numFrames = getNumFrames();
+    numColumns = std::min(numColumns, MAX_COLUMNS);
+    
+    if (!isPrepared() || numFrames == 0 || numColumns <= 0)
+        return 0;
+    
+    // Step 1: Coarsest level whose bins still fit in a column, so each column
+    // merges fewer than BRANCHING bins (more only once the top level is reached)
+    const double framesPerColumn = static_cast<double>(numFrames) / numColumns;
+    int levelIndex = 0;
+    while (levelIndex + 1 < NUM_LEVELS && static_cast<double>(getBinSize(levelIndex + 1)) <= framesPerColumn)
+        ++levelIndex;
+    
+    const Level& level = levels[static_cast<size_t>(levelIndex)];
+    const juce::int64 numBins = level.numBins.load(std::memory_order_acquire);
+    const juce::int64 firstBin = std::max<juce::int64>(0, numBins - (LEVEL_CAPACITY - MAX_COLUMNS * BRANCHING));
+    const juce::int64 numBinsShown = numBins - firstBin;
+    
+    if (numBinsShown <= 0)
+        return 0;
+    
+    // Step 2: Merge each column's bins; with fewer bins than columns, a bin
+    // spreads over several columns
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const juce::int64 begin = firstBin + numBinsShown * column / numColumns;
+        const juce::int64 end = std::max(begin + 1, firstBin + numBinsShown * (column + 1) / numColumns);
+        
+        Range range;
+        for (juce::int64 bin = begin; bin < end; ++bin)
+        {
+            const auto slot = static_cast<size_t>(bin % LEVEL_CAPACITY);
+            range = merge(range, { level.minimums[slot].load(std::memory_order_relaxed),
+                                   level.maximums[slot].load(std::memory_order_relaxed) });
+        }
+        
+        columns[column] = range;
+    }
+    
+    // Step 3: Discard the read if the writer cleared the history or wrapped
+    // round onto the bins it covered
+    const juce::int64 numBinsAfter = level.numBins.load(std::memory_order_acquire);
+    if (numBinsAfter < numBins || numBinsAfter - firstBin > LEVEL_CAPACITY)
+        return 0;
+    
+    return numBinsShown * getBinSize(levelIndex);
+}
+
+juce::int64 PitchHistoryPyramid::getBinSize(int level)
+{
+    juce::int64 size = 1;
+    for (int i = 0; i < level; ++i)
+        size *= BRANCHING;
+    return size;
+}
+
+PitchHistoryPyramid::Range PitchHistoryPyramid::merge(const Range& a, const Range& b)
+{
+    if (!a.hasPitch())
+        return b;
+    if (!b.hasPitch())
+        return a;
+    
+    return { std::min(a.minimum, b.minimum), std::max(a.maximum, b.maximum) };
+}
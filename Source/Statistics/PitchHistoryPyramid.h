@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// Min/max pyramid over every analysed frame since the last clear, so a plot
+// of a whole session costs time proportional to its width rather than to
+// the session's length.
+//
+// Level 0 keeps the newest LEVEL_CAPACITY frames; each level above keeps the
+// newest LEVEL_CAPACITY bins of BRANCHING bins of the level below, so the
+// top level reaches back hundreds of hours. The writer (the measuring
+// thread) folds each frame in at amortised constant cost without
+// allocating; a reader (the UI) renders straight from the levels, without
+// copying them or blocking the writer, and detects when the writer overtook
+// what it was reading.
+class PitchHistoryPyramid
+{
+public:
+    PitchHistoryPyramid() = default;
+    
+    // Lowest and highest pitch in a stretch of frames (both 0 when none had one)
+    struct Range
+    {
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        
+        bool hasPitch() const { return maximum > 0.0f; }
+    };
+    
+    // Allocate the levels and clear (not real-time safe)
+    void prepare();
+    bool isPrepared() const { return levels[0].minimums != nullptr; }
+    
+    // Writer: forget every frame
+    void clear();
+    
+    // Writer: add one frame's pitch (0 for a frame without one), measured at
+    // timestamp (juce::Time high-resolution ticks)
+    void push(float frequency, juce::int64 timestamp);
+    
+    // Any thread: frames added, and the time from the first to the newest
+    juce::int64 getNumFrames() const { return levels[0].numBins.load(std::memory_order_acquire); }
+    double getDurationSeconds() const;
+    
+    // Reader: split the history into numColumns columns (at most MAX_COLUMNS),
+    // oldest first, and write each column's range. Returns how many frames the
+    // columns cover (the whole session, short of the coarse level's unfinished
+    // bin, or the newest part the top level still keeps), or 0 when there is
+    // nothing to draw or the writer overwrote bins during the read.
+    juce::int64 render(Range* columns, int numColumns) const;
+    
+    static constexpr int BRANCHING = 4;
+    static constexpr int LEVEL_CAPACITY = 8192;     // Bins per level
+    static constexpr int NUM_LEVELS = 8;            // Top bins span 4^7 frames
+    static constexpr int MAX_COLUMNS = LEVEL_CAPACITY / (2 * BRANCHING);   // Leaves half of a level as slack for the writer
+
+private:
+    struct Level
+    {
+        // Completed bins, written once each; bin i is at i % LEVEL_CAPACITY
+        std::unique_ptr<std::atomic<float>[]> minimums;
+        std::unique_ptr<std::atomic<float>[]> maximums;
+        std::atomic<juce::int64> numBins { 0 };
+        
+        // Writer: bin being filled from the level below
+        Range pending;
+        int numPending = 0;
+    };
+    
+    std::array<Level, NUM_LEVELS> levels;
+    std::atomic<juce::int64> firstTimestamp { 0 };
+    std::atomic<juce::int64> newestTimestamp { 0 };
+    
+    static juce::int64 getBinSize(int level);
+    static Range merge(const Range& a, const Range& b);
+    
+    JUCE_DECLARE_NON_COPYABLE(PitchHistoryPyramid)
+};
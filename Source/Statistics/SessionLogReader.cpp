@@ -0,0 +1,129 @@
+#include "SessionLogReader.h"
+#include <algorithm>
+#include <cstring>
+
+SessionLogReader::SessionLogReader(const juce::File& file)
+{
+    auto newMapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (newMapping->getData() == nullptr || newMapping->getSize() < sizeof(SessionLogHeader))
+        return;
+    
+    // Step 1: Check the header
+    SessionLogHeader header;
+    std::memcpy(&header, newMapping->getData(), sizeof(header));
+    
+    const SessionLogHeader expected;
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0
+        || header.version != expected.version
+        || header.recordSize != expected.recordSize
+        || header.ticksPerSecond <= 0)
+        return;
+    
+    // Step 2: Only records the file really holds (a log cut off mid-write
+    // can claim more)
+    const auto capacity = static_cast<juce::int64>((newMapping->getSize() - sizeof(SessionLogHeader)) / sizeof(SessionLogRecord));
+    numRecords = juce::jlimit<juce::int64>(0, capacity, header.numRecords);
+    ticksPerSecond = static_cast<double>(header.ticksPerSecond);
+    
+    mapping = std::move(newMapping);
+    records = reinterpret_cast<const SessionLogRecord*>(static_cast<const char*>(mapping->getData()) + sizeof(SessionLogHeader));
+}
+
+juce::int64 SessionLogReader::findRecordAt(juce::int64 timestamp) const
+{
+    // Records are in the order they were measured, so timestamps only rise
+    const SessionLogRecord* found = std::lower_bound(records, records + numRecords, timestamp,
+                                                     [](const SessionLogRecord& record, juce::int64 time)
+                                                     {
+                                                         return record.timestamp < time;
+                                                     });
+    return found - records;
+}
+
+double SessionLogReader::getSecondsSinceStart(juce::int64 index) const
+{
+    if (numRecords == 0)
+        return 0.0;
+    
+    return static_cast<double>(records[index].timestamp - records[0].timestamp) / ticksPerSecond;
+}
+
+void SessionLogReader::replay(StatisticsManager& statistics, juce::int64 begin, juce::int64 end, int channel) const
+{
+    statistics.reset();
+    
+    begin = juce::jlimit<juce::int64>(0, numRecords, begin);
+    end = juce::jlimit<juce::int64>(begin, numRecords, end);
+    int algorithmIndex = -1;
+    
+    for (juce::int64 i = begin; i < end; ++i)
+    {
+        const SessionLogRecord& record = records[i];
+        if (record.channel != channel)
+            continue;
+        
+        // Statistics were reset from the UI or when the algorithm changed
+        if (record.isReset() || (algorithmIndex >= 0 && record.algorithmIndex != algorithmIndex))
+            statistics.reset();
+        algorithmIndex = record.algorithmIndex;
+        
+        if (record.isReset())
+            continue;
+        
+        // The same calls ChannelAnalyzer made for the frame
+        const juce::int64 timestamp = toLocalTicks(record.timestamp);
+        
+        if (!record.wasAnalysed())
+        {
+            statistics.addUnpitchedFrame(timestamp);
+            continue;
+        }
+        
+        statistics.addComputeTime(record.computeTimeMs);
+        
+        if (record.frequency > 0.0f)
+            statistics.addPitchMeasurement(record.frequency, record.amplitude, timestamp);
+        else
+            statistics.addUnpitchedFrame(timestamp);
+    }
+}
+
+void SessionLogReader::scrubTo(StatisticsManager& statistics, juce::int64 index, int channel) const
+{
+    const juce::int64 end = juce::jlimit<juce::int64>(0, numRecords, index + 1);
+    
+    // Step 1: Walk back until the pitch window is full, or to the last
+    // reset or algorithm change
+    juce::int64 begin = end;
+    int algorithmIndex = -1;
+    int numPitches = 0;
+    
+    while (begin > 0 && numPitches < StatisticsManager::getHistoryCapacity())
+    {
+        const SessionLogRecord& record = records[begin - 1];
+        
+        if (record.channel == channel)
+        {
+            if (record.isReset() || (algorithmIndex >= 0 && record.algorithmIndex != algorithmIndex))
+                break;
+            algorithmIndex = record.algorithmIndex;
+            
+            if (record.wasAnalysed() && record.frequency > 0.0f)
+                numPitches++;
+        }
+        
+        begin--;
+    }
+    
+    // Step 2: Replay that stretch
+    replay(statistics, begin, end, channel);
+}
+
+juce::int64 SessionLogReader::toLocalTicks(juce::int64 timestamp) const
+{
+    const auto localTicksPerSecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    if (localTicksPerSecond == ticksPerSecond)
+        return timestamp;
+    
+    return static_cast<juce::int64>(static_cast<double>(timestamp) * localTicksPerSecond / ticksPerSecond);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "SessionRecorder.h"
+#include "StatisticsManager.h"
+#include <memory>
+
+// Reads a log written by SessionRecorder, in place through a read-only
+// memory mapping, and replays stretches of it into a StatisticsManager as if
+// the frames were arriving live. A log that is still being recorded reads up
+// to the records its header counted when it was opened.
+class SessionLogReader
+{
+public:
+    explicit SessionLogReader(const juce::File& file);
+    
+    // False if the file is missing or isn't a session log of this version
+    bool isValid() const { return mapping != nullptr; }
+    
+    juce::int64 getNumRecords() const { return numRecords; }
+    const SessionLogRecord& getRecord(juce::int64 index) const { return records[index]; }
+    
+    // Index of the first record measured at or after timestamp (recording
+    // machine ticks), or getNumRecords() if there is none
+    juce::int64 findRecordAt(juce::int64 timestamp) const;
+    
+    // Time from the first record, in seconds
+    double getSecondsSinceStart(juce::int64 index) const;
+    double getDurationSeconds() const { return numRecords > 0 ? getSecondsSinceStart(numRecords - 1) : 0.0; }
+    
+    // Reset statistics, then feed them the records [begin, end) of one input
+    // channel in order, with their recorded timestamps. Reset records (and,
+    // in logs that predate them, a change of algorithm) reset them again, as
+    // happened live. Call from the thread that owns the statistics (not the
+    // audio thread).
+    void replay(StatisticsManager& statistics, juce::int64 begin, juce::int64 end, int channel) const;
+    
+    // Statistics as they stood when the record at index arrived (included),
+    // without replaying the whole session: only the stretch the windowed
+    // statistics reach back over (StatisticsManager::getHistoryCapacity()
+    // pitches, back to the last reset or algorithm change) is replayed, so
+    // counters and the session history cover that stretch alone
+    void scrubTo(StatisticsManager& statistics, juce::int64 index, int channel) const;
+
+private:
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    const SessionLogRecord* records = nullptr;
+    juce::int64 numRecords = 0;
+    double ticksPerSecond = 1.0;
+    
+    // Recorded timestamp in this machine's high-resolution ticks
+    juce::int64 toLocalTicks(juce::int64 timestamp) const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionLogReader)
+};
@@ -0,0 +1,206 @@
+#include "SessionRecorder.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+SessionRecorder::SessionRecorder()
+    : juce::Thread("Session Recorder"),
+      slots(static_cast<size_t>(QUEUE_CAPACITY + 1))
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+juce::Result SessionRecorder::start(const juce::File& newFile)
+{
+    stop();
+    
+    // Step 1: Discard what the audio thread queued after the last stop()
+    fifo.finishedRead(fifo.getNumReady());
+    numRecordsWritten.store(0);
+    droppedRecords.store(0);
+    
+    // Step 2: Create the file and map its first stretch
+    file = newFile;
+    if (!file.deleteFile() || !file.create())
+        return juce::Result::fail("Can't create " + file.getFullPathName());
+    
+    if (!ensureCapacity(0))
+    {
+        unmapFile();
+        return juce::Result::fail("Can't map " + file.getFullPathName());
+    }
+    
+    SessionLogHeader* header = new (getHeader()) SessionLogHeader();
+    header->ticksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+    
+    // Step 3: Let the audio thread in
+    recording.store(true, std::memory_order_release);
+    startThread();
+    return juce::Result::ok();
+}
+
+void SessionRecorder::stop()
+{
+    if (!isRecording())
+        return;
+    
+    // Step 1: The audio thread stops queueing; the writer finishes its pass
+    recording.store(false, std::memory_order_release);
+    stopThread(1000);
+    
+    // Step 2: Write what's left, then cut the file down to the records
+    writeQueuedRecords();
+    unmapFile();
+    
+    juce::FileOutputStream stream(file);
+    if (stream.openedOk())
+    {
+        stream.setPosition(static_cast<juce::int64>(sizeof(SessionLogHeader))
+                           + getNumRecordsWritten() * static_cast<juce::int64>(sizeof(SessionLogRecord)));
+        stream.truncate();
+    }
+}
+
+bool SessionRecorder::addMeasurement(const PitchMeasurement& measurement, int channel, int algorithmIndex, bool wasAnalysed)
+{
+    if (!isRecording())
+        return true;
+    
+    SessionLogRecord record;
+    record.timestamp = measurement.timestamp;
+    record.frequency = measurement.frequency;
+    record.amplitude = measurement.amplitude;
+    record.confidence = measurement.confidence;
+    record.computeTimeMs = measurement.computeTimeMs;
+    record.channel = static_cast<juce::uint16>(channel);
+    record.algorithmIndex = static_cast<juce::uint8>(algorithmIndex);
+    record.flags = wasAnalysed ? SessionLogRecord::ANALYSED : 0;
+    return queueRecord(record);
+}
+
+bool SessionRecorder::addReset(int channel, int algorithmIndex, juce::int64 timestamp)
+{
+    if (!isRecording())
+        return true;
+    
+    SessionLogRecord record;
+    record.timestamp = timestamp;
+    record.channel = static_cast<juce::uint16>(channel);
+    record.algorithmIndex = static_cast<juce::uint8>(algorithmIndex);
+    record.flags = SessionLogRecord::RESET;
+    return queueRecord(record);
+}
+
+bool SessionRecorder::queueRecord(const SessionLogRecord& record)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    
+    if (size1 == 0)
+    {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    slots[static_cast<size_t>(start1)] = record;
+    fifo.finishedWrite(1);
+    
+    return true;
+}
+
+void SessionRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        writeQueuedRecords();
+        wait(WRITE_INTERVAL_MS);
+    }
+}
+
+void SessionRecorder::writeQueuedRecords()
+{
+    const int numReady = fifo.getNumReady();
+    if (numReady == 0)
+        return;
+    
+    // Records the file can't take (the disk is full, or it couldn't be
+    // mapped again) are dropped like those the queue can't
+    juce::int64 numRecords = getNumRecordsWritten();
+    if (!ensureCapacity(numRecords + numReady))
+    {
+        fifo.finishedRead(numReady);
+        droppedRecords.fetch_add(numReady, std::memory_order_relaxed);
+        return;
+    }
+    
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+    
+    auto* records = reinterpret_cast<SessionLogRecord*>(getHeader() + 1);
+    std::memcpy(records + numRecords, slots.data() + start1, static_cast<size_t>(size1) * sizeof(SessionLogRecord));
+    std::memcpy(records + numRecords + size1, slots.data() + start2, static_cast<size_t>(size2) * sizeof(SessionLogRecord));
+    fifo.finishedRead(size1 + size2);
+    
+    // The header's count only covers records already in place
+    numRecords += size1 + size2;
+    getHeader()->numRecords = numRecords;
+    numRecordsWritten.store(numRecords, std::memory_order_relaxed);
+}
+
+bool SessionRecorder::ensureCapacity(juce::int64 numRecords)
+{
+    const auto requiredSize = static_cast<juce::int64>(sizeof(SessionLogHeader))
+                            + numRecords * static_cast<juce::int64>(sizeof(SessionLogRecord));
+    
+    if (mapping != nullptr && requiredSize <= mappedSize)
+        return true;
+    
+    juce::int64 newSize = std::max(mappedSize, INITIAL_FILE_SIZE);
+    while (newSize < requiredSize)
+        newSize *= 2;
+    
+    return mapFile(newSize);
+}
+
+bool SessionRecorder::mapFile(juce::int64 size)
+{
+    // Step 1: Release the old mapping (its pages are already in the file)
+    unmapFile();
+    
+    // Step 2: Grow the file by writing its last byte
+    if (file.getSize() < size)
+    {
+        juce::FileOutputStream stream(file);
+        if (!stream.openedOk() || !stream.setPosition(size - 1) || !stream.writeByte(0))
+            return false;
+        
+        stream.flush();
+        if (stream.getStatus().failed())
+            return false;
+    }
+    
+    // Step 3: Map the whole file again
+    auto newMapping = std::make_unique<juce::MemoryMappedFile>(file, juce::Range<juce::int64>(0, size),
+                                                               juce::MemoryMappedFile::readWrite);
+    if (newMapping->getData() == nullptr || static_cast<juce::int64>(newMapping->getSize()) < size)
+        return false;
+    
+    mapping = std::move(newMapping);
+    mappedSize = size;
+    return true;
+}
+
+void SessionRecorder::unmapFile()
+{
+    mapping.reset();
+    mappedSize = 0;
+}
+
+SessionLogHeader* SessionRecorder::getHeader() const
+{
+    return static_cast<SessionLogHeader*>(mapping->getData());
+}
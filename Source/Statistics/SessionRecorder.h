@@ -0,0 +1,116 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "StatisticsManager.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// One analysed frame in a session log: what the selected detector measured,
+// as it was fed to the main statistics. A record flagged RESET marks where
+// those statistics were reset instead, and carries no measurement.
+struct SessionLogRecord
+{
+    juce::int64 timestamp = 0;      // juce::Time high-resolution ticks of the recording machine
+    float frequency = 0.0f;         // 0 if no pitch was found
+    float amplitude = 0.0f;         // Frame RMS
+    float confidence = 0.0f;
+    float computeTimeMs = 0.0f;
+    juce::uint16 channel = 0;
+    juce::uint8 algorithmIndex = 0;
+    juce::uint8 flags = 0;
+    juce::uint32 reserved = 0;
+    
+    enum Flags : juce::uint8
+    {
+        ANALYSED = 1,   // A detector ran (clear for frames under the RMS gate)
+        RESET = 2       // The statistics were reset (from the UI, or for a new algorithm)
+    };
+    
+    bool wasAnalysed() const { return (flags & ANALYSED) != 0; }
+    bool isReset() const { return (flags & RESET) != 0; }
+};
+
+// Start of a session log file, followed by numRecords SessionLogRecords in
+// the order they were measured. Both are stored in the machine's native
+// byte order.
+struct SessionLogHeader
+{
+    char magic[4] = { 'P', 'D', 'T', 'L' };
+    juce::uint32 version = 1;
+    juce::uint32 recordSize = sizeof(SessionLogRecord);
+    juce::uint32 reserved = 0;
+    juce::int64 ticksPerSecond = 0;     // Of the timestamps
+    juce::int64 numRecords = 0;         // Kept current while recording, so a cut-off log still reads
+};
+
+static_assert(sizeof(SessionLogRecord) == 32, "The log format depends on the record layout");
+static_assert(sizeof(SessionLogHeader) == 32, "The log format depends on the header layout");
+
+// Writes every measurement of a session to a log file, however long it runs.
+//
+// The audio thread copies each measurement into a pre-allocated single-
+// producer / single-consumer queue (wait-free; a full queue drops the record
+// and counts it) and never touches the file. A background thread moves the
+// queued records every WRITE_INTERVAL_MS into a memory-mapped region of the
+// file, which doubles in size when it fills up, and keeps the header's
+// record count current. stop() trims the file to the records written.
+// SessionLogReader replays a log into a StatisticsManager.
+class SessionRecorder : private juce::Thread
+{
+public:
+    SessionRecorder();
+    ~SessionRecorder() override;
+    
+    // Message thread: start a new log in file (replacing it), or finish the
+    // current one. start() stops any recording first.
+    juce::Result start(const juce::File& file);
+    void stop();
+    bool isRecording() const { return recording.load(std::memory_order_acquire); }
+    
+    // Audio thread: queue one measurement (ignored unless recording). Returns
+    // false if the queue was full and the record had to be dropped.
+    bool addMeasurement(const PitchMeasurement& measurement, int channel, int algorithmIndex, bool wasAnalysed);
+    
+    // Audio thread: queue a reset of the channel's statistics, in the same
+    // order as its measurements
+    bool addReset(int channel, int algorithmIndex, juce::int64 timestamp);
+    
+    // Any thread: the current or last log
+    juce::int64 getNumRecordsWritten() const { return numRecordsWritten.load(std::memory_order_relaxed); }
+    int getDroppedRecords() const { return droppedRecords.load(std::memory_order_relaxed); }
+    juce::File getFile() const { return file; }
+    
+    static constexpr int QUEUE_CAPACITY = 16384;            // Records (~3 s at a 64-sample hop and 8 channels)
+    static constexpr int WRITE_INTERVAL_MS = 20;
+    static constexpr juce::int64 INITIAL_FILE_SIZE = 1 << 20;
+
+private:
+    void run() override;
+    
+    // Audio thread: copy record into the queue, or count it as dropped
+    bool queueRecord(const SessionLogRecord& record);
+    
+    // Writer thread (or stop() once it has finished): move queued records
+    // into the mapping
+    void writeQueuedRecords();
+    bool ensureCapacity(juce::int64 numRecords);
+    bool mapFile(juce::int64 size);
+    void unmapFile();
+    SessionLogHeader* getHeader() const;
+    
+    // Records: audio thread -> writer
+    juce::AbstractFifo fifo { QUEUE_CAPACITY + 1 };
+    std::vector<SessionLogRecord> slots;
+    
+    std::atomic<bool> recording { false };
+    std::atomic<juce::int64> numRecordsWritten { 0 };
+    std::atomic<int> droppedRecords { 0 };
+    
+    // Writer
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    juce::int64 mappedSize = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionRecorder)
+};
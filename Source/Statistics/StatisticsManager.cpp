@@ -1,51 +1,180 @@
 #include "StatisticsManager.h"
 #include <cmath>
 #include <algorithm>
-#include <numeric>
 
 StatisticsManager::StatisticsManager()
 {
+    prepare();
+}
+
+void StatisticsManager::prepare()
+{
+    recentMeasurements.prepare(STABILITY_WINDOW);
+    pitchHistory.prepare(MAX_HISTORY_SIZE);
     reset();
 }
 
+void StatisticsManager::prepareSessionHistory()
+{
+    sessionHistory.prepare();
+}
+
 void StatisticsManager::addPitchMeasurement(float frequency, float amplitude)
 {
+    addPitchMeasurement(frequency, amplitude, juce::Time::getHighResolutionTicks());
+}
+
+void StatisticsManager::addPitchMeasurement(float frequency, float amplitude, juce::int64 currentTime)
+{
+    handlePendingReset();
+    
     totalDetections++;
     currentPitch = frequency;
     currentAmplitude = amplitude;
-
-    juce::int64 currentTime = juce::Time::getHighResolutionTicks();
     
     if (isValidFrequency(frequency))
     {
         validDetections++;
         
         // Add to recent measurements for stability/confidence/response time calculations
-        recentMeasurements.emplace_back(frequency, amplitude, currentTime);
-        if (recentMeasurements.size() > STABILITY_WINDOW)
-        {
-            recentMeasurements.pop_front();
-        }
+        addToRecentMeasurements(PitchMeasurement(frequency, amplitude, currentTime));
     }
     else
     {
         // Add a "zero" frequency to indicate no valid pitch
-        recentMeasurements.emplace_back(0.0f, amplitude, currentTime);
-        if (recentMeasurements.size() > STABILITY_WINDOW)
+        addToRecentMeasurements(PitchMeasurement(0.0f, amplitude, currentTime));
+    }
+
+    // Add to pitch history for long-term average/plotting
+    addToHistory(frequency);
+    sessionHistory.push(isValidFrequency(frequency) ? frequency : 0.0f, currentTime);
+    
+    updateStatistics();
+    lastTimestamp = currentTime;
+    
+    publishSnapshot();
+}
+
+void StatisticsManager::addUnpitchedFrame()
+{
+    addUnpitchedFrame(juce::Time::getHighResolutionTicks());
+}
+
+void StatisticsManager::addUnpitchedFrame(juce::int64 timestamp)
+{
+    handlePendingReset();
+    
+    sessionHistory.push(0.0f, timestamp);
+}
+
+void StatisticsManager::addComputeTime(float milliseconds)
+{
+    handlePendingReset();
+    
+    computeTimeSum += milliseconds;
+    computeFrames++;
+    maxComputeTime = std::max(maxComputeTime, milliseconds);
+}
+
+void StatisticsManager::addFrameCost(juce::uint64 timestamps)
+{
+    handlePendingReset();
+    
+    frameCosts.add(timestamps);
+}
+
+void StatisticsManager::addBlockCost(juce::uint64 timestamps, juce::uint64 budgetTimestamps)
+{
+    handlePendingReset();
+    
+    if (budgetTimestamps > 0)
+        blockLoads.add(static_cast<juce::uint64>(static_cast<double>(timestamps) * BLOCK_LOAD_SCALE
+                                                 / static_cast<double>(budgetTimestamps)));
+}
+
+void StatisticsManager::addToHistory(float frequency)
+{
+    // Step 1: Retire the oldest entry from the running sum before it is overwritten
+    if (pitchHistory.isFull() && isValidFrequency(pitchHistory.oldest()))
+    {
+        historyValidSum -= pitchHistory.oldest();
+        historyValidCount--;
+    }
+    
+    // Step 2: Add the new entry
+    pitchHistory.push(frequency);
+    
+    if (isValidFrequency(frequency))
+    {
+        historyValidSum += frequency;
+        historyValidCount++;
+    }
+}
+
+void StatisticsManager::addToRecentMeasurements(const PitchMeasurement& measurement)
+{
+    bool isValid = isValidFrequency(measurement.frequency);
+    
+    // Step 1: Retire the oldest measurement and the interval that follows it
+    if (recentMeasurements.isFull())
+    {
+        const PitchMeasurement& oldest = recentMeasurements.oldest();
+        
+        if (isValidFrequency(oldest.frequency))
         {
-            recentMeasurements.pop_front();
+            removeStabilitySample(oldest.frequency);
+            
+            const PitchMeasurement& next = recentMeasurements[1];
+            if (isValidFrequency(next.frequency))
+            {
+                intervalTickSum -= next.timestamp - oldest.timestamp;
+                intervalCount--;
+            }
         }
     }
+    
+    // Step 2: Add the interval from the newest measurement to this one
+    if (isValid && !recentMeasurements.empty())
+    {
+        const PitchMeasurement& newest = recentMeasurements.newest();
+        if (isValidFrequency(newest.frequency))
+        {
+            intervalTickSum += measurement.timestamp - newest.timestamp;
+            intervalCount++;
+        }
+    }
+    
+    // Step 3: Store the measurement
+    recentMeasurements.push(measurement);
+    
+    if (isValid)
+        addStabilitySample(measurement.frequency);
+}
 
-    // Add to pitch history for long-term average/plotting
-    pitchHistory.push_back(frequency);
-    if (pitchHistory.size() > MAX_HISTORY_SIZE)
+void StatisticsManager::addStabilitySample(double frequency)
+{
+    // Welford update
+    stabilityCount++;
+    double delta = frequency - stabilityMean;
+    stabilityMean += delta / stabilityCount;
+    stabilityM2 += delta * (frequency - stabilityMean);
+}
+
+void StatisticsManager::removeStabilitySample(double frequency)
+{
+    // Inverse Welford update
+    if (stabilityCount <= 1)
     {
-        pitchHistory.erase(pitchHistory.begin());
+        stabilityCount = 0;
+        stabilityMean = 0.0;
+        stabilityM2 = 0.0;
+        return;
     }
     
-    updateStatistics();
-    lastTimestamp = currentTime;
+    double previousMean = (stabilityCount * stabilityMean - frequency) / (stabilityCount - 1);
+    stabilityM2 = std::max(0.0, stabilityM2 - (frequency - stabilityMean) * (frequency - previousMean));
+    stabilityMean = previousMean;
+    stabilityCount--;
 }
 
 void StatisticsManager::reset()
@@ -56,17 +185,50 @@ void StatisticsManager::reset()
     pitchStability = 0.0f;
     detectionConfidence = 0.0f;
     responseTime = 0.0f;
+    computeTimeSum = 0.0;
+    computeFrames = 0;
+    maxComputeTime = 0.0f;
+    frameCosts.clear();
+    blockLoads.clear();
     totalDetections = 0;
     validDetections = 0;
     lastTimestamp = 0;
     
     recentMeasurements.clear();
     pitchHistory.clear();
+    sessionHistory.clear();
+    historyValidSum = 0.0;
+    historyValidCount = 0;
+    stabilityMean = 0.0;
+    stabilityM2 = 0.0;
+    stabilityCount = 0;
+    intervalTickSum = 0;
+    intervalCount = 0;
+    
+    resetRequested.store(false);
+    publishSnapshot();
+}
+
+void StatisticsManager::handlePendingReset()
+{
+    if (resetRequested.exchange(false))
+        reset();
 }
 
-std::vector<float> StatisticsManager::getPitchHistory() const
+void StatisticsManager::publishSnapshot()
 {
-    return pitchHistory;
+    StatisticsSnapshot& snapshot = snapshotBuffer.getWriteBuffer();
+    snapshot.currentPitch = currentPitch;
+    snapshot.currentAmplitude = currentAmplitude;
+    snapshot.averagePitch = averagePitch;
+    snapshot.pitchStability = pitchStability;
+    snapshot.detectionConfidence = detectionConfidence;
+    snapshot.responseTime = responseTime;
+    snapshot.averageComputeTime = getAverageComputeTime();
+    snapshot.maxComputeTime = maxComputeTime;
+    snapshot.totalDetections = totalDetections;
+    snapshot.validDetections = validDetections;
+    snapshotBuffer.publish();
 }
 
 juce::String StatisticsManager::getCurrentNote() const
@@ -85,19 +247,7 @@ void StatisticsManager::updateStatistics()
         return;
     
     // Calculate average pitch (only valid frequencies)
-    float sum = 0.0f;
-    int count = 0;
-    
-    for (float pitch : pitchHistory)
-    {
-        if (isValidFrequency(pitch))
-        {
-            sum += pitch;
-            count++;
-        }
-    }
-    
-    averagePitch = (count > 0) ? sum / count : 0.0f;
+    averagePitch = (historyValidCount > 0) ? static_cast<float>(historyValidSum / historyValidCount) : 0.0f;
     
     // Calculate other statistics
     pitchStability = calculatePitchStability();
@@ -107,33 +257,12 @@ void StatisticsManager::updateStatistics()
 
 float StatisticsManager::calculatePitchStability() const
 {
-    if (pitchHistory.size() < 2)
+    if (recentMeasurements.size() < 2 || stabilityCount < 2)
         return 0.0f;
     
-    // Calculate standard deviation of recent pitches
-    float sum = 0.0f;
-    float sumSquared = 0.0f;
-    int count = 0;
-    
-    int startIndex = std::max(0, static_cast<int>(pitchHistory.size()) - STABILITY_WINDOW);
-    
-    for (int i = startIndex; i < static_cast<int>(pitchHistory.size()); ++i)
-    {
-        float pitch = pitchHistory[i];
-        if (isValidFrequency(pitch))
-        {
-            sum += pitch;
-            sumSquared += pitch * pitch;
-            count++;
-        }
-    }
-    
-    if (count < 2)
-        return 0.0f;
-    
-    float mean = sum / count;
-    float variance = (sumSquared / count) - (mean * mean);
-    float stdDev = std::sqrt(std::max(0.0f, variance));
+    // Standard deviation of recent valid pitches
+    double variance = stabilityM2 / stabilityCount;
+    float stdDev = static_cast<float>(std::sqrt(std::max(0.0, variance)));
     
     // Convert to stability score (0-1, higher is more stable)
     float stability = std::max(0.0f, 1.0f - (stdDev / 50.0f)); // 50 Hz as reference
@@ -154,35 +283,17 @@ float StatisticsManager::calculateDetectionConfidence() const
 
 float StatisticsManager::calculateResponseTime() const
 {
-    if (recentMeasurements.size() < 2)
-    {
-        return 0.0f;
-    }
-    
-    juce::int64 timeDiffSum = 0;
-    int count = 0;
-
-    for (size_t i = 1; i < recentMeasurements.size(); ++i)
-    {
-        // Only measure time between consecutive valid detections
-        if (isValidFrequency(recentMeasurements[i].frequency) && isValidFrequency(recentMeasurements[i - 1].frequency))
-        {
-            juce::int64 timeDiff = recentMeasurements[i].timestamp - recentMeasurements[i - 1].timestamp;
-            timeDiffSum += timeDiff;
-            count++;
-        }
-    }
-    
-    if (count == 0)
+    // Only measures time between consecutive valid detections
+    if (intervalCount == 0)
     {
         return 0.0f;
     }
     
-    double averageTimeDiffTicks = static_cast<double>(timeDiffSum) / count;
+    double averageTimeDiffTicks = static_cast<double>(intervalTickSum) / intervalCount;
     return static_cast<float>(averageTimeDiffTicks * 1000.0 / juce::Time::getHighResolutionTicksPerSecond());
 }
 
-juce::String StatisticsManager::frequencyToNote(float frequency) const
+juce::String StatisticsManager::frequencyToNote(float frequency)
 {
     if (!isValidFrequency(frequency))
         return "---";
@@ -205,7 +316,7 @@ juce::String StatisticsManager::frequencyToNote(float frequency) const
     return juce::String(noteNames[noteIndex]) + juce::String(octave);
 }
 
-bool StatisticsManager::isValidFrequency(float frequency) const
+bool StatisticsManager::isValidFrequency(float frequency)
 {
     return frequency >= MIN_VALID_FREQUENCY && frequency <= MAX_VALID_FREQUENCY;
 } 
\ No newline at end of file
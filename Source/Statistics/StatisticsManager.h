@@ -1,17 +1,39 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "../Utilities/TripleBuffer.h"
+#include "../Utilities/FixedRingBuffer.h"
+#include "../Utilities/CostHistogram.h"
+#include "PitchHistoryPyramid.h"
+#include <atomic>
 #include <vector>
-#include <deque>
 
 struct PitchMeasurement
 {
-    float frequency;
-    float amplitude;
-    juce::int64 timestamp;
+    float frequency = 0.0f;
+    float amplitude = 0.0f;
+    juce::int64 timestamp = 0;
+    float confidence = 0.0f;
+    float computeTimeMs = 0.0f;
     
-    PitchMeasurement(float freq, float amp, juce::int64 time)
-        : frequency(freq), amplitude(amp), timestamp(time) {}
+    PitchMeasurement() = default;
+    PitchMeasurement(float freq, float amp, juce::int64 time, float conf = 0.0f, float computeTime = 0.0f)
+        : frequency(freq), amplitude(amp), timestamp(time), confidence(conf), computeTimeMs(computeTime) {}
+};
+
+// Consistent set of statistics published for the UI
+struct StatisticsSnapshot
+{
+    float currentPitch = 0.0f;
+    float currentAmplitude = 0.0f;
+    float averagePitch = 0.0f;
+    float pitchStability = 0.0f;
+    float detectionConfidence = 0.0f;
+    float responseTime = 0.0f;
+    float averageComputeTime = 0.0f;    // ms per analysed frame
+    float maxComputeTime = 0.0f;
+    int totalDetections = 0;
+    int validDetections = 0;
 };
 
 class StatisticsManager
@@ -20,31 +42,76 @@ public:
     StatisticsManager();
     ~StatisticsManager() = default;
     
-    // Add a new pitch measurement
+    // Allocate the history buffers (not real-time safe; also done by the constructor)
+    void prepare();
+    
+    // Allocate the session history (not real-time safe). Only statistics
+    // that are plotted need it; without it the history stays empty.
+    void prepareSessionHistory();
+    
+    // Add a new pitch measurement (constant time, no allocation), measured
+    // now or at timestamp (juce::Time high-resolution ticks)
     void addPitchMeasurement(float frequency, float amplitude);
+    void addPitchMeasurement(float frequency, float amplitude, juce::int64 timestamp);
     
-    // Reset all statistics
+    // Record an analysed frame without a pitch (silent, or nothing found),
+    // which only the session history keeps
+    void addUnpitchedFrame();
+    void addUnpitchedFrame(juce::int64 timestamp);
+    
+    // Record how long the detector took on one frame, whether or not it found a
+    // pitch (published to the UI with the next measurement)
+    void addComputeTime(float milliseconds);
+    
+    // Audio thread cost in CycleCounter::timestamp() units: one analysed frame
+    // (RMS gate plus detection, or plus hand-off to a worker) and one block's
+    // whole analysis against the block's duration
+    void addFrameCost(juce::uint64 timestamps);
+    void addBlockCost(juce::uint64 timestamps, juce::uint64 budgetTimestamps);
+    
+    // Distributions of those costs, readable from any thread: frame costs in
+    // timestamps, block costs in millionths of the block budget
+    const CostHistogram& getFrameCosts() const { return frameCosts; }
+    const CostHistogram& getBlockLoads() const { return blockLoads; }
+    static constexpr double BLOCK_LOAD_SCALE = 1.0e6;
+    
+    // Reset all statistics (only from the thread that adds measurements)
     void reset();
     
+    // Ask for a reset from another thread (e.g. the UI); applied by the
+    // measuring thread in handlePendingReset() or the next measurement
+    void requestReset() { resetRequested.store(true); }
+    void handlePendingReset();
+    
+    // Newest complete statistics, wait-free (single reader, e.g. the UI timer)
+    StatisticsSnapshot getSnapshot() { return snapshotBuffer.read(); }
+    
     // Get current statistics
     float getCurrentPitch() const { return currentPitch; }
     float getAveragePitch() const { return averagePitch; }
     float getPitchStability() const { return pitchStability; }
     float getDetectionConfidence() const { return detectionConfidence; }
     float getResponseTime() const { return responseTime; }
+    float getAverageComputeTime() const { return computeFrames > 0 ? static_cast<float>(computeTimeSum / computeFrames) : 0.0f; }
+    float getMaxComputeTime() const { return maxComputeTime; }
     int getTotalDetections() const { return totalDetections; }
     int getValidDetections() const { return validDetections; }
     
     // Get recent measurements for visualization
-    const std::deque<PitchMeasurement>& getRecentMeasurements() const { return recentMeasurements; }
+    const FixedRingBuffer<PitchMeasurement>& getRecentMeasurements() const { return recentMeasurements; }
     
-    // Get pitch history for plotting
-    std::vector<float> getPitchHistory() const;
+    // Every analysed frame since the last reset, for plotting from any thread
+    const PitchHistoryPyramid& getSessionHistory() const { return sessionHistory; }
+    
+    // Pitch measurements the windowed statistics (average pitch, stability)
+    // reach back over
+    static int getHistoryCapacity() { return MAX_HISTORY_SIZE; }
     
     // Note detection
     juce::String getCurrentNote() const;
     juce::String getAverageNote() const;
-    
+    static juce::String frequencyToNote(float frequency);
+
 private:
     // Current measurements
     float currentPitch = 0.0f;
@@ -57,13 +124,34 @@ private:
     float detectionConfidence = 0.0f;
     float responseTime = 0.0f;
     
+    // Detector cost
+    double computeTimeSum = 0.0;
+    int computeFrames = 0;
+    float maxComputeTime = 0.0f;
+    CostHistogram frameCosts;
+    CostHistogram blockLoads;
+    
     // Counters
     int totalDetections = 0;
     int validDetections = 0;
     
     // History for calculations
-    std::deque<PitchMeasurement> recentMeasurements;
-    std::vector<float> pitchHistory;
+    FixedRingBuffer<PitchMeasurement> recentMeasurements;  // Stability window
+    FixedRingBuffer<float> pitchHistory;
+    PitchHistoryPyramid sessionHistory;
+    
+    // Running sums, updated as values enter and leave the windows
+    double historyValidSum = 0.0;       // Valid pitches in pitchHistory
+    int historyValidCount = 0;
+    double stabilityMean = 0.0;         // Welford state for valid pitches in recentMeasurements
+    double stabilityM2 = 0.0;
+    int stabilityCount = 0;
+    juce::int64 intervalTickSum = 0;    // Gaps between consecutive valid recent measurements
+    int intervalCount = 0;
+    
+    // Publication to the UI
+    TripleBuffer<StatisticsSnapshot> snapshotBuffer;
+    std::atomic<bool> resetRequested { false };
     
     // Configuration - Updated for full bass guitar range
     static constexpr int MAX_HISTORY_SIZE = 1000;
@@ -72,10 +160,14 @@ private:
     static constexpr float MAX_VALID_FREQUENCY = 400.0f; // Hz (bass guitar range)
     
     // Helper methods
+    void addToHistory(float frequency);
+    void addToRecentMeasurements(const PitchMeasurement& measurement);
+    void addStabilitySample(double frequency);
+    void removeStabilitySample(double frequency);
     void updateStatistics();
     float calculatePitchStability() const;
     float calculateDetectionConfidence() const;
     float calculateResponseTime() const;
-    juce::String frequencyToNote(float frequency) const;
-    bool isValidFrequency(float frequency) const;
+    void publishSnapshot();
+    static bool isValidFrequency(float frequency);
 }; 
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include "BatchAnalyzer.h"
+#include "../PitchDetectionAlgorithms/SpectralPitchDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+BatchAnalyzer::BatchAnalyzer(const DetectorFactory& createDetectors, const Settings& newSettings)
+    : settings(newSettings)
+{
+    formatManager.registerBasicFormats();
+    
+    for (int i = 0; i < std::max(1, settings.numThreads); ++i)
+        detectorSets.push_back(createDetectors());
+    
+    for (const auto& detector : detectorSets.front())
+    {
+        statistics.push_back(std::make_unique<StatisticsManager>());
+        readsSpectralFrames.push_back(dynamic_cast<SpectralPitchDetector*>(detector.get()) != nullptr);
+    }
+    
+    readBuffer.setSize(2, READ_BLOCK_SIZE);
+    frameRms.resize(FRAMES_PER_BATCH);
+    frequencies.resize(static_cast<size_t>(getNumDetectors() * FRAMES_PER_BATCH));
+    confidences.resize(frequencies.size());
+    computeTimes.resize(frequencies.size());
+    
+    readAheadThread.startThread();
+    
+    // The calling thread analyses the first slice itself
+    for (int i = 1; i < static_cast<int>(detectorSets.size()); ++i)
+    {
+        workers.push_back(std::make_unique<SliceWorker>(*this, i));
+        workers.back()->startThread();
+    }
+}
+
+BatchAnalyzer::~BatchAnalyzer()
+{
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+    
+    readAheadThread.stopThread(1000);
+}
+
+juce::Result BatchAnalyzer::analyzeFile(const juce::File& input, juce::OutputStream& csv, FileReport& report)
+{
+    std::unique_ptr<juce::AudioFormatReader> fileReader(formatManager.createReaderFor(input));
+    if (fileReader == nullptr)
+        return juce::Result::fail("Can't read " + input.getFullPathName());
+    
+    // Step 1: Decode ahead on the background thread while we analyse
+    double fileSampleRate = fileReader->sampleRate;
+    int numChannels = static_cast<int>(fileReader->numChannels);
+    juce::int64 lengthInSamples = fileReader->lengthInSamples;
+    
+    auto readAheadSamples = static_cast<int>(settings.readAheadSeconds * fileSampleRate);
+    juce::BufferingAudioReader reader(fileReader.release(), readAheadThread, readAheadSamples);
+    reader.setReadTimeout(-1); // Block until decoded rather than returning silence
+    
+    // Step 2: Prepare for this file's sample rate. With the default frame
+    // size the hop can only be checked now: frames further apart than their
+    // length would skip audio.
+    prepareForSampleRate(fileSampleRate);
+    
+    if (settings.hopSize > frameSize)
+        return juce::Result::fail(input.getFileName() + ": the hop (" + juce::String(settings.hopSize)
+                                  + " samples) is longer than the frame (" + juce::String(frameSize) + " samples at "
+                                  + juce::String(fileSampleRate, 0) + " Hz)");
+    
+    streamLength = 0;
+    streamPosition = 0;
+    for (auto& stats : statistics)
+        stats->reset();
+    
+    if (readBuffer.getNumChannels() < numChannels)
+        readBuffer.setSize(numChannels, READ_BLOCK_SIZE);
+    
+    report = FileReport();
+    report.file = input;
+    report.sampleRate = fileSampleRate;
+    report.durationSeconds = lengthInSamples / fileSampleRate;
+    
+    writeHeader(csv);
+    
+    // Step 3: Fill the stream a batch at a time and analyse its frames
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    juce::int64 position = 0;
+    
+    while (position < lengthInSamples)
+    {
+        int space = static_cast<int>(stream.size()) - streamLength;
+        int numToRead = static_cast<int>(std::min<juce::int64>(std::min(READ_BLOCK_SIZE, space), lengthInSamples - position));
+        reader.read(readBuffer.getArrayOfWritePointers(), numChannels, position, numToRead);
+        mixToMono(numChannels, numToRead, stream.data() + streamLength);
+        
+        streamLength += numToRead;
+        position += numToRead;
+        
+        // A full stream holds exactly one batch; the end of the file
+        // analyses whatever frames are left
+        int numFrames = streamLength >= frameSize ? (streamLength - frameSize) / settings.hopSize + 1 : 0;
+        
+        if (numFrames == FRAMES_PER_BATCH || (position == lengthInSamples && numFrames > 0))
+        {
+            analyzeBatch(numFrames, fileSampleRate, csv);
+            report.frames += numFrames;
+            
+            // Keep the samples the next frames overlap
+            int consumed = numFrames * settings.hopSize;
+            std::memmove(stream.data(), stream.data() + consumed, sizeof(float) * static_cast<size_t>(streamLength - consumed));
+            streamLength -= consumed;
+            streamPosition += consumed;
+        }
+    }
+    
+    report.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    
+    // Step 4: Summarise each detector
+    const auto& detectors = detectorSets.front();
+    for (size_t i = 0; i < detectors.size(); ++i)
+    {
+        DetectorReport detectorReport;
+        detectorReport.name = detectors[i]->getName();
+        detectorReport.voicedFrames = statistics[i]->getTotalDetections();
+        detectorReport.averageComputeTime = statistics[i]->getAverageComputeTime();
+        detectorReport.maxComputeTime = statistics[i]->getMaxComputeTime();
+        report.detectors.push_back(detectorReport);
+    }
+    
+    csv.flush();
+    return juce::Result::ok();
+}
+
+void BatchAnalyzer::prepareForSampleRate(double sampleRate)
+{
+    if (sampleRate == preparedSampleRate)
+        return;
+    
+    frameSize = settings.frameSize > 0 ? settings.frameSize
+                                       : PitchDetector::getFrameSizeForFrequency(sampleRate, PitchDetector::DEFAULT_MIN_FREQUENCY);
+    
+    // Room for exactly one batch of frames
+    stream.resize(static_cast<size_t>(frameSize + (FRAMES_PER_BATCH - 1) * settings.hopSize));
+    
+    for (auto& detectors : detectorSets)
+    {
+        for (auto& detector : detectors)
+            detector->prepare(sampleRate, frameSize);
+    }
+    
+    preparedSampleRate = sampleRate;
+}
+
+void BatchAnalyzer::writeHeader(juce::OutputStream& csv) const
+{
+    csv << "time_s,rms";
+    
+    for (const auto& detector : detectorSets.front())
+        csv << "," << detector->getName() << "_f0," << detector->getName() << "_confidence";
+    
+    csv << "\n";
+}
+
+void BatchAnalyzer::analyzeBatch(int numFrames, double sampleRate, juce::OutputStream& csv)
+{
+    // Step 1: Level of every frame, for the amplitude gate
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const float* samples = stream.data() + i * settings.hopSize;
+        float rms = 0.0f;
+        for (int j = 0; j < frameSize; ++j)
+            rms += samples[j] * samples[j];
+        frameRms[static_cast<size_t>(i)] = std::sqrt(rms / frameSize);
+    }
+    
+    // Step 2: One consecutive slice per thread, so sliding detectors still
+    // see runs of overlapping frames
+    const int numSlices = std::min(numFrames, static_cast<int>(detectorSets.size()));
+    auto sliceStart = [&](int slice) { return slice * numFrames / numSlices; };
+    
+    for (int slice = 1; slice < numSlices; ++slice)
+        workers[static_cast<size_t>(slice - 1)]->startSlice(sliceStart(slice), sliceStart(slice + 1) - sliceStart(slice));
+    
+    analyzeSlice(0, 0, sliceStart(1));
+    
+    for (int slice = 1; slice < numSlices; ++slice)
+        workers[static_cast<size_t>(slice - 1)]->waitForSlice();
+    
+    // Step 3: Statistics and CSV rows in frame order
+    writeResults(numFrames, sampleRate, csv);
+}
+
+void BatchAnalyzer::analyzeSlice(int setIndex, int firstFrame, int numFrames)
+{
+    auto& detectors = detectorSets[static_cast<size_t>(setIndex)];
+    const int endFrame = firstFrame + numFrames;
+    int frame = firstFrame;
+    
+    while (frame < endFrame)
+    {
+        // Same amplitude gate as the plugin
+        if (frameRms[static_cast<size_t>(frame)] <= settings.amplitudeThreshold)
+        {
+            for (size_t d = 0; d < detectors.size(); ++d)
+            {
+                const size_t index = d * FRAMES_PER_BATCH + static_cast<size_t>(frame);
+                frequencies[index] = 0.0f;
+                confidences[index] = 0.0f;
+                computeTimes[index] = -1.0f;
+            }
+            
+            ++frame;
+            continue;
+        }
+        
+        int runEnd = frame + 1;
+        while (runEnd < endFrame && frameRms[static_cast<size_t>(runEnd)] > settings.amplitudeThreshold)
+            ++runEnd;
+        
+        // Each run of frames above the gate goes to a detector in one call...
+        for (size_t d = 0; d < detectors.size(); ++d)
+        {
+            if (!readsSpectralFrames[d])
+                detectFrames(*detectors[d], d, frame, runEnd - frame);
+        }
+        
+        // ... except for the spectral detectors, which take each frame in
+        // turn so they all read it from their shared cache
+        for (int i = frame; i < runEnd; ++i)
+        {
+            for (size_t d = 0; d < detectors.size(); ++d)
+            {
+                if (readsSpectralFrames[d])
+                    detectFrames(*detectors[d], d, i, 1);
+            }
+        }
+        
+        frame = runEnd;
+    }
+}
+
+void BatchAnalyzer::detectFrames(PitchDetector& detector, size_t detectorIndex, int firstFrame, int numFrames)
+{
+    const size_t offset = detectorIndex * FRAMES_PER_BATCH + static_cast<size_t>(firstFrame);
+    
+    juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    detector.detectPitchBatch(stream.data() + firstFrame * settings.hopSize, numFrames, settings.hopSize,
+                              frequencies.data() + offset, confidences.data() + offset);
+    float computeTimeMs = static_cast<float>(juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks) * 1000.0);
+    
+    std::fill_n(computeTimes.begin() + static_cast<std::ptrdiff_t>(offset), numFrames, computeTimeMs / numFrames);
+}
+
+void BatchAnalyzer::writeResults(int numFrames, double sampleRate, juce::OutputStream& csv)
+{
+    const int numDetectors = getNumDetectors();
+    
+    for (int i = 0; i < numFrames; ++i)
+    {
+        // Frames are time-stamped at their centre
+        juce::int64 frameEnd = streamPosition + i * settings.hopSize + frameSize;
+        float rms = frameRms[static_cast<size_t>(i)];
+        
+        juce::String row = juce::String((frameEnd - frameSize / 2) / sampleRate, 4) + "," + juce::String(rms, 5);
+        
+        for (int d = 0; d < numDetectors; ++d)
+        {
+            const size_t index = static_cast<size_t>(d * FRAMES_PER_BATCH + i);
+            float frequency = frequencies[index];
+            
+            if (computeTimes[index] >= 0.0f)
+            {
+                statistics[static_cast<size_t>(d)]->addComputeTime(computeTimes[index]);
+                
+                if (frequency > 0.0f)
+                    statistics[static_cast<size_t>(d)]->addPitchMeasurement(frequency, rms);
+            }
+            
+            row << "," << juce::String(frequency, 3) << "," << juce::String(confidences[index], 4);
+        }
+        
+        csv << row << "\n";
+    }
+}
+
+void BatchAnalyzer::mixToMono(int numChannels, int numSamples, float* destination) const
+{
+    juce::FloatVectorOperations::copy(destination, readBuffer.getReadPointer(0), numSamples);
+    
+    for (int channel = 1; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::add(destination, readBuffer.getReadPointer(channel), numSamples);
+    
+    if (numChannels > 1)
+        juce::FloatVectorOperations::multiply(destination, 1.0f / numChannels, numSamples);
+}
+
+BatchAnalyzer::SliceWorker::SliceWorker(BatchAnalyzer& owner, int detectorSetIndex)
+    : juce::Thread("Batch Analysis " + juce::String(detectorSetIndex)), analyzer(owner), setIndex(detectorSetIndex)
+{
+}
+
+void BatchAnalyzer::SliceWorker::startSlice(int firstFrame, int numFrames)
+{
+    sliceStart = firstFrame;
+    sliceSize = numFrames;
+    sliceReady.signal();
+}
+
+void BatchAnalyzer::SliceWorker::waitForSlice()
+{
+    sliceDone.wait(-1);
+}
+
+void BatchAnalyzer::SliceWorker::run()
+{
+    while (!threadShouldExit())
+    {
+        // Woken periodically to check for exit
+        if (!sliceReady.wait(100))
+            continue;
+        
+        analyzer.analyzeSlice(setIndex, sliceStart, sliceSize);
+        sliceDone.signal();
+    }
+}
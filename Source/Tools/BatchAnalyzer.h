@@ -0,0 +1,130 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../PitchDetectionAlgorithms/PitchDetector.h"
+#include "../Statistics/StatisticsManager.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Streams audio files through a set of pitch detectors and writes one CSV row
+// per analysis frame. Files are decoded ahead on a background thread
+// (BufferingAudioReader), so reading overlaps the analysis and long files run
+// at whichever is slower, not the sum of both.
+//
+// Decoded audio collects in one contiguous block holding FRAMES_PER_BATCH
+// overlapping frames, which go to the detectors in place through
+// detectPitchBatch: one call per run of frames above the amplitude gate, or
+// one per frame for spectral detectors so a shared SpectralFrameCache still
+// serves them all. Each batch is split into consecutive slices across worker
+// threads, each with its own set of detectors; results are written and
+// counted in frame order afterwards, so the CSV only depends on the number of
+// threads for detectors that carry state between frames (YIN Multi-Res's
+// starting tier).
+class BatchAnalyzer
+{
+public:
+    struct Settings
+    {
+        int frameSize = 0;                  // 0 sizes it per file from the lowest note, as the plugin does
+        int hopSize = 256;
+        float amplitudeThreshold = 0.01f;   // RMS below this is not analysed
+        double readAheadSeconds = 10.0;
+        int numThreads = 1;                 // Threads analysing each batch
+    };
+    
+    struct DetectorReport
+    {
+        juce::String name;
+        int voicedFrames = 0;
+        float averageComputeTime = 0.0f;    // ms per analysed frame
+        float maxComputeTime = 0.0f;        // Worst per-frame average of one detectPitchBatch call
+    };
+    
+    struct FileReport
+    {
+        juce::File file;
+        double sampleRate = 0.0;
+        double durationSeconds = 0.0;
+        int frames = 0;
+        double wallSeconds = 0.0;
+        std::vector<DetectorReport> detectors;
+        
+        double getFramesPerSecond() const { return wallSeconds > 0.0 ? frames / wallSeconds : 0.0; }
+        double getRealtimeFactor() const { return wallSeconds > 0.0 ? durationSeconds / wallSeconds : 0.0; }
+    };
+    
+    // Called once per thread for that thread's own detectors, which must
+    // come out the same each time
+    using DetectorFactory = std::function<std::vector<std::unique_ptr<PitchDetector>>()>;
+    
+    BatchAnalyzer(const DetectorFactory& createDetectors, const Settings& settings);
+    ~BatchAnalyzer();
+    
+    // File extensions that can be decoded, e.g. "*.wav;*.aiff;*.aif"
+    juce::String getSupportedWildcard() const { return formatManager.getWildcardForAllFormats(); }
+    
+    // Analyse one file, writing the CSV header and a row per frame to csv
+    juce::Result analyzeFile(const juce::File& input, juce::OutputStream& csv, FileReport& report);
+
+private:
+    // Analyses its slice of each batch with its own detectors
+    class SliceWorker : public juce::Thread
+    {
+    public:
+        SliceWorker(BatchAnalyzer& owner, int detectorSetIndex);
+        
+        void startSlice(int firstFrame, int numFrames);
+        void waitForSlice();
+        void run() override;
+    
+    private:
+        BatchAnalyzer& analyzer;
+        int setIndex;
+        int sliceStart = 0;
+        int sliceSize = 0;
+        juce::WaitableEvent sliceReady;
+        juce::WaitableEvent sliceDone;
+    };
+    
+    Settings settings;
+    std::vector<std::vector<std::unique_ptr<PitchDetector>>> detectorSets;   // One per thread; the first is the caller's
+    std::vector<std::unique_ptr<SliceWorker>> workers;
+    std::vector<std::unique_ptr<StatisticsManager>> statistics;
+    std::vector<bool> readsSpectralFrames;  // Per detector
+    double preparedSampleRate = 0.0;
+    int frameSize = 0;                      // For preparedSampleRate
+    
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread { "Audio Read-Ahead" };
+    
+    juce::AudioBuffer<float> readBuffer;
+    
+    // Mono audio the current batch's frames are read from in place: frame i
+    // starts at stream[i * hopSize]
+    std::vector<float> stream;
+    int streamLength = 0;
+    juce::int64 streamPosition = 0;         // File position of stream[0]
+    
+    // Per batch frame, and per detector x batch frame
+    std::vector<float> frameRms;
+    std::vector<float> frequencies;
+    std::vector<float> confidences;
+    std::vector<float> computeTimes;        // ms, or < 0 where the frame was gated
+    
+    static constexpr int READ_BLOCK_SIZE = 8192;
+    static constexpr int FRAMES_PER_BATCH = 256;
+    
+    int getNumDetectors() const { return static_cast<int>(detectorSets.front().size()); }
+    
+    void prepareForSampleRate(double sampleRate);
+    void writeHeader(juce::OutputStream& csv) const;
+    void analyzeBatch(int numFrames, double sampleRate, juce::OutputStream& csv);
+    void analyzeSlice(int setIndex, int firstFrame, int numFrames);
+    void detectFrames(PitchDetector& detector, size_t detectorIndex, int firstFrame, int numFrames);
+    void writeResults(int numFrames, double sampleRate, juce::OutputStream& csv);
+    void mixToMono(int numChannels, int numSamples, float* destination) const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchAnalyzer)
+};
@@ -0,0 +1,178 @@
+#include <juce_core/juce_core.h>
+#include "BatchAnalyzer.h"
+#include "../PitchDetectionAlgorithms/PitchDetectorFactory.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: PitchBatchAnalyzer [options] <file or folder>...\n\n"
+                  << "Writes <name>.pitch.csv with per-frame f0 and confidence for every input file.\n\n"
+                  << "Options:\n"
+                  << "  --algorithm=<name>   Only run this algorithm (default: all)\n"
+                  << "  --frame=<samples>    Analysis frame size (default: 2.2 periods of B0)\n"
+                  << "  --hop=<samples>      Samples between frames (default: 256)\n"
+                  << "  --gate=<rms>         Skip frames quieter than this (default: 0.01)\n"
+                  << "  --threads=<n>        Threads analysing each batch of frames (default: one per core)\n"
+                  << "  --output=<folder>    Where to write the CSV files (default: next to each input)\n";
+    }
+    
+    std::vector<std::unique_ptr<PitchDetector>> createDetectors(const juce::String& algorithmName)
+    {
+        auto detectors = PitchDetectorFactory::createAll();
+        
+        if (algorithmName.isNotEmpty())
+        {
+            detectors.erase(std::remove_if(detectors.begin(), detectors.end(),
+                                           [&](const std::unique_ptr<PitchDetector>& detector)
+                                           { return !detector->getName().equalsIgnoreCase(algorithmName); }),
+                            detectors.end());
+        }
+        
+        // Each thread gives its spectral detectors every frame in turn, so
+        // they can share one window and FFT
+        PitchDetectorFactory::shareSpectralFrameCache(detectors);
+        
+        return detectors;
+    }
+    
+    juce::Array<juce::File> collectInputFiles(const juce::ArgumentList& args, const juce::String& wildcard)
+    {
+        juce::Array<juce::File> files;
+        
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& argument = args[i];
+            
+            if (argument.isOption())
+                continue;
+            
+            juce::File input = argument.resolveAsFile();
+            
+            if (input.isDirectory())
+                files.addArray(input.findChildFiles(juce::File::findFiles, true, wildcard));
+            else
+                files.add(input);
+        }
+        
+        return files;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+    
+    // Step 1: Settings
+    BatchAnalyzer::Settings settings;
+    if (args.containsOption("--frame"))
+        settings.frameSize = args.getValueForOption("--frame").getIntValue();
+    if (args.containsOption("--hop"))
+        settings.hopSize = args.getValueForOption("--hop").getIntValue();
+    if (args.containsOption("--gate"))
+        settings.amplitudeThreshold = args.getValueForOption("--gate").getFloatValue();
+    
+    settings.numThreads = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--threads"))
+        settings.numThreads = args.getValueForOption("--threads").getIntValue();
+    
+    if (settings.frameSize < 0 || settings.hopSize <= 0 || (settings.frameSize > 0 && settings.hopSize > settings.frameSize))
+    {
+        std::cerr << "Frame size must not be negative and the hop between 1 and the frame size\n";
+        return 1;
+    }
+    
+    if (settings.numThreads <= 0)
+    {
+        std::cerr << "Thread count must be at least 1\n";
+        return 1;
+    }
+    
+    juce::String algorithmName = args.getValueForOption("--algorithm");
+    if (createDetectors(algorithmName).empty())
+    {
+        std::cerr << "Unknown algorithm: " << algorithmName << "\n";
+        return 1;
+    }
+    
+    juce::File outputFolder;
+    if (args.containsOption("--output"))
+    {
+        outputFolder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+        
+        if (!outputFolder.createDirectory())
+        {
+            std::cerr << "Can't create " << outputFolder.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    
+    BatchAnalyzer analyzer([&] { return createDetectors(algorithmName); }, settings);
+    juce::Array<juce::File> inputFiles = collectInputFiles(args, analyzer.getSupportedWildcard());
+    
+    // Step 2: Analyse each file
+    int failures = 0;
+    double totalAudioSeconds = 0.0;
+    double totalWallSeconds = 0.0;
+    juce::int64 totalFrames = 0;
+    
+    for (const auto& input : inputFiles)
+    {
+        juce::File folder = outputFolder == juce::File() ? input.getParentDirectory() : outputFolder;
+        juce::File csvFile = folder.getChildFile(input.getFileNameWithoutExtension() + ".pitch.csv");
+        
+        csvFile.deleteFile();
+        juce::FileOutputStream csv(csvFile);
+        if (csv.failedToOpen())
+        {
+            std::cerr << "Can't write " << csvFile.getFullPathName() << "\n";
+            failures++;
+            continue;
+        }
+        
+        BatchAnalyzer::FileReport report;
+        juce::Result result = analyzer.analyzeFile(input, csv, report);
+        
+        if (result.failed())
+        {
+            std::cerr << result.getErrorMessage() << "\n";
+            failures++;
+            continue;
+        }
+        
+        std::cout << input.getFileName() << ": " << juce::String(report.durationSeconds, 1) << " s, "
+                  << report.frames << " frames in " << juce::String(report.wallSeconds, 2) << " s ("
+                  << juce::String(report.getFramesPerSecond(), 0) << " frames/s, "
+                  << juce::String(report.getRealtimeFactor(), 1) << "x realtime)\n";
+        
+        for (const auto& detectorReport : report.detectors)
+        {
+            std::cout << "  " << detectorReport.name << ": " << detectorReport.voicedFrames << " voiced frames, "
+                      << juce::String(detectorReport.averageComputeTime, 3) << " ms/frame (max "
+                      << juce::String(detectorReport.maxComputeTime, 3) << " ms)\n";
+        }
+        
+        totalAudioSeconds += report.durationSeconds;
+        totalWallSeconds += report.wallSeconds;
+        totalFrames += report.frames;
+    }
+    
+    // Step 3: Overall throughput
+    if (totalWallSeconds > 0.0)
+    {
+        std::cout << "Total: " << inputFiles.size() - failures << " files, "
+                  << juce::String(totalAudioSeconds / 3600.0, 2) << " h of audio, "
+                  << juce::String(totalFrames / totalWallSeconds, 0) << " frames/s, "
+                  << juce::String(totalAudioSeconds / totalWallSeconds, 1) << "x realtime\n";
+    }
+    
+    return failures == 0 ? 0 : 1;
+}
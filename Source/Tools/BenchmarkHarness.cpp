@@ -0,0 +1,181 @@
+#include "BenchmarkHarness.h"
+#include "../Utilities/CycleCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+namespace
+{
+    std::atomic<juce::int64> allocationCount { 0 };
+    
+    void* countedAllocate(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        
+        if (void* pointer = std::malloc(size == 0 ? 1 : size))
+            return pointer;
+        
+        throw std::bad_alloc();
+    }
+    
+    // The fixed-size detectors hold alignas(64) members, so creating them
+    // goes through the aligned forms
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+       #else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, static_cast<std::size_t>(alignment), size == 0 ? 1 : size) == 0 ? pointer : nullptr;
+       #endif
+    }
+    
+    void* countedAllocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        if (void* pointer = allocateAligned(size, alignment))
+            return pointer;
+        
+        throw std::bad_alloc();
+    }
+    
+    void freeAligned(void* pointer)
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+}
+
+// Replace the global allocation functions so each case can report how often
+// it touches the heap.
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void operator delete(void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+
+BenchmarkHarness::BenchmarkHarness(double minimumSecondsPerCase)
+    : minimumSeconds(minimumSecondsPerCase)
+{
+}
+
+juce::int64 BenchmarkHarness::getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void BenchmarkHarness::run(const juce::String& name, int frameSize, double sampleRate, const std::function<void()>& body)
+{
+    if (filter.isNotEmpty() && !name.contains(filter))
+        return;
+    
+    // Warm up caches and any lazily sized buffers
+    body();
+    
+    // Grow the iteration count until one batch lasts long enough to time
+    juce::int64 iterations = 1;
+    
+    for (;;)
+    {
+        juce::int64 allocationsBefore = getAllocationCount();
+        juce::uint64 cyclesBefore = CycleCounter::now();
+        juce::int64 ticksBefore = juce::Time::getHighResolutionTicks();
+        
+        for (juce::int64 i = 0; i < iterations; ++i)
+            body();
+        
+        juce::int64 elapsedTicks = juce::Time::getHighResolutionTicks() - ticksBefore;
+        juce::uint64 elapsedCycles = CycleCounter::now() - cyclesBefore;
+        juce::int64 allocations = getAllocationCount() - allocationsBefore;
+        double elapsedSeconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+        
+        if (elapsedSeconds >= minimumSeconds || iterations >= MAX_ITERATIONS)
+        {
+            BenchmarkResult result;
+            result.name = name;
+            result.frameSize = frameSize;
+            result.sampleRate = sampleRate;
+            result.iterations = iterations;
+            result.nanosecondsPerIteration = elapsedSeconds * 1.0e9 / static_cast<double>(iterations);
+            result.cyclesPerIteration = static_cast<double>(elapsedCycles) / static_cast<double>(iterations);
+            result.allocationsPerIteration = static_cast<double>(allocations) / static_cast<double>(iterations);
+            results.push_back(result);
+            return;
+        }
+        
+        // Aim for the minimum time with some headroom, but at least double
+        double predicted = elapsedSeconds > 0.0 ? minimumSeconds * 1.4 * static_cast<double>(iterations) / elapsedSeconds
+                                                : static_cast<double>(iterations) * 10.0;
+        iterations = juce::jlimit<juce::int64>(iterations * 2, MAX_ITERATIONS,
+                                               static_cast<juce::int64>(predicted));
+    }
+}
+
+juce::String BenchmarkHarness::toJson() const
+{
+    auto* context = new juce::DynamicObject();
+    context->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    context->setProperty("host_name", juce::SystemStats::getComputerName());
+    context->setProperty("num_cpus", juce::SystemStats::getNumCpus());
+    context->setProperty("mhz_per_cpu", juce::SystemStats::getCpuSpeedInMegahertz());
+    context->setProperty("cpu_model", juce::SystemStats::getCpuModel());
+    context->setProperty("cycle_counter", CycleCounter::isAvailable());
+   #if JUCE_DEBUG
+    context->setProperty("library_build_type", "debug");
+   #else
+    context->setProperty("library_build_type", "release");
+   #endif
+    
+    juce::Array<juce::var> benchmarks;
+    
+    for (const auto& result : results)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("name", result.name);
+        entry->setProperty("run_name", result.name);
+        entry->setProperty("run_type", "iteration");
+        entry->setProperty("iterations", result.iterations);
+        entry->setProperty("real_time", result.nanosecondsPerIteration);
+        entry->setProperty("cpu_time", result.nanosecondsPerIteration);
+        entry->setProperty("time_unit", "ns");
+        entry->setProperty("frame_size", result.frameSize);
+        entry->setProperty("sample_rate", result.sampleRate);
+        entry->setProperty("cycles_per_sample", result.getCyclesPerSample());
+        entry->setProperty("allocations_per_iteration", result.allocationsPerIteration);
+        benchmarks.add(juce::var(entry));
+    }
+    
+    auto* root = new juce::DynamicObject();
+    root->setProperty("context", juce::var(context));
+    root->setProperty("benchmarks", benchmarks);
+    
+    return juce::JSON::toString(juce::var(root));
+}
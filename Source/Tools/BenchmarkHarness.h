@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <vector>
+
+// Result of timing one benchmark case
+struct BenchmarkResult
+{
+    juce::String name;
+    int frameSize = 0;
+    double sampleRate = 0.0;
+    juce::int64 iterations = 0;
+    double nanosecondsPerIteration = 0.0;
+    double cyclesPerIteration = 0.0;     // 0 if no cycle counter
+    double allocationsPerIteration = 0.0;
+    
+    double getCyclesPerSample() const { return frameSize > 0 ? cyclesPerIteration / frameSize : 0.0; }
+};
+
+// Minimal Google Benchmark style runner: each case is repeated until it has
+// run for at least the minimum time, then reported per iteration. Results are
+// written in Google Benchmark's JSON layout so existing comparison tooling
+// can diff two runs.
+class BenchmarkHarness
+{
+public:
+    explicit BenchmarkHarness(double minimumSecondsPerCase = 0.2);
+    
+    // Only run cases whose name contains this text (empty runs everything)
+    void setFilter(const juce::String& newFilter) { filter = newFilter; }
+    
+    // Time one case. frameSize is the number of samples one iteration
+    // processes, used for cycles/sample.
+    void run(const juce::String& name, int frameSize, double sampleRate, const std::function<void()>& body);
+    
+    const std::vector<BenchmarkResult>& getResults() const { return results; }
+    
+    juce::String toJson() const;
+    
+    // Heap allocations made by this process so far (counted by the tool's
+    // operator new replacement)
+    static juce::int64 getAllocationCount();
+
+private:
+    double minimumSeconds;
+    juce::String filter;
+    std::vector<BenchmarkResult> results;
+    
+    static constexpr juce::int64 MAX_ITERATIONS = 1000000000;
+};
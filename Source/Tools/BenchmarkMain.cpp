@@ -0,0 +1,121 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "BenchmarkHarness.h"
+#include "DetectorStageBenchmarks.h"
+#include "../DSP/PolyphaseDecimator.h"
+#include "../PitchDetectionAlgorithms/PitchDetector.h"
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // Frame sizes and sample rates covered by every run
+    const int frameSizes[] = { 1024, 2048, 4096 };
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+    
+    // Matches the plugin's analysis front end
+    const double minimumAnalysisRate = 4000.0;
+    const int defaultHopSize = 256;
+    
+    // Open A string (55 Hz) with a few harmonics, like a bass DI signal
+    juce::AudioBuffer<float> makeBassFrame(int frameSize, double sampleRate)
+    {
+        juce::AudioBuffer<float> frame(1, frameSize);
+        const double fundamental = 55.0;
+        
+        for (int i = 0; i < frameSize; ++i)
+        {
+            double phase = 2.0 * juce::MathConstants<double>::pi * fundamental * i / sampleRate;
+            double sample = 0.5 * std::sin(phase) + 0.25 * std::sin(2.0 * phase) + 0.12 * std::sin(3.0 * phase);
+            frame.setSample(0, i, static_cast<float>(sample));
+        }
+        
+        return frame;
+    }
+    
+    void printUsage()
+    {
+        std::cout << "Usage: PitchBenchmarks [options]\n\n"
+                  << "Options:\n"
+                  << "  --filter=<text>      Only run cases whose name contains this text\n"
+                  << "  --min-time=<s>       Minimum time per case (default: 0.2)\n"
+                  << "  --output=<file>      Write the JSON report here (default: stdout)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+    
+    double minimumSeconds = 0.2;
+    if (args.containsOption("--min-time"))
+        minimumSeconds = args.getValueForOption("--min-time").getDoubleValue();
+    
+    BenchmarkHarness harness(minimumSeconds);
+    harness.setFilter(args.getValueForOption("--filter"));
+    
+    // Step 1: Sweep frame sizes and sample rates
+    for (int frameSize : frameSizes)
+    {
+        for (double sampleRate : sampleRates)
+        {
+            juce::AudioBuffer<float> frame = makeBassFrame(frameSize, sampleRate);
+            
+            DetectorStageBenchmarks::runEndToEnd(harness, frame, sampleRate);
+            DetectorStageBenchmarks::runYinStages(harness, frame, sampleRate);
+            DetectorStageBenchmarks::runFFTStages(harness, frame, sampleRate);
+        }
+    }
+    
+    // Step 2: The plugin's decimated front end - the decimator itself, then
+    // the detectors on the frames the plugin sizes for B0 at the reduced rate
+    for (double sampleRate : sampleRates)
+    {
+        const int hostBlockSize = 2048;
+        int factor = PolyphaseDecimator::chooseFactor(sampleRate, minimumAnalysisRate);
+        double analysisRate = sampleRate / factor;
+        int analysisFrameSize = PitchDetector::getFrameSizeForFrequency(analysisRate, PitchDetector::DEFAULT_MIN_FREQUENCY);
+        
+        DetectorStageBenchmarks::runDecimator(harness, makeBassFrame(hostBlockSize, sampleRate), sampleRate, factor);
+        DetectorStageBenchmarks::runEndToEnd(harness, makeBassFrame(analysisFrameSize, analysisRate), analysisRate);
+        
+        // The default hop at the decimated rate
+        int analysisHopSize = defaultHopSize / factor;
+        auto signal = makeBassFrame(analysisFrameSize + 1000 * analysisHopSize, analysisRate);
+        DetectorStageBenchmarks::runSlidingYin(harness, signal, analysisFrameSize, analysisHopSize, analysisRate);
+        DetectorStageBenchmarks::runSpectralFrontEnd(harness, signal, analysisFrameSize, analysisHopSize, analysisRate);
+    }
+    
+    // Step 3: Human-readable summary on stderr, JSON on stdout or to a file
+    for (const auto& result : harness.getResults())
+    {
+        std::cerr << result.name << ": " << juce::String(result.nanosecondsPerIteration, 0) << " ns/frame, "
+                  << juce::String(result.getCyclesPerSample(), 2) << " cycles/sample, "
+                  << juce::String(result.allocationsPerIteration, 2) << " allocs/frame\n";
+    }
+    
+    juce::String json = harness.toJson();
+    
+    if (args.containsOption("--output"))
+    {
+        juce::File outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+        
+        if (!outputFile.replaceWithText(json))
+        {
+            std::cerr << "Can't write " << outputFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << "\n";
+    }
+    
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "DetectorStageBenchmarks.h"
+#include "../PitchDetectionAlgorithms/PitchDetectorFactory.h"
+#include "../PitchDetectionAlgorithms/YinPitchDetector.h"
+#include "../PitchDetectionAlgorithms/FFTPitchDetector.h"
+#include "../PitchDetectionAlgorithms/SlidingYinPitchDetector.h"
+#include "../PitchDetectionAlgorithms/SpectralPitchDetector.h"
+#include "../DSP/PolyphaseDecimator.h"
+#include <vector>
+
+namespace
+{
+    // Keeps results observable so the optimiser can't drop the work
+    volatile float benchmarkSink = 0.0f;
+    
+    juce::String caseName(const juce::String& detector, const juce::String& stage, int frameSize, double sampleRate)
+    {
+        return detector + "/" + stage + "/" + juce::String(frameSize) + "/" + juce::String(static_cast<int>(sampleRate));
+    }
+}
+
+void DetectorStageBenchmarks::runEndToEnd(BenchmarkHarness& harness, const juce::AudioBuffer<float>& frame, double sampleRate)
+{
+    int frameSize = frame.getNumSamples();
+    
+    // Alternate with a frame that differs in one sample, or the spectral
+    // detectors would find the previous frame's products already cached
+    juce::AudioBuffer<float> alternateFrame(frame);
+    alternateFrame.setSample(0, frameSize - 1, alternateFrame.getSample(0, frameSize - 1) + 1.0e-6f);
+    
+    for (auto& detector : PitchDetectorFactory::createAll())
+    {
+        detector->prepare(sampleRate, frameSize);
+        bool useAlternate = false;
+        
+        harness.run(caseName(detector->getName(), "detectPitch", frameSize, sampleRate), frameSize, sampleRate,
+                    [&]
+                    {
+                        benchmarkSink = detector->detectPitch(useAlternate ? alternateFrame : frame);
+                        useAlternate = !useAlternate;
+                    });
+    }
+    
+    // The compile-time specialisations, for the frame sizes that have them
+    for (auto& detector : PitchDetectorFactory::createFixedSize(frameSize))
+    {
+        detector->prepare(sampleRate, frameSize);
+        
+        harness.run(caseName(detector->getName() + " (fixed size)", "detectPitch", frameSize, sampleRate), frameSize, sampleRate,
+                    [&] { benchmarkSink = detector->detectPitch(frame); });
+    }
+}
+
+void DetectorStageBenchmarks::runYinStages(BenchmarkHarness& harness, const juce::AudioBuffer<float>& frame, double sampleRate)
+{
+    int frameSize = frame.getNumSamples();
+    const float* samples = frame.getReadPointer(0);
+    
+    YinPitchDetector yin;
+    yin.prepare(sampleRate, frameSize);
+    
+    // Step 1: Difference function, both implementations
+    yin.setDifferenceMethod(YinPitchDetector::DifferenceMethod::Direct);
+    harness.run(caseName("YIN", "computeDifferenceFunction(Direct)", frameSize, sampleRate), frameSize, sampleRate,
+                [&] { yin.computeDifferenceFunction(samples, frameSize); });
+    
+    yin.setDifferenceMethod(YinPitchDetector::DifferenceMethod::FFT);
+    harness.run(caseName("YIN", "computeDifferenceFunction(FFT)", frameSize, sampleRate), frameSize, sampleRate,
+                [&] { yin.computeDifferenceFunction(samples, frameSize); });
+    
+    // Step 2: Normalisation of the difference function left by step 1
+    harness.run(caseName("YIN", "computeCumulativeMeanNormalizedDifference", frameSize, sampleRate), frameSize, sampleRate,
+                [&] { yin.computeCumulativeMeanNormalizedDifference(); });
+    
+    // Step 3: Threshold search on the normalised function
+    harness.run(caseName("YIN", "findMinimumIndex", frameSize, sampleRate), frameSize, sampleRate,
+                [&] { benchmarkSink = static_cast<float>(yin.findMinimumIndex()); });
+}
+
+void DetectorStageBenchmarks::runFFTStages(BenchmarkHarness& harness, const juce::AudioBuffer<float>& frame, double sampleRate)
+{
+    int frameSize = frame.getNumSamples();
+    
+    FFTPitchDetector fft;
+    fft.prepare(sampleRate, frameSize);
+    SpectralFrameCache& cache = fft.getSpectralFrameCache();
+    cache.setFrame(frame.getReadPointer(0));
+    
+    // Each stage first forgets its own product, so it's recomputed on every
+    // iteration
+    
+    // Step 1: Window and zero pad
+    harness.run(caseName("FFT", "applyWindow", frameSize, sampleRate), frameSize, sampleRate,
+                [&]
+                {
+                    cache.validProducts = 0;
+                    benchmarkSink = cache.getWindowedFrame()[0];
+                });
+    
+    // Step 2: Real FFT
+    harness.run(caseName("FFT", "performFFT", frameSize, sampleRate), frameSize, sampleRate,
+                [&]
+                {
+                    cache.validProducts = SpectralFrameCache::WindowedFrame;
+                    benchmarkSink = cache.getSpectrum()[0];
+                });
+    
+    // Step 3: Magnitude spectrum and peak search
+    harness.run(caseName("FFT", "computeMagnitude", frameSize, sampleRate), frameSize, sampleRate,
+                [&]
+                {
+                    cache.validProducts = SpectralFrameCache::WindowedFrame | SpectralFrameCache::Spectrum;
+                    benchmarkSink = cache.getMagnitudeSpectrum()[0];
+                });
+    
+    const float* magnitudeSpectrum = cache.getMagnitudeSpectrum();
+    harness.run(caseName("FFT", "findPeakFrequency", frameSize, sampleRate), frameSize, sampleRate,
+                [&] { benchmarkSink = static_cast<float>(fft.findPeakFrequency(cache, magnitudeSpectrum)); });
+}
+
+void DetectorStageBenchmarks::runSpectralFrontEnd(BenchmarkHarness& harness, const juce::AudioBuffer<float>& signal,
+                                                  int frameSize, int hopSize, double sampleRate)
+{
+    // Every spectral detector on the same frames, first each with its own
+    // cache and then all through one
+    for (bool shared : { false, true })
+    {
+        std::vector<std::unique_ptr<PitchDetector>> spectralDetectors;
+        for (auto& detector : PitchDetectorFactory::createAll())
+        {
+            if (dynamic_cast<SpectralPitchDetector*>(detector.get()) != nullptr)
+                spectralDetectors.push_back(std::move(detector));
+        }
+        
+        if (shared)
+            PitchDetectorFactory::shareSpectralFrameCache(spectralDetectors);
+        
+        for (auto& detector : spectralDetectors)
+            detector->prepare(sampleRate, frameSize);
+        
+        juce::AudioBuffer<float> frame(1, frameSize);
+        int start = 0;
+        
+        harness.run(caseName("Spectral", juce::String(shared ? "shared" : "separate") + " caches ("
+                                 + juce::String(static_cast<int>(spectralDetectors.size())) + " detectors)",
+                             frameSize, sampleRate),
+                    frameSize, sampleRate,
+                    [&]
+                    {
+                        if (start + frameSize > signal.getNumSamples())
+                            start = 0;
+                        
+                        frame.copyFrom(0, 0, signal, 0, start, frameSize);
+                        for (auto& detector : spectralDetectors)
+                            benchmarkSink = detector->detectPitch(frame);
+                        start += hopSize;
+                    });
+    }
+}
+
+void DetectorStageBenchmarks::runSlidingYin(BenchmarkHarness& harness, const juce::AudioBuffer<float>& signal, int frameSize,
+                                            int hopSize, double sampleRate)
+{
+    SlidingYinPitchDetector yin;
+    yin.prepare(sampleRate, frameSize);
+    
+    juce::AudioBuffer<float> frame(1, frameSize);
+    int start = 0;
+    
+    // Wrapping back to the start costs one full recomputation per pass
+    harness.run(caseName("YIN Sliding", "detectPitch(hop " + juce::String(hopSize) + ")", frameSize, sampleRate),
+                frameSize, sampleRate,
+                [&]
+                {
+                    if (start + frameSize > signal.getNumSamples())
+                        start = 0;
+                    
+                    frame.copyFrom(0, 0, signal, 0, start, frameSize);
+                    benchmarkSink = yin.detectPitch(frame);
+                    start += hopSize;
+                });
+}
+
+void DetectorStageBenchmarks::runDecimator(BenchmarkHarness& harness, const juce::AudioBuffer<float>& block, double sampleRate, int factor)
+{
+    int blockSize = block.getNumSamples();
+    
+    PolyphaseDecimator decimator;
+    decimator.prepare(factor);
+    std::vector<float> output(static_cast<size_t>(decimator.getMaxOutputSamples(blockSize)));
+    
+    harness.run(caseName("Decimator", "process(x" + juce::String(factor) + ")", blockSize, sampleRate), blockSize, sampleRate,
+                [&] { benchmarkSink = static_cast<float>(decimator.process(block.getReadPointer(0), blockSize, output.data())); });
+}
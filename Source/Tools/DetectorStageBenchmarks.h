@@ -0,0 +1,31 @@
+#pragma once
+
+#include "BenchmarkHarness.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Times the individual stages of the built-in detectors. Declared a friend of
+// YinPitchDetector, FFTPitchDetector and SpectralFrameCache so it can call
+// their private stages directly on a prepared detector.
+class DetectorStageBenchmarks
+{
+public:
+    // Every registered detector's detectPitch, end to end, plus the
+    // fixed-size specialisations where the frame size has them
+    static void runEndToEnd(BenchmarkHarness& harness, const juce::AudioBuffer<float>& frame, double sampleRate);
+    
+    static void runYinStages(BenchmarkHarness& harness, const juce::AudioBuffer<float>& frame, double sampleRate);
+    static void runFFTStages(BenchmarkHarness& harness, const juce::AudioBuffer<float>& frame, double sampleRate);
+    
+    // Consecutive overlapping frames of a longer signal, as the plugin
+    // delivers them, so sliding YIN takes its incremental path
+    static void runSlidingYin(BenchmarkHarness& harness, const juce::AudioBuffer<float>& signal, int frameSize,
+                              int hopSize, double sampleRate);
+    
+    // The spectral detectors on consecutive frames, with a cache each and
+    // with one shared cache
+    static void runSpectralFrontEnd(BenchmarkHarness& harness, const juce::AudioBuffer<float>& signal, int frameSize,
+                                    int hopSize, double sampleRate);
+    
+    // The anti-aliasing front end on a host-rate block
+    static void runDecimator(BenchmarkHarness& harness, const juce::AudioBuffer<float>& block, double sampleRate, int factor);
+};
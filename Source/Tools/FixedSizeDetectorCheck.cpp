@@ -0,0 +1,129 @@
+#include "FixedSizeDetectorCheck.h"
+#include "../PitchDetectionAlgorithms/YinPitchDetector.h"
+#include "../PitchDetectionAlgorithms/FFTPitchDetector.h"
+#include "../PitchDetectionAlgorithms/FixedSizeYinPitchDetector.h"
+#include "../PitchDetectionAlgorithms/FixedSizeFFTPitchDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+
+namespace
+{
+    // Small enough that consecutive frames share most of their samples, as
+    // in the plugin
+    const int hopSize = 64;
+    
+    template <typename Sample>
+    const char* getSampleTypeName() { return std::is_same_v<Sample, float> ? "float" : "double"; }
+    
+    // One specialisation against its dynamic counterpart over the corpus
+    void compareDetectors(PitchDetector& specialised, PitchDetector& dynamic, const juce::String& description,
+                          double sampleRate, int frameSize, const std::vector<SyntheticSignalSpec>& corpus,
+                          juce::StringArray& mismatches)
+    {
+        specialised.prepare(sampleRate, frameSize);
+        dynamic.prepare(sampleRate, frameSize);
+        
+        int frames = 0;
+        int voicingMismatches = 0;
+        double maxCentsDifference = 0.0;
+        std::vector<float> interleaved;
+        
+        for (size_t s = 0; s < corpus.size(); ++s)
+        {
+            SyntheticSignal signal = SyntheticCorpus::generate(corpus[s], sampleRate, static_cast<juce::int64>(s + 1));
+            const float* samples = signal.samples.data();
+            
+            // The same signal as one channel of a stereo stream
+            interleaved.assign(signal.samples.size() * 2, 0.0f);
+            for (size_t i = 0; i < signal.samples.size(); ++i)
+                interleaved[i * 2] = samples[i];
+            
+            const int split = frameSize / 3;
+            
+            for (size_t start = 0; start + static_cast<size_t>(frameSize) <= signal.samples.size(); start += static_cast<size_t>(hopSize))
+            {
+                // Step 1: The specialisation reads the frame one of three ways
+                AudioFrameView view;
+                switch (frames % 3)
+                {
+                    case 0:
+                        view = AudioFrameView(samples + start, frameSize);
+                        break;
+                    case 1:
+                        view = AudioFrameView(samples + start, split, samples + start + split, frameSize - split);
+                        break;
+                    default:
+                        view = AudioFrameView(interleaved.data() + start * 2, split,
+                                              interleaved.data() + (start + static_cast<size_t>(split)) * 2, frameSize - split, 2);
+                        break;
+                }
+                
+                const float expected = dynamic.detectPitchInFrame(AudioFrameView(samples + start, frameSize));
+                const float detected = specialised.detectPitchInFrame(view);
+                frames++;
+                
+                // Step 2: Same voicing and pitch
+                if ((expected > 0.0f) != (detected > 0.0f))
+                    voicingMismatches++;
+                else if (expected > 0.0f)
+                    maxCentsDifference = std::max(maxCentsDifference, std::abs(1200.0 * std::log2(static_cast<double>(detected) / expected)));
+            }
+        }
+        
+        if (frames == 0)
+            mismatches.add(description + ": no frames compared");
+        
+        if (voicingMismatches > FixedSizeDetectorCheck::VOICING_MISMATCH_RATE * frames)
+            mismatches.add(description + ": voicing differs on " + juce::String(voicingMismatches) + " of "
+                           + juce::String(frames) + " frames");
+        
+        if (maxCentsDifference > FixedSizeDetectorCheck::CENTS_TOLERANCE)
+            mismatches.add(description + ": up to " + juce::String(maxCentsDifference, 4) + " cents from the dynamic detector");
+    }
+    
+    template <int FrameSize, typename Sample>
+    void checkSpecialisations(double sampleRate, const std::vector<SyntheticSignalSpec>& corpus, juce::StringArray& mismatches)
+    {
+        const juce::String suffix = " " + juce::String(FrameSize) + " " + getSampleTypeName<Sample>();
+        
+        // The plugin only reaches the specialisation if its frame size comes out exactly
+        if (PitchDetector::getFrameSizeForFrequency(sampleRate, PitchDetector::DEFAULT_MIN_FREQUENCY) != FrameSize)
+            mismatches.add(juce::String(sampleRate) + " Hz no longer gives " + juce::String(FrameSize) + "-sample frames");
+        
+        FixedSizeYinPitchDetector<FrameSize, Sample> fixedYin;
+        YinPitchDetector yin;
+        compareDetectors(fixedYin, yin, "YIN" + suffix, sampleRate, FrameSize, corpus, mismatches);
+        
+        FixedSizeFFTPitchDetector<FrameSize, Sample> fixedFFT;
+        FFTPitchDetector fft;
+        compareDetectors(fixedFFT, fft, "FFT" + suffix, sampleRate, FrameSize, corpus, mismatches);
+    }
+}
+
+namespace FixedSizeDetectorCheck
+{
+    juce::StringArray getCheckedConfigurations()
+    {
+        juce::StringArray names;
+        for (const char* detector : { "YIN", "FFT" })
+            for (int frameSize : { 405, 440 })
+                for (const char* sampleType : { "float", "double" })
+                    names.add(juce::String(detector) + " " + juce::String(frameSize) + " " + sampleType);
+        return names;
+    }
+    
+    juce::StringArray run(const std::vector<SyntheticSignalSpec>& corpus)
+    {
+        juce::StringArray mismatches;
+        
+        // The plugin's decimated rates for the 44.1 kHz and 48 kHz families
+        checkSpecialisations<405, float>(5512.5, corpus, mismatches);
+        checkSpecialisations<405, double>(5512.5, corpus, mismatches);
+        checkSpecialisations<440, float>(6000.0, corpus, mismatches);
+        checkSpecialisations<440, double>(6000.0, corpus, mismatches);
+        
+        return mismatches;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "SyntheticCorpus.h"
+#include <vector>
+
+// Runs the compile-time specialised detectors PitchDetectorFactory swaps in
+// for the plugin's analysis frames against the dynamic detectors they
+// replace: FixedSizeYin/FFTPitchDetector at 405 samples (5512.5 Hz) and 440
+// samples (6000 Hz), with float and double working precision, over the
+// corpus at those rates. The specialisations read their frames contiguous,
+// wrapped into two spans and strided, as the plugin's circular buffer can
+// hand them over; the dynamic detectors always read them contiguous.
+namespace FixedSizeDetectorCheck
+{
+    // Both must find a pitch on the same frames, within this many cents
+    constexpr double CENTS_TOLERANCE = 0.01;
+    constexpr double VOICING_MISMATCH_RATE = 0.001;
+    
+    // e.g. "YIN 405 float", for every pairing that is compared
+    juce::StringArray getCheckedConfigurations();
+    
+    // Human-readable mismatches; empty if every specialisation matches
+    juce::StringArray run(const std::vector<SyntheticSignalSpec>& corpus);
+}
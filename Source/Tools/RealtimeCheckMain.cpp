@@ -0,0 +1,356 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Analysis/ChannelAnalyzer.h"
+#include "../Analysis/AnalysisWorkerPool.h"
+#include "../DSP/PolyphaseDecimator.h"
+#include "../Diagnostics/RealtimeSafetyChecker.h"
+#include "../Statistics/SessionRecorder.h"
+#include "../Statistics/SessionLogReader.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    enum ExitCode
+    {
+        passed = 0,
+        violated = 1,
+        usageError = 2,
+        logMismatch = 3
+    };
+    
+    // One rate from each family, so both fixed-size detector specialisations run
+    const double sampleRates[] = { 44100.0, 48000.0 };
+    
+    // Matches the plugin's analysis front end
+    const double minimumAnalysisRate = 4000.0;
+    const int defaultHopSize = 256;
+    const int numChannels = 2;
+    const int blockSize = 512;
+    
+    enum class Mode
+    {
+        direct,
+        background,
+        compare
+    };
+    
+    const char* getModeName(Mode mode)
+    {
+        switch (mode)
+        {
+            case Mode::direct:      return "direct";
+            case Mode::background:  return "background";
+            case Mode::compare:     return "compare";
+        }
+        
+        return "";
+    }
+    
+    void printUsage()
+    {
+        std::cout << "Usage: PitchRealtimeCheck [options]\n\n"
+                  << "Runs processBlock over every algorithm in direct, background and compare mode\n"
+                  << "and fails on any allocation, free or mutex lock on the audio thread, or if\n"
+                  << "the session log it records doesn't replay into the same statistics.\n\n"
+                  << "Options:\n"
+                  << "  --blocks=<n>          Blocks per algorithm and mode (default: 200)\n";
+    }
+    
+    // A bass note on channel 0 and its fifth on channel 1, with every eighth
+    // block silent so the amplitude gate is exercised too
+    class TestSignal
+    {
+    public:
+        explicit TestSignal(double newSampleRate) : sampleRate(newSampleRate) {}
+        
+        void fill(juce::AudioBuffer<float>& buffer)
+        {
+            const float gain = (blockCount++ % 8 == 7) ? 0.0f : 1.0f;
+            
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                const double fundamental = 55.0 * (channel == 0 ? 1.0 : 1.5);
+                double phase = 2.0 * juce::MathConstants<double>::pi * fundamental * static_cast<double>(position) / sampleRate;
+                const double increment = 2.0 * juce::MathConstants<double>::pi * fundamental / sampleRate;
+                
+                for (int i = 0; i < buffer.getNumSamples(); ++i, phase += increment)
+                {
+                    double sample = 0.5 * std::sin(phase) + 0.25 * std::sin(2.0 * phase) + 0.12 * std::sin(3.0 * phase);
+                    buffer.setSample(channel, i, gain * static_cast<float>(sample));
+                }
+            }
+            
+            position += buffer.getNumSamples();
+        }
+    
+    private:
+        double sampleRate;
+        juce::int64 position = 0;
+        int blockCount = 0;
+    };
+    
+    // The analysis part of the plugin's processBlock, for every channel,
+    // with the calling thread marked as the audio thread
+    void processBlock(std::vector<std::unique_ptr<ChannelAnalyzer>>& analyzers, const juce::AudioBuffer<float>& buffer,
+                      const ChannelAnalyzer::BlockSettings& settings)
+    {
+        RealtimeSafetyChecker::ScopedAudioThread audioThread;
+        
+        for (int channel = 0; channel < static_cast<int>(analyzers.size()); ++channel)
+            analyzers[static_cast<size_t>(channel)]->processBlock(buffer.getReadPointer(channel), buffer.getNumSamples(), settings);
+    }
+    
+    // Every algorithm in one mode, then a statistics reset
+    void runMode(Mode mode, std::vector<std::unique_ptr<ChannelAnalyzer>>& analyzers, AnalysisWorkerPool& pool,
+                 TestSignal& signal, int blocksPerAlgorithm)
+    {
+        ChannelAnalyzer::BlockSettings settings;
+        settings.hopSize = defaultHopSize;
+        settings.backgroundAnalysis = mode == Mode::background;
+        settings.comparisonMode = mode == Mode::compare;
+        
+        // Pipelines first, as the processor switches modes
+        if (mode != Mode::direct)
+        {
+            for (auto& analyzer : analyzers)
+                analyzer->startPipelines(settings.comparisonMode);
+            pool.start();
+        }
+        
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        
+        for (int algorithm = 0; algorithm < analyzers.front()->getNumDetectors(); ++algorithm)
+        {
+            settings.algorithmIndex = algorithm;
+            
+            for (int block = 0; block < blocksPerAlgorithm; ++block)
+            {
+                signal.fill(buffer);
+                processBlock(analyzers, buffer, settings);
+            }
+        }
+        
+        for (auto& analyzer : analyzers)
+            analyzer->requestStatisticsReset();
+        
+        for (int block = 0; block < blocksPerAlgorithm; ++block)
+        {
+            signal.fill(buffer);
+            processBlock(analyzers, buffer, settings);
+        }
+        
+        for (auto& analyzer : analyzers)
+            analyzer->stopPipelines();
+        pool.stop();
+    }
+    
+    // What a channel's main statistics held at the end of a mode, and when
+    struct Checkpoint
+    {
+        juce::String description;
+        juce::int64 timestamp = 0;
+        int channel = 0;
+        int totalDetections = 0;
+        int validDetections = 0;
+        float currentPitch = 0.0f;
+        float averagePitch = 0.0f;
+        float pitchStability = 0.0f;
+        float responseTime = 0.0f;
+        float averageComputeTime = 0.0f;
+        float maxComputeTime = 0.0f;
+    };
+    
+    Checkpoint takeCheckpoint(const juce::String& description, const StatisticsManager& statistics, int channel)
+    {
+        Checkpoint checkpoint;
+        checkpoint.description = description + ", channel " + juce::String(channel);
+        checkpoint.timestamp = juce::Time::getHighResolutionTicks();
+        checkpoint.channel = channel;
+        checkpoint.totalDetections = statistics.getTotalDetections();
+        checkpoint.validDetections = statistics.getValidDetections();
+        checkpoint.currentPitch = statistics.getCurrentPitch();
+        checkpoint.averagePitch = statistics.getAveragePitch();
+        checkpoint.pitchStability = statistics.getPitchStability();
+        checkpoint.responseTime = statistics.getResponseTime();
+        checkpoint.averageComputeTime = statistics.getAverageComputeTime();
+        checkpoint.maxComputeTime = statistics.getMaxComputeTime();
+        return checkpoint;
+    }
+    
+    void compareValue(const juce::String& description, const char* name, float value, float live, juce::StringArray& mismatches)
+    {
+        // Running sums rebuilt over a shorter stretch can differ in the last bits
+        if (std::abs(value - live) > 1.0e-4f * std::max(1.0f, std::abs(live)))
+            mismatches.add(description + ": " + name + " " + juce::String(value) + ", live " + juce::String(live));
+    }
+    
+    // The recorded log, read back: replaying up to each checkpoint must give
+    // the statistics the analyzer had there, and scrubbing to it the same
+    // windowed values
+    juce::StringArray checkSessionLog(const juce::File& logFile, const SessionRecorder& recorder,
+                                      const std::vector<Checkpoint>& checkpoints)
+    {
+        juce::StringArray mismatches;
+        SessionLogReader reader(logFile);
+        
+        if (!reader.isValid() || reader.getNumRecords() != recorder.getNumRecordsWritten())
+        {
+            mismatches.add("the log doesn't read back with the " + juce::String(recorder.getNumRecordsWritten()) + " records written");
+            return mismatches;
+        }
+        
+        StatisticsManager statistics;
+        
+        for (const Checkpoint& checkpoint : checkpoints)
+        {
+            // Step 1: Everything logged before the checkpoint
+            const juce::int64 end = reader.findRecordAt(checkpoint.timestamp + 1);
+            if ((end > 0 && reader.getRecord(end - 1).timestamp > checkpoint.timestamp)
+                || (end < reader.getNumRecords() && reader.getRecord(end).timestamp <= checkpoint.timestamp))
+                mismatches.add(checkpoint.description + ": findRecordAt returned record " + juce::String(end));
+            
+            reader.replay(statistics, 0, end, checkpoint.channel);
+            
+            if (statistics.getTotalDetections() != checkpoint.totalDetections
+                || statistics.getValidDetections() != checkpoint.validDetections)
+                mismatches.add(checkpoint.description + ": replay counts " + juce::String(statistics.getValidDetections()) + " of "
+                               + juce::String(statistics.getTotalDetections()) + " detections valid, live "
+                               + juce::String(checkpoint.validDetections) + " of " + juce::String(checkpoint.totalDetections));
+            
+            const juce::String replayed = checkpoint.description + ", replay";
+            compareValue(replayed, "current pitch", statistics.getCurrentPitch(), checkpoint.currentPitch, mismatches);
+            compareValue(replayed, "average pitch", statistics.getAveragePitch(), checkpoint.averagePitch, mismatches);
+            compareValue(replayed, "stability", statistics.getPitchStability(), checkpoint.pitchStability, mismatches);
+            compareValue(replayed, "response time", statistics.getResponseTime(), checkpoint.responseTime, mismatches);
+            compareValue(replayed, "average compute time", statistics.getAverageComputeTime(), checkpoint.averageComputeTime, mismatches);
+            compareValue(replayed, "max compute time", statistics.getMaxComputeTime(), checkpoint.maxComputeTime, mismatches);
+            
+            // Step 2: Only the windowed values survive a scrub
+            if (end > 0)
+            {
+                reader.scrubTo(statistics, end - 1, checkpoint.channel);
+                
+                const juce::String scrubbed = checkpoint.description + ", scrub";
+                compareValue(scrubbed, "current pitch", statistics.getCurrentPitch(), checkpoint.currentPitch, mismatches);
+                compareValue(scrubbed, "average pitch", statistics.getAveragePitch(), checkpoint.averagePitch, mismatches);
+                compareValue(scrubbed, "stability", statistics.getPitchStability(), checkpoint.pitchStability, mismatches);
+                compareValue(scrubbed, "response time", statistics.getResponseTime(), checkpoint.responseTime, mismatches);
+            }
+        }
+        
+        return mismatches;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return passed;
+    }
+    
+    int blocksPerAlgorithm = 200;
+    if (args.containsOption("--blocks"))
+        blocksPerAlgorithm = args.getValueForOption("--blocks").getIntValue();
+    
+    if (blocksPerAlgorithm <= 0 || !RealtimeSafetyChecker::isEnabled())
+    {
+        if (!RealtimeSafetyChecker::isEnabled())
+            std::cerr << "Built without PITCH_DETECTION_REALTIME_CHECKS, so nothing would be caught\n";
+        
+        printUsage();
+        return usageError;
+    }
+    
+    juce::StringArray logMismatches;
+    
+    for (double sampleRate : sampleRates)
+    {
+        // Step 1: The processor's analysis setup for this rate, with a
+        // session log being recorded
+        AnalysisWorkerPool pool;
+        SessionRecorder recorder;
+        std::vector<std::unique_ptr<ChannelAnalyzer>> analyzers;
+        
+        const int decimationFactor = PolyphaseDecimator::chooseFactor(sampleRate, minimumAnalysisRate);
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            analyzers.push_back(std::make_unique<ChannelAnalyzer>(pool));
+            analyzers.back()->setSessionRecorder(&recorder, channel);
+            analyzers.back()->prepare(sampleRate, decimationFactor, defaultHopSize, 0);
+        }
+        
+        juce::File logFile = juce::File::createTempFile(".pdtlog");
+        juce::Result recording = recorder.start(logFile);
+        if (recording.failed())
+            std::cerr << "Not recording a session log: " << recording.getErrorMessage() << "\n";
+        
+        // Step 2: Every mode, counting violations as we go and noting the
+        // statistics each ends with
+        TestSignal signal(sampleRate);
+        std::vector<Checkpoint> checkpoints;
+        
+        for (Mode mode : { Mode::direct, Mode::background, Mode::compare })
+        {
+            const int before = RealtimeSafetyChecker::getNumViolations();
+            runMode(mode, analyzers, pool, signal, blocksPerAlgorithm);
+            
+            std::cout << static_cast<int>(sampleRate) << " Hz, " << getModeName(mode) << ": "
+                      << RealtimeSafetyChecker::getNumViolations() - before << " violations\n";
+            
+            const juce::String description = juce::String(static_cast<int>(sampleRate)) + " Hz, after " + getModeName(mode);
+            for (int channel = 0; channel < numChannels; ++channel)
+                checkpoints.push_back(takeCheckpoint(description, analyzers[static_cast<size_t>(channel)]->getStatisticsManager(), channel));
+        }
+        
+        recorder.stop();
+        
+        // Step 3: The log must replay into what the statistics showed; a log
+        // missing records can't, so it is only reported
+        if (recording.wasOk() && recorder.getDroppedRecords() > 0)
+        {
+            std::cout << static_cast<int>(sampleRate) << " Hz, session log: " << recorder.getDroppedRecords()
+                      << " records dropped, replay not compared\n";
+        }
+        else if (recording.wasOk())
+        {
+            juce::StringArray mismatches = checkSessionLog(logFile, recorder, checkpoints);
+            std::cout << static_cast<int>(sampleRate) << " Hz, session log: " << recorder.getNumRecordsWritten() << " records, "
+                      << (mismatches.isEmpty() ? "replay matches" : "replay differs") << " at " << checkpoints.size()
+                      << " checkpoints\n";
+            
+            for (const auto& mismatch : mismatches)
+                logMismatches.add(mismatch);
+        }
+        
+        logFile.deleteFile();
+        
+        for (auto& analyzer : analyzers)
+            analyzer->setSessionRecorder(nullptr, 0);
+    }
+    
+    // Step 4: Fail with the call stacks of anything caught, then with the
+    // log's mismatches
+    if (RealtimeSafetyChecker::getNumViolations() > 0)
+    {
+        std::cerr << RealtimeSafetyChecker::getReport() << "\n";
+        return violated;
+    }
+    
+    if (!logMismatches.isEmpty())
+    {
+        std::cerr << "Session log replay differs from the live statistics:\n" << logMismatches.joinIntoString("\n") << "\n";
+        return logMismatch;
+    }
+    
+    std::cout << "No real-time-safety violations\n";
+    return passed;
+}
@@ -0,0 +1,225 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "FixedSizeDetectorCheck.h"
+#include "RegressionSuite.h"
+#include "SimdKernelCheck.h"
+#include "SyntheticCorpus.h"
+#include <iostream>
+
+namespace
+{
+    enum ExitCode
+    {
+        passed = 0,
+        regressed = 1,
+        usageError = 2
+    };
+    
+    void printUsage()
+    {
+        std::cout << "Usage: PitchRegression [options]\n\n"
+                  << "Scores every algorithm on the synthetic corpus and fails on regressions,\n"
+                  << "or if a SIMD kernel variant or fixed-size detector disagrees with the code\n"
+                  << "it stands in for.\n\n"
+                  << "Options:\n"
+                  << "  --baseline=<file>       Compare against this baseline\n"
+                  << "  --update-baseline       Write the results to the baseline file instead\n"
+                  << "  --check-speed           Compare compute time even on a different CPU\n"
+                  << "  --report=<file>         Also write the full JSON report here\n"
+                  << "  --write-corpus=<folder> Write the corpus as WAV files with f0 labels and exit\n"
+                  << "  --sample-rate=<Hz>      (default: 44100)\n"
+                  << "  --frame=<samples>       (default: 2.2 periods of B0)\n"
+                  << "  --hop=<samples>         (default: 256)\n";
+    }
+    
+    juce::File resolve(const juce::String& path)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    }
+    
+    // 24-bit WAV plus a CSV of the ground-truth f0 every 10 ms, for use with
+    // the batch analyzer or other tools
+    bool writeCorpus(const juce::File& folder, double sampleRate)
+    {
+        if (!folder.createDirectory())
+            return false;
+        
+        juce::WavAudioFormat wavFormat;
+        auto specs = SyntheticCorpus::createStandardCorpus();
+        
+        for (size_t s = 0; s < specs.size(); ++s)
+        {
+            SyntheticSignal signal = SyntheticCorpus::generate(specs[s], sampleRate, static_cast<juce::int64>(s + 1));
+            juce::File wavFile = folder.getChildFile(specs[s].name + ".wav");
+            wavFile.deleteFile();
+            
+            std::unique_ptr<juce::OutputStream> stream = std::make_unique<juce::FileOutputStream>(wavFile);
+            std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 1, 24, {}, 0));
+            if (writer == nullptr)
+                return false;
+            
+            stream.release(); // Owned by the writer now
+            
+            const float* channels[] = { signal.samples.data() };
+            writer->writeFromFloatArrays(channels, 1, static_cast<int>(signal.samples.size()));
+            
+            juce::String labels = "time_s,f0\n";
+            auto labelStep = static_cast<size_t>(sampleRate * 0.01);
+            for (size_t i = 0; i < signal.groundTruth.size(); i += labelStep)
+                labels << juce::String(static_cast<double>(i) / sampleRate, 3) << "," << juce::String(signal.groundTruth[i], 3) << "\n";
+            
+            if (!folder.getChildFile(specs[s].name + ".f0.csv").replaceWithText(labels))
+                return false;
+        }
+        
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return passed;
+    }
+    
+    // Step 1: Settings
+    RegressionSuite::Settings settings;
+    if (args.containsOption("--sample-rate"))
+        settings.sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+    if (args.containsOption("--frame"))
+        settings.frameSize = args.getValueForOption("--frame").getIntValue();
+    if (args.containsOption("--hop"))
+        settings.hopSize = args.getValueForOption("--hop").getIntValue();
+    
+    if (settings.sampleRate <= 0.0 || settings.frameSize < 0 || settings.hopSize <= 0)
+    {
+        printUsage();
+        return usageError;
+    }
+    
+    if (args.containsOption("--write-corpus"))
+    {
+        juce::File folder = resolve(args.getValueForOption("--write-corpus"));
+        if (!writeCorpus(folder, settings.sampleRate))
+        {
+            std::cerr << "Can't write the corpus to " << folder.getFullPathName() << "\n";
+            return usageError;
+        }
+        
+        std::cout << "Corpus written to " << folder.getFullPathName() << "\n";
+        return passed;
+    }
+    
+    // Step 2: Score every detector
+    RegressionSuite suite(settings);
+    suite.run(SyntheticCorpus::createStandardCorpus());
+    
+    for (const auto& score : suite.getTotals())
+    {
+        std::cout << score.name << ": " << score.scoredFrames << " frames, gross errors "
+                  << juce::String(score.getGrossErrorRate() * 100.0, 2) << "%, mean error "
+                  << juce::String(score.getMeanCentsError(), 2) << " cents, "
+                  << juce::String(score.getMicrosecondsPerFrame(), 1) << " us/frame\n";
+    }
+    
+    for (const auto& run : suite.getDecimatedRuns())
+    {
+        std::cout << juce::roundToInt(run.hostSampleRate) << " Hz decimated by " << run.decimationFactor << " ("
+                  << run.frameSize << "-sample frames, hop " << run.hopSize << "):\n";
+        
+        for (const auto& score : run.totals)
+        {
+            std::cout << "  " << score.name << ": " << score.scoredFrames << " frames, gross errors "
+                      << juce::String(score.getGrossErrorRate() * 100.0, 2) << "%, mean error "
+                      << juce::String(score.getMeanCentsError(), 2) << " cents, "
+                      << juce::String(score.getMicrosecondsPerFrame(), 1) << " us/frame\n";
+        }
+    }
+    
+    const SlidingYinCheck& sliding = suite.getSlidingYinCheck();
+    std::cout << "YIN Sliding vs YIN at hop " << settings.slidingCheckHopSize << ": " << sliding.slidFrames << " of "
+              << sliding.frames << " frames slid, " << sliding.voicingMismatches << " voicing mismatches, max "
+              << juce::String(sliding.maxCentsDifference, 4) << " cents apart\n";
+    
+    // Step 3: Every SIMD variant this CPU runs must match the Generic kernels,
+    // or the scores above depend on which machine produced them
+    juce::StringArray kernelMismatches = SimdKernelCheck::run();
+    juce::StringArray checkedVariants = SimdKernelCheck::getCheckedVariants();
+    
+    if (checkedVariants.isEmpty())
+        std::cout << "SIMD kernels: only Generic available on this CPU\n";
+    else if (kernelMismatches.isEmpty())
+        std::cout << "SIMD kernels: " << checkedVariants.joinIntoString(", ") << " match Generic\n";
+    
+    for (const auto& mismatch : kernelMismatches)
+        std::cerr << "REGRESSION SIMD kernel " << mismatch << "\n";
+    
+    if (!kernelMismatches.isEmpty())
+        return regressed;
+    
+    // Step 4: The detectors specialised for the plugin's analysis frames must
+    // match the dynamic ones they stand in for
+    juce::StringArray specialisationMismatches = FixedSizeDetectorCheck::run(SyntheticCorpus::createStandardCorpus());
+    
+    if (specialisationMismatches.isEmpty())
+        std::cout << "Fixed-size detectors: " << FixedSizeDetectorCheck::getCheckedConfigurations().joinIntoString(", ")
+                  << " match the dynamic ones\n";
+    
+    for (const auto& mismatch : specialisationMismatches)
+        std::cerr << "REGRESSION Fixed-size " << mismatch << "\n";
+    
+    if (!specialisationMismatches.isEmpty())
+        return regressed;
+    
+    juce::var report = suite.toJson();
+    
+    if (args.containsOption("--report") && !resolve(args.getValueForOption("--report")).replaceWithText(juce::JSON::toString(report)))
+    {
+        std::cerr << "Can't write the report\n";
+        return usageError;
+    }
+    
+    if (!args.containsOption("--baseline"))
+        return passed;
+    
+    // Step 5: Update or compare with the baseline
+    juce::File baselineFile = resolve(args.getValueForOption("--baseline"));
+    
+    if (args.containsOption("--update-baseline"))
+    {
+        if (!baselineFile.replaceWithText(juce::JSON::toString(report)))
+        {
+            std::cerr << "Can't write " << baselineFile.getFullPathName() << "\n";
+            return usageError;
+        }
+        
+        std::cout << "Baseline updated: " << baselineFile.getFullPathName() << "\n";
+        return passed;
+    }
+    
+    juce::var baseline = juce::JSON::parse(baselineFile);
+    if (!baseline.isObject())
+    {
+        std::cerr << "Can't read baseline " << baselineFile.getFullPathName() << "\n";
+        return usageError;
+    }
+    
+    juce::String note;
+    juce::StringArray regressions = suite.compareWithBaseline(baseline, RegressionSuite::Tolerances(),
+                                                              args.containsOption("--check-speed"), note);
+    if (note.isNotEmpty())
+        std::cout << note << "\n";
+    
+    for (const auto& regression : regressions)
+        std::cerr << "REGRESSION " << regression << "\n";
+    
+    if (!regressions.isEmpty())
+        return regressed;
+    
+    std::cout << "No regressions against " << baselineFile.getFileName() << "\n";
+    return passed;
+}
@@ -0,0 +1,358 @@
+#include "RegressionSuite.h"
+#include "../PitchDetectionAlgorithms/PitchDetectorFactory.h"
+#include "../PitchDetectionAlgorithms/YinPitchDetector.h"
+#include "../PitchDetectionAlgorithms/SlidingYinPitchDetector.h"
+#include "../DSP/PolyphaseDecimator.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    void addScore(DetectorScore& total, const DetectorScore& score)
+    {
+        total.scoredFrames += score.scoredFrames;
+        total.grossErrors += score.grossErrors;
+        total.centsErrorSum += score.centsErrorSum;
+        total.computeTimeSum += score.computeTimeSum;
+    }
+}
+
+RegressionSuite::RegressionSuite(const Settings& newSettings)
+    : settings(newSettings)
+{
+    if (settings.frameSize <= 0)
+        settings.frameSize = PitchDetector::getFrameSizeForFrequency(settings.sampleRate, PitchDetector::DEFAULT_MIN_FREQUENCY);
+}
+
+void RegressionSuite::run(const std::vector<SyntheticSignalSpec>& corpus)
+{
+    // Spectral caches stay separate, so each detector's time includes its own FFT
+    auto detectors = PitchDetectorFactory::createAll();
+    for (auto& detector : detectors)
+        detector->prepare(settings.sampleRate, settings.frameSize);
+    
+    totals.assign(detectors.size(), DetectorScore());
+    for (size_t d = 0; d < detectors.size(); ++d)
+        totals[d].name = detectors[d]->getName();
+    
+    signalScores.clear();
+    
+    for (size_t s = 0; s < corpus.size(); ++s)
+    {
+        // Seeded per signal so every run sees identical noise
+        SyntheticSignal signal = SyntheticCorpus::generate(corpus[s], settings.sampleRate, static_cast<juce::int64>(s + 1));
+        std::vector<DetectorScore> scores = totals;
+        for (auto& score : scores)
+            score = DetectorScore { score.name };
+        
+        scoreSignal(detectors, signal.samples, signal.groundTruth, settings.frameSize, settings.hopSize, scores);
+        
+        for (size_t d = 0; d < detectors.size(); ++d)
+            addScore(totals[d], scores[d]);
+        
+        signalScores.emplace_back(corpus[s].name, std::move(scores));
+    }
+    
+    decimatedRuns.clear();
+    for (double hostSampleRate : settings.decimatedHostRates)
+        runDecimated(corpus, hostSampleRate);
+    
+    runSlidingYinCheck(corpus);
+}
+
+void RegressionSuite::scoreSignal(const std::vector<std::unique_ptr<PitchDetector>>& detectors, const std::vector<float>& samples,
+                                  const std::vector<float>& groundTruth, int frameSize, int hopSize,
+                                  std::vector<DetectorScore>& scores) const
+{
+    juce::AudioBuffer<float> frame(1, frameSize);
+    
+    for (size_t start = 0; start + static_cast<size_t>(frameSize) <= samples.size(); start += static_cast<size_t>(hopSize))
+    {
+        frame.copyFrom(0, 0, samples.data() + start, frameSize);
+        
+        // Step 1: Same amplitude gate as the plugin, with the DC removed
+        // so an offset alone doesn't count as signal
+        const float* frameSamples = frame.getReadPointer(0);
+        double mean = 0.0;
+        for (int i = 0; i < frameSize; ++i)
+            mean += frameSamples[i];
+        mean /= frameSize;
+        
+        double power = 0.0;
+        for (int i = 0; i < frameSize; ++i)
+            power += (frameSamples[i] - mean) * (frameSamples[i] - mean);
+        
+        if (std::sqrt(power / frameSize) <= settings.amplitudeThreshold)
+            continue;
+        
+        // Step 2: Ground truth at the frame centre
+        float truth = groundTruth[start + static_cast<size_t>(frameSize / 2)];
+        
+        // Step 3: Score each detector
+        for (size_t d = 0; d < detectors.size(); ++d)
+        {
+            juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+            float detected = detectors[d]->detectPitch(frame);
+            double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            
+            DetectorScore& score = scores[d];
+            score.scoredFrames++;
+            score.computeTimeSum += seconds;
+            
+            double centsError = detected > 0.0f ? std::abs(1200.0 * std::log2(detected / truth)) : 0.0;
+            if (detected <= 0.0f || centsError > settings.grossErrorCents)
+                score.grossErrors++;
+            else
+                score.centsErrorSum += centsError;
+        }
+    }
+}
+
+void RegressionSuite::runDecimated(const std::vector<SyntheticSignalSpec>& corpus, double hostSampleRate)
+{
+    // Step 1: The same front end ChannelAnalyzer::prepare sets up
+    DecimatedRun run;
+    run.hostSampleRate = hostSampleRate;
+    run.decimationFactor = PolyphaseDecimator::chooseFactor(hostSampleRate, settings.minimumAnalysisRate);
+    run.analysisSampleRate = hostSampleRate / run.decimationFactor;
+    run.frameSize = PitchDetector::getFrameSizeForFrequency(run.analysisSampleRate, PitchDetector::DEFAULT_MIN_FREQUENCY);
+    run.hopSize = std::max(1, settings.hopSize / run.decimationFactor);
+    
+    auto detectors = PitchDetectorFactory::createAll(run.frameSize);
+    for (auto& detector : detectors)
+        detector->prepare(run.analysisSampleRate, run.frameSize);
+    
+    for (const auto& detector : detectors)
+        run.totals.push_back(DetectorScore { detector->getName() });
+    
+    PolyphaseDecimator decimator;
+    decimator.prepare(run.decimationFactor);
+    
+    std::vector<float> decimated;
+    std::vector<float> decimatedTruth;
+    
+    for (size_t s = 0; s < corpus.size(); ++s)
+    {
+        // Step 2: Generate at the host rate and decimate, as the plugin's
+        // input would be; each signal starts from a cleared filter
+        SyntheticSignal signal = SyntheticCorpus::generate(corpus[s], hostSampleRate, static_cast<juce::int64>(s + 1));
+        const int numSamples = static_cast<int>(signal.samples.size());
+        
+        decimator.reset();
+        decimated.resize(static_cast<size_t>(decimator.getMaxOutputSamples(numSamples)));
+        decimated.resize(static_cast<size_t>(decimator.process(signal.samples.data(), numSamples, decimated.data())));
+        
+        // Step 3: Output sample j is the filter centred latency samples
+        // before the last input of its period, so its f0 is read there
+        decimatedTruth.resize(decimated.size());
+        for (size_t j = 0; j < decimated.size(); ++j)
+        {
+            double hostPosition = static_cast<double>((j + 1) * static_cast<size_t>(run.decimationFactor)) - 1.0 - decimator.getLatency();
+            auto index = static_cast<size_t>(std::max(0.0, std::round(hostPosition)));
+            decimatedTruth[j] = signal.groundTruth[std::min(index, signal.groundTruth.size() - 1)];
+        }
+        
+        std::vector<DetectorScore> scores;
+        for (const auto& total : run.totals)
+            scores.push_back(DetectorScore { total.name });
+        
+        scoreSignal(detectors, decimated, decimatedTruth, run.frameSize, run.hopSize, scores);
+        
+        for (size_t d = 0; d < scores.size(); ++d)
+            addScore(run.totals[d], scores[d]);
+    }
+    
+    decimatedRuns.push_back(std::move(run));
+}
+
+void RegressionSuite::runSlidingYinCheck(const std::vector<SyntheticSignalSpec>& corpus)
+{
+    // At the default hop and host rate every frame moves further than
+    // maxShift and is recomputed in full, so this runs where the plugin
+    // actually slides: decimated frames a few samples apart
+    const double sampleRate = settings.slidingCheckSampleRate;
+    const int frameSize = PitchDetector::getFrameSizeForFrequency(sampleRate, PitchDetector::DEFAULT_MIN_FREQUENCY);
+    const auto hopSize = static_cast<size_t>(settings.slidingCheckHopSize);
+    
+    YinPitchDetector plain;
+    SlidingYinPitchDetector sliding;
+    plain.prepare(sampleRate, frameSize);
+    
+    slidingYinCheck = SlidingYinCheck();
+    
+    for (size_t s = 0; s < corpus.size(); ++s)
+    {
+        // Each signal starts the sliding detector afresh
+        sliding.prepare(sampleRate, frameSize);
+        SyntheticSignal signal = SyntheticCorpus::generate(corpus[s], sampleRate, static_cast<juce::int64>(s + 1));
+        
+        for (size_t start = 0; start + static_cast<size_t>(frameSize) <= signal.samples.size(); start += hopSize)
+        {
+            const AudioFrameView frame(signal.samples.data() + start, frameSize);
+            const float expected = plain.detectPitchInFrame(frame);
+            const float detected = sliding.detectPitchInFrame(frame);
+            
+            slidingYinCheck.frames++;
+            if (sliding.getLastShift() > 0)
+                slidingYinCheck.slidFrames++;
+            
+            if ((expected > 0.0f) != (detected > 0.0f))
+                slidingYinCheck.voicingMismatches++;
+            else if (expected > 0.0f)
+                slidingYinCheck.maxCentsDifference = std::max(slidingYinCheck.maxCentsDifference,
+                                                              std::abs(1200.0 * std::log2(static_cast<double>(detected) / expected)));
+        }
+    }
+}
+
+namespace
+{
+    juce::var scoreToJson(const DetectorScore& score)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("frames", score.scoredFrames);
+        object->setProperty("gross_error_rate", score.getGrossErrorRate());
+        object->setProperty("mean_cents_error", score.getMeanCentsError());
+        object->setProperty("us_per_frame", score.getMicrosecondsPerFrame());
+        return juce::var(object);
+    }
+    
+    // One detector's totals against its baseline entry, each regression
+    // prefixed with label
+    void compareScore(const DetectorScore& score, const juce::var& reference, const juce::String& label,
+                      const RegressionSuite::Tolerances& tolerances, bool checkSpeed, juce::StringArray& regressions)
+    {
+        double baselineGrossRate = reference["gross_error_rate"];
+        double baselineCents = reference["mean_cents_error"];
+        double baselineMicroseconds = reference["us_per_frame"];
+        
+        if (score.getGrossErrorRate() > baselineGrossRate + tolerances.grossErrorRate)
+            regressions.add(label + ": gross error rate " + juce::String(score.getGrossErrorRate() * 100.0, 2)
+                            + "% (baseline " + juce::String(baselineGrossRate * 100.0, 2) + "%)");
+        
+        if (score.getMeanCentsError() > baselineCents + tolerances.meanCentsError)
+            regressions.add(label + ": mean error " + juce::String(score.getMeanCentsError(), 2)
+                            + " cents (baseline " + juce::String(baselineCents, 2) + ")");
+        
+        if (checkSpeed && baselineMicroseconds > 0.0
+            && score.getMicrosecondsPerFrame() > baselineMicroseconds * (1.0 + tolerances.computeTimeRatio))
+            regressions.add(label + ": " + juce::String(score.getMicrosecondsPerFrame(), 1)
+                            + " us/frame (baseline " + juce::String(baselineMicroseconds, 1) + ")");
+    }
+    
+    // Decimated runs are keyed by their host rate, e.g. "44100"
+    juce::String getDecimatedKey(const DecimatedRun& run)
+    {
+        return juce::String(juce::roundToInt(run.hostSampleRate));
+    }
+}
+
+juce::var RegressionSuite::toJson() const
+{
+    auto* context = new juce::DynamicObject();
+    context->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    context->setProperty("cpu_model", juce::SystemStats::getCpuModel());
+    context->setProperty("sample_rate", settings.sampleRate);
+    context->setProperty("frame_size", settings.frameSize);
+    context->setProperty("hop_size", settings.hopSize);
+    context->setProperty("gross_error_cents", settings.grossErrorCents);
+    
+    auto* detectorTotals = new juce::DynamicObject();
+    for (const auto& score : totals)
+        detectorTotals->setProperty(score.name, scoreToJson(score));
+    
+    auto* signals = new juce::DynamicObject();
+    for (const auto& [signalName, scores] : signalScores)
+    {
+        auto* perDetector = new juce::DynamicObject();
+        for (const auto& score : scores)
+            perDetector->setProperty(score.name, scoreToJson(score));
+        signals->setProperty(signalName, juce::var(perDetector));
+    }
+    
+    auto* sliding = new juce::DynamicObject();
+    sliding->setProperty("sample_rate", settings.slidingCheckSampleRate);
+    sliding->setProperty("hop_size", settings.slidingCheckHopSize);
+    sliding->setProperty("frames", slidingYinCheck.frames);
+    sliding->setProperty("slid_frames", slidingYinCheck.slidFrames);
+    sliding->setProperty("voicing_mismatches", slidingYinCheck.voicingMismatches);
+    sliding->setProperty("max_cents_difference", slidingYinCheck.maxCentsDifference);
+    
+    auto* decimated = new juce::DynamicObject();
+    for (const auto& run : decimatedRuns)
+    {
+        auto* runObject = new juce::DynamicObject();
+        runObject->setProperty("sample_rate", run.analysisSampleRate);
+        runObject->setProperty("decimation_factor", run.decimationFactor);
+        runObject->setProperty("frame_size", run.frameSize);
+        runObject->setProperty("hop_size", run.hopSize);
+        
+        auto* runTotals = new juce::DynamicObject();
+        for (const auto& score : run.totals)
+            runTotals->setProperty(score.name, scoreToJson(score));
+        runObject->setProperty("detectors", juce::var(runTotals));
+        
+        decimated->setProperty(getDecimatedKey(run), juce::var(runObject));
+    }
+    
+    auto* root = new juce::DynamicObject();
+    root->setProperty("context", juce::var(context));
+    root->setProperty("detectors", juce::var(detectorTotals));
+    root->setProperty("signals", juce::var(signals));
+    root->setProperty("sliding_yin", juce::var(sliding));
+    root->setProperty("decimated", juce::var(decimated));
+    return juce::var(root);
+}
+
+juce::StringArray RegressionSuite::compareWithBaseline(const juce::var& baseline, const Tolerances& tolerances,
+                                                       bool forceSpeedCheck, juce::String& note) const
+{
+    juce::StringArray regressions;
+    
+    bool sameCpu = baseline["context"]["cpu_model"].toString() == juce::SystemStats::getCpuModel();
+    bool checkSpeed = forceSpeedCheck || sameCpu;
+    note = checkSpeed ? juce::String() : "Baseline was recorded on a different CPU; compute time not compared";
+    
+    for (const auto& score : totals)
+    {
+        const juce::var& reference = baseline["detectors"][juce::Identifier(score.name)];
+        
+        // New detectors have nothing to regress against yet
+        if (reference.isVoid())
+            continue;
+        
+        compareScore(score, reference, score.name, tolerances, checkSpeed, regressions);
+    }
+    
+    // The decimated path, run by run; a host rate or detector the baseline
+    // predates is skipped the same way
+    for (const auto& run : decimatedRuns)
+    {
+        const juce::var& runReference = baseline["decimated"][juce::Identifier(getDecimatedKey(run))];
+        const juce::String prefix = getDecimatedKey(run) + " Hz decimated / ";
+        
+        for (const auto& score : run.totals)
+        {
+            const juce::var& reference = runReference["detectors"][juce::Identifier(score.name)];
+            if (!reference.isVoid())
+                compareScore(score, reference, prefix + score.name, tolerances, checkSpeed, regressions);
+        }
+    }
+    
+    // Sliding YIN has to keep agreeing with plain YIN, and to actually slide
+    const SlidingYinCheck& check = slidingYinCheck;
+    
+    if (check.slidFrames < check.frames * tolerances.slidingMinSlidFraction)
+        regressions.add("YIN Sliding: only " + juce::String(check.slidFrames) + " of " + juce::String(check.frames)
+                        + " frames updated incrementally at hop " + juce::String(settings.slidingCheckHopSize));
+    
+    if (check.voicingMismatches > check.frames * tolerances.slidingVoicingMismatchRate)
+        regressions.add("YIN Sliding: " + juce::String(check.voicingMismatches) + " frames voiced differently from YIN");
+    
+    if (check.maxCentsDifference > tolerances.slidingCentsDifference)
+        regressions.add("YIN Sliding: up to " + juce::String(check.maxCentsDifference, 3) + " cents from YIN (tolerance "
+                        + juce::String(tolerances.slidingCentsDifference, 3) + ")");
+    
+    return regressions;
+}
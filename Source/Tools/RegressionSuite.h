@@ -0,0 +1,119 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "SyntheticCorpus.h"
+#include "../PitchDetectionAlgorithms/PitchDetector.h"
+#include <memory>
+#include <vector>
+
+// Accuracy and cost of one detector over a set of signals
+struct DetectorScore
+{
+    juce::String name;
+    int scoredFrames = 0;
+    int grossErrors = 0;            // Unvoiced, or further than the gross error limit
+    double centsErrorSum = 0.0;     // Absolute, over frames that are not gross errors
+    double computeTimeSum = 0.0;    // Seconds in detectPitch
+    
+    double getGrossErrorRate() const { return scoredFrames > 0 ? static_cast<double>(grossErrors) / scoredFrames : 0.0; }
+    double getMeanCentsError() const { return scoredFrames > grossErrors ? centsErrorSum / (scoredFrames - grossErrors) : 0.0; }
+    double getMicrosecondsPerFrame() const { return scoredFrames > 0 ? computeTimeSum * 1.0e6 / scoredFrames : 0.0; }
+};
+
+// Sliding YIN against plain YIN on the same frames, at a hop small enough
+// for the sliding update to be used
+struct SlidingYinCheck
+{
+    int frames = 0;
+    int slidFrames = 0;                 // Updated incrementally rather than in full
+    int voicingMismatches = 0;          // Only one of the two found a pitch
+    double maxCentsDifference = 0.0;    // Over frames where both found one
+};
+
+// The plugin's analysis path at one host rate: the corpus is generated at
+// that rate and decimated, and the detectors for the decimated frame size
+// (the fixed-size specialisations where there are any) are scored on it
+struct DecimatedRun
+{
+    double hostSampleRate = 0.0;
+    int decimationFactor = 1;
+    double analysisSampleRate = 0.0;
+    int frameSize = 0;
+    int hopSize = 0;                    // In decimated samples
+    std::vector<DetectorScore> totals;
+};
+
+// Scores every registered detector against the synthetic corpus and compares
+// the totals with a stored baseline
+class RegressionSuite
+{
+public:
+    struct Settings
+    {
+        double sampleRate = 44100.0;
+        int frameSize = 0;                  // 0 sizes it from the lowest note, as the plugin does
+        int hopSize = 256;
+        float amplitudeThreshold = 0.01f;   // Quieter frames are not scored, as in the plugin
+        float grossErrorCents = 50.0f;
+        
+        // Sliding YIN check: the plugin's decimated rate (44.1 kHz / 8) and
+        // a hop well below the shift where it falls back to a full update
+        double slidingCheckSampleRate = 5512.5;
+        int slidingCheckHopSize = 32;
+        
+        // Decimated runs: the plugin's front end at each of these host rates,
+        // decimating to at least minimumAnalysisRate with hopSize scaled down
+        // by the same factor
+        std::vector<double> decimatedHostRates { 44100.0, 48000.0 };
+        double minimumAnalysisRate = 4000.0;
+    };
+    
+    // How far the totals may move past the baseline before failing
+    struct Tolerances
+    {
+        double grossErrorRate = 0.01;       // Absolute increase
+        double meanCentsError = 1.0;        // Absolute increase
+        double computeTimeRatio = 0.25;     // Relative increase
+        
+        // Sliding YIN must match plain YIN this closely, whatever the baseline
+        double slidingCentsDifference = 0.1;
+        double slidingVoicingMismatchRate = 0.001;
+        double slidingMinSlidFraction = 0.8;
+    };
+    
+    explicit RegressionSuite(const Settings& settings);
+    
+    void run(const std::vector<SyntheticSignalSpec>& corpus);
+    
+    // Totals per detector, and the same per signal
+    const std::vector<DetectorScore>& getTotals() const { return totals; }
+    const std::vector<std::pair<juce::String, std::vector<DetectorScore>>>& getSignalScores() const { return signalScores; }
+    const SlidingYinCheck& getSlidingYinCheck() const { return slidingYinCheck; }
+    const std::vector<DecimatedRun>& getDecimatedRuns() const { return decimatedRuns; }
+    
+    juce::var toJson() const;
+    
+    // Human-readable regressions against a baseline written by toJson(); empty
+    // if everything is within tolerance. The decimated runs are held to the
+    // same tolerances as the host-rate totals. Speed is only compared when the
+    // baseline was recorded on the same CPU model, unless forced. The sliding
+    // YIN check is held to the tolerances alone.
+    juce::StringArray compareWithBaseline(const juce::var& baseline, const Tolerances& tolerances,
+                                          bool forceSpeedCheck, juce::String& note) const;
+
+private:
+    Settings settings;
+    std::vector<DetectorScore> totals;
+    std::vector<std::pair<juce::String, std::vector<DetectorScore>>> signalScores;
+    SlidingYinCheck slidingYinCheck;
+    std::vector<DecimatedRun> decimatedRuns;
+    
+    // Add each detector's score on every gated frame of one signal, with the
+    // true f0 taken from groundTruth at the frame centre
+    void scoreSignal(const std::vector<std::unique_ptr<PitchDetector>>& detectors, const std::vector<float>& samples,
+                     const std::vector<float>& groundTruth, int frameSize, int hopSize,
+                     std::vector<DetectorScore>& scores) const;
+    
+    void runDecimated(const std::vector<SyntheticSignalSpec>& corpus, double hostSampleRate);
+    void runSlidingYinCheck(const std::vector<SyntheticSignalSpec>& corpus);
+};
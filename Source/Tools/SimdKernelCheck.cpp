@@ -0,0 +1,202 @@
+#include "SimdKernelCheck.h"
+#include "../DSP/SimdKernels.h"
+#include "../DSP/FFTEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Odd lengths hit the scalar tails of every vector width; the larger ones
+    // run several full vectors first
+    const int lengths[] = { 1, 2, 3, 5, 7, 8, 13, 16, 17, 31, 33, 64, 405, 1031 };
+    
+    // Every radix-4 span from the scalar-only ones up, with and without the
+    // leading radix-2 pass
+    const int fftSizes[] = { 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    
+    const SimdInstructionSet variants[] = { SimdInstructionSet::SSE2, SimdInstructionSet::AVX2, SimdInstructionSet::AVX512 };
+    
+    std::vector<float> makeRandom(juce::Random& random, int numSamples, float minimum, float maximum)
+    {
+        std::vector<float> values(static_cast<size_t>(numSamples));
+        for (auto& value : values)
+            value = minimum + random.nextFloat() * (maximum - minimum);
+        return values;
+    }
+    
+    bool isClose(float value, float reference, float scale)
+    {
+        return std::abs(value - reference) <= SimdKernelCheck::TOLERANCE * std::max(scale, 1.0f);
+    }
+    
+    // Element-wise comparison, each element scaled by its own magnitude
+    void compareArrays(const std::vector<float>& values, const std::vector<float>& reference,
+                       const juce::String& description, juce::StringArray& mismatches)
+    {
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            if (!isClose(values[i], reference[i], std::abs(reference[i])))
+            {
+                mismatches.add(description + ": element " + juce::String(static_cast<int>(i)) + " is "
+                               + juce::String(values[i]) + ", Generic gives " + juce::String(reference[i]));
+                return;
+            }
+        }
+    }
+    
+    void compareSum(float value, float reference, float sumOfMagnitudes,
+                    const juce::String& description, juce::StringArray& mismatches)
+    {
+        if (!isClose(value, reference, sumOfMagnitudes))
+            mismatches.add(description + " is " + juce::String(value) + ", Generic gives " + juce::String(reference));
+    }
+    
+    void checkLinearKernels(const SimdKernelTable& table, const SimdKernelTable& generic, juce::StringArray& mismatches)
+    {
+        juce::Random random(1);
+        
+        for (int length : lengths)
+        {
+            const juce::String suffix = " (" + juce::String(table.name) + ", length " + juce::String(length) + ")";
+            auto a = makeRandom(random, length, -1.0f, 1.0f);
+            auto b = makeRandom(random, length, -1.0f, 1.0f);
+            
+            // Step 1: multiply
+            std::vector<float> out(static_cast<size_t>(length)), reference(static_cast<size_t>(length));
+            table.multiply(a.data(), b.data(), out.data(), length);
+            generic.multiply(a.data(), b.data(), reference.data(), length);
+            compareArrays(out, reference, "multiply" + suffix, mismatches);
+            
+            // Step 2: sumOfSquaredDifferences and dotProduct, scaled by the
+            // sum of the magnitudes of their terms
+            float squaredDifferences = 0.0f, products = 0.0f;
+            for (int i = 0; i < length; ++i)
+            {
+                squaredDifferences += (a[i] - b[i]) * (a[i] - b[i]);
+                products += std::abs(a[i] * b[i]);
+            }
+            
+            compareSum(table.sumOfSquaredDifferences(a.data(), b.data(), length),
+                       generic.sumOfSquaredDifferences(a.data(), b.data(), length),
+                       squaredDifferences, "sumOfSquaredDifferences" + suffix, mismatches);
+            compareSum(table.dotProduct(a.data(), b.data(), length),
+                       generic.dotProduct(a.data(), b.data(), length),
+                       products, "dotProduct" + suffix, mismatches);
+            
+            // Step 3: divideByRunningMean, starting at 0 and off the vector
+            // alignment, out of place and in place
+            auto runningSums = makeRandom(random, length + 1, 0.5f, 2.0f);
+            auto values = makeRandom(random, length + 1, 0.0f, 1.0f);
+            
+            for (int start : { 0, 1 })
+            {
+                std::vector<float> divided(runningSums), dividedReference(runningSums);
+                table.divideByRunningMean(values.data(), runningSums.data(), divided.data(), start, length + 1);
+                generic.divideByRunningMean(values.data(), runningSums.data(), dividedReference.data(), start, length + 1);
+                compareArrays(divided, dividedReference, "divideByRunningMean from " + juce::String(start) + suffix, mismatches);
+                
+                std::vector<float> inPlace(runningSums), inPlaceReference(runningSums);
+                table.divideByRunningMean(values.data(), inPlace.data(), inPlace.data(), start, length + 1);
+                generic.divideByRunningMean(values.data(), inPlaceReference.data(), inPlaceReference.data(), start, length + 1);
+                compareArrays(inPlace, inPlaceReference, "divideByRunningMean in place from " + juce::String(start) + suffix, mismatches);
+            }
+            
+            // Step 4: complexMagnitude and complexMultiplyConjugate over
+            // `length` interleaved bins
+            auto spectrumA = makeRandom(random, length * 2, -1.0f, 1.0f);
+            auto spectrumB = makeRandom(random, length * 2, -1.0f, 1.0f);
+            
+            std::vector<float> magnitudes(static_cast<size_t>(length)), magnitudesReference(static_cast<size_t>(length));
+            table.complexMagnitude(spectrumA.data(), magnitudes.data(), length);
+            generic.complexMagnitude(spectrumA.data(), magnitudesReference.data(), length);
+            compareArrays(magnitudes, magnitudesReference, "complexMagnitude" + suffix, mismatches);
+            
+            std::vector<float> crossSpectrum(static_cast<size_t>(length * 2)), crossSpectrumReference(static_cast<size_t>(length * 2));
+            table.complexMultiplyConjugate(spectrumA.data(), spectrumB.data(), crossSpectrum.data(), length);
+            generic.complexMultiplyConjugate(spectrumA.data(), spectrumB.data(), crossSpectrumReference.data(), length);
+            compareArrays(crossSpectrum, crossSpectrumReference, "complexMultiplyConjugate" + suffix, mismatches);
+        }
+    }
+    
+    // radix4Stage through whole transforms, scaled by the largest reference bin
+    void checkFFT(const SimdKernelTable& table, const SimdKernelTable& generic, juce::StringArray& mismatches)
+    {
+        juce::Random random(2);
+        
+        for (int fftSize : fftSizes)
+        {
+            FFTEngine engine, referenceEngine;
+            engine.prepare(fftSize);
+            referenceEngine.prepare(fftSize);
+            engine.setKernelTable(table);
+            referenceEngine.setKernelTable(generic);
+            
+            auto input = makeRandom(random, fftSize, -1.0f, 1.0f);
+            std::vector<float> spectrum(static_cast<size_t>(engine.getNumBins() * 2));
+            std::vector<float> spectrumReference(spectrum.size());
+            engine.performRealForward(input.data(), spectrum.data());
+            referenceEngine.performRealForward(input.data(), spectrumReference.data());
+            
+            std::vector<float> output(static_cast<size_t>(fftSize)), outputReference(static_cast<size_t>(fftSize));
+            engine.performRealInverse(spectrumReference.data(), output.data());
+            referenceEngine.performRealInverse(spectrumReference.data(), outputReference.data());
+            
+            float peak = 0.0f;
+            for (float value : spectrumReference)
+                peak = std::max(peak, std::abs(value));
+            
+            const juce::String suffix = " (" + juce::String(table.name) + ", FFT size " + juce::String(fftSize) + ")";
+            
+            for (size_t i = 0; i < spectrum.size(); ++i)
+            {
+                if (!isClose(spectrum[i], spectrumReference[i], peak))
+                {
+                    mismatches.add("radix4Stage forward" + suffix + ": value " + juce::String(static_cast<int>(i)) + " is "
+                                   + juce::String(spectrum[i]) + ", Generic gives " + juce::String(spectrumReference[i]));
+                    break;
+                }
+            }
+            
+            for (size_t i = 0; i < output.size(); ++i)
+            {
+                if (!isClose(output[i], outputReference[i], 1.0f))
+                {
+                    mismatches.add("radix4Stage inverse" + suffix + ": sample " + juce::String(static_cast<int>(i)) + " is "
+                                   + juce::String(output[i]) + ", Generic gives " + juce::String(outputReference[i]));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+namespace SimdKernelCheck
+{
+    juce::StringArray getCheckedVariants()
+    {
+        juce::StringArray names;
+        for (SimdInstructionSet instructionSet : variants)
+            if (const SimdKernelTable* table = SimdKernels::get(instructionSet))
+                names.add(table->name);
+        return names;
+    }
+    
+    juce::StringArray run()
+    {
+        const SimdKernelTable& generic = *SimdKernels::get(SimdInstructionSet::Generic);
+        juce::StringArray mismatches;
+        
+        for (SimdInstructionSet instructionSet : variants)
+        {
+            const SimdKernelTable* table = SimdKernels::get(instructionSet);
+            if (table == nullptr)
+                continue;
+            
+            checkLinearKernels(*table, generic, mismatches);
+            checkFFT(*table, generic, mismatches);
+        }
+        
+        return mismatches;
+    }
+}
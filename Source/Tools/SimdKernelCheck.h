@@ -0,0 +1,20 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Runs every kernel of each SIMD variant the running CPU supports against the
+// Generic kernels on the same random input. Lengths are chosen so the vector
+// loops, the scalar tails and the small radix-4 spans are all exercised; the
+// radix-4 butterflies are compared through whole FFTEngine transforms.
+namespace SimdKernelCheck
+{
+    // Relative to the magnitude of the terms involved, so that sums taken in a
+    // different order (or with FMA) still agree
+    constexpr float TOLERANCE = 1.0e-5f;
+    
+    // Names of the variants that were compared (Generic excluded)
+    juce::StringArray getCheckedVariants();
+    
+    // Human-readable mismatches; empty if every variant matches Generic
+    juce::StringArray run();
+}
@@ -0,0 +1,157 @@
+#include "SyntheticCorpus.h"
+#include <cmath>
+
+namespace SyntheticCorpus
+{
+    SyntheticSignal generate(const SyntheticSignalSpec& spec, double sampleRate, juce::int64 seed)
+    {
+        SyntheticSignal signal;
+        signal.spec = spec;
+        signal.sampleRate = sampleRate;
+        
+        auto numSamples = static_cast<size_t>(spec.durationSeconds * sampleRate);
+        signal.samples.assign(numSamples, 0.0f);
+        signal.groundTruth.assign(numSamples, 0.0f);
+        
+        const double twoPi = juce::MathConstants<double>::twoPi;
+        const double attackSeconds = 0.005;
+        double phase = 0.0;
+        
+        // Step 1: Harmonic tone following the frequency trajectory
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            double time = static_cast<double>(i) / sampleRate;
+            double progress = time / spec.durationSeconds;
+            
+            // Slides are exponential, i.e. linear in pitch
+            double frequency = spec.startFrequency * std::pow(static_cast<double>(spec.endFrequency) / spec.startFrequency, progress);
+            
+            if (spec.vibratoDepthCents > 0.0f)
+                frequency *= std::pow(2.0, spec.vibratoDepthCents * std::sin(twoPi * spec.vibratoRate * time) / 1200.0);
+            
+            signal.groundTruth[i] = static_cast<float>(frequency);
+            
+            double sample = 0.0;
+            for (int harmonic = 1; harmonic <= spec.numHarmonics; ++harmonic)
+            {
+                // Stay below Nyquist so the labels remain exact
+                if (frequency * harmonic >= sampleRate * 0.5)
+                    break;
+                
+                double level = 1.0 / harmonic;
+                if (harmonic == 1)
+                    level *= spec.fundamentalLevel;
+                
+                sample += level * std::sin(harmonic * phase);
+            }
+            
+            // Plucked: short attack, exponential decay
+            double envelope = 1.0;
+            if (spec.pluckDecaySeconds > 0.0f)
+                envelope = std::min(1.0, time / attackSeconds) * std::exp(-time / spec.pluckDecaySeconds);
+            
+            signal.samples[i] = static_cast<float>(sample * envelope);
+            
+            phase += twoPi * frequency / sampleRate;
+            if (phase > twoPi)
+                phase -= twoPi;
+        }
+        
+        // Step 2: Normalise to the requested peak level
+        float peak = 0.0f;
+        for (float sample : signal.samples)
+            peak = std::max(peak, std::abs(sample));
+        
+        if (peak > 0.0f)
+        {
+            float gain = spec.peakLevel / peak;
+            for (float& sample : signal.samples)
+                sample *= gain;
+        }
+        
+        // Step 3: White noise at the requested SNR (relative to the signal RMS)
+        if (spec.snrDb != 0.0f)
+        {
+            double signalPower = 0.0;
+            for (float sample : signal.samples)
+                signalPower += static_cast<double>(sample) * sample;
+            signalPower /= static_cast<double>(std::max<size_t>(1, numSamples));
+            
+            // Uniform noise in [-a, a] has power a^2 / 3
+            double noisePower = signalPower / std::pow(10.0, spec.snrDb / 10.0);
+            auto noiseAmplitude = static_cast<float>(std::sqrt(3.0 * noisePower));
+            
+            juce::Random random(seed);
+            for (float& sample : signal.samples)
+                sample += noiseAmplitude * (2.0f * random.nextFloat() - 1.0f);
+        }
+        
+        // Step 4: DC offset
+        for (float& sample : signal.samples)
+            sample += spec.dcOffset;
+        
+        return signal;
+    }
+    
+    std::vector<SyntheticSignalSpec> createStandardCorpus()
+    {
+        // Open strings of 5- and 4-string basses plus the upper register
+        struct Note { const char* name; float frequency; };
+        const Note notes[] = {
+            { "B0", 30.87f }, { "E1", 41.20f }, { "A1", 55.00f }, { "D2", 73.42f },
+            { "G2", 98.00f }, { "D3", 146.83f }, { "G3", 196.00f }, { "G4", 392.00f }
+        };
+        
+        std::vector<SyntheticSignalSpec> corpus;
+        
+        for (const auto& note : notes)
+        {
+            juce::String prefix(note.name);
+            
+            SyntheticSignalSpec clean;
+            clean.startFrequency = clean.endFrequency = note.frequency;
+            clean.name = prefix + "_clean";
+            corpus.push_back(clean);
+            
+            SyntheticSignalSpec weakFundamental = clean;
+            weakFundamental.name = prefix + "_weak_fundamental";
+            weakFundamental.fundamentalLevel = 0.2f;
+            corpus.push_back(weakFundamental);
+            
+            SyntheticSignalSpec vibrato = clean;
+            vibrato.name = prefix + "_vibrato";
+            vibrato.vibratoDepthCents = 30.0f;
+            corpus.push_back(vibrato);
+            
+            SyntheticSignalSpec plucked = clean;
+            plucked.name = prefix + "_plucked";
+            plucked.durationSeconds = 2.0;
+            plucked.pluckDecaySeconds = 0.8f;
+            corpus.push_back(plucked);
+            
+            for (float snr : { 20.0f, 10.0f })
+            {
+                SyntheticSignalSpec noisy = clean;
+                noisy.name = prefix + "_snr" + juce::String(static_cast<int>(snr)) + "dB";
+                noisy.snrDb = snr;
+                corpus.push_back(noisy);
+            }
+            
+            SyntheticSignalSpec offset = clean;
+            offset.name = prefix + "_dc_offset";
+            offset.dcOffset = 0.2f;
+            corpus.push_back(offset);
+            
+            // Slide up a fourth, staying inside the bass range
+            if (note.frequency * 1.335f <= 400.0f)
+            {
+                SyntheticSignalSpec slide = clean;
+                slide.name = prefix + "_slide";
+                slide.endFrequency = note.frequency * 1.335f;
+                corpus.push_back(slide);
+            }
+        }
+        
+        return corpus;
+    }
+}
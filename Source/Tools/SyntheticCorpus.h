@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+// Recipe for one labelled test signal
+struct SyntheticSignalSpec
+{
+    juce::String name;
+    double durationSeconds = 1.0;
+    float startFrequency = 55.0f;       // Hz
+    float endFrequency = 55.0f;         // Differs from start for a slide
+    float vibratoDepthCents = 0.0f;
+    float vibratoRate = 5.0f;           // Hz
+    int numHarmonics = 8;
+    float fundamentalLevel = 1.0f;      // Relative to the 1/k harmonic rolloff (< 1 = weak fundamental)
+    float pluckDecaySeconds = 0.0f;     // 0 = sustained
+    float snrDb = 0.0f;                 // 0 = no noise
+    float dcOffset = 0.0f;
+    float peakLevel = 0.5f;
+};
+
+// Generated audio with per-sample ground truth
+struct SyntheticSignal
+{
+    SyntheticSignalSpec spec;
+    double sampleRate = 44100.0;
+    std::vector<float> samples;
+    std::vector<float> groundTruth;     // Instantaneous f0 in Hz per sample
+};
+
+// Deterministic generator for bass-like test signals: harmonic tones with an
+// adjustable fundamental, vibrato, slides, plucked envelopes, white noise at a
+// set SNR, and DC offset
+namespace SyntheticCorpus
+{
+    SyntheticSignal generate(const SyntheticSignalSpec& spec, double sampleRate, juce::int64 seed);
+    
+    // The standard corpus: every variant across the 30-400 Hz bass range
+    std::vector<SyntheticSignalSpec> createStandardCorpus();
+}
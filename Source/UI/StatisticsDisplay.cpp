@@ -1,7 +1,8 @@
 #include "StatisticsDisplay.h"
+#include "../Utilities/CycleCounter.h"
 
 StatisticsDisplay::StatisticsDisplay(StatisticsManager& statsManager)
-    : statisticsManager(statsManager)
+    : statisticsManager(&statsManager)
 {
     setupLabels();
     startTimerHz(30); // Update 30 times per second
@@ -21,6 +22,17 @@ void StatisticsDisplay::paint(juce::Graphics& g)
     // Draw separator line
     g.setColour(accentColor);
     g.drawHorizontalLine(45, 0.0f, static_cast<float>(getWidth()));
+    
+    if (displayMode == Comparison)
+    {
+        auto tableArea = getLocalBounds().reduced(20);
+        tableArea.removeFromTop(50); // Space for title
+        drawComparisonTable(g, tableArea);
+    }
+    else if (displayMode == History)
+    {
+        drawHistory(g);
+    }
 }
 
 void StatisticsDisplay::resized()
@@ -56,11 +68,219 @@ void StatisticsDisplay::resized()
     
     // Detection count
     detectionCountLabel.setBounds(bounds.removeFromTop(labelHeight));
+    
+    bounds.removeFromTop(spacing);
+    
+    // Audio thread cost
+    frameCostLabel.setBounds(bounds.removeFromTop(labelHeight));
+    bounds.removeFromTop(spacing);
+    blockBudgetLabel.setBounds(bounds.removeFromTop(labelHeight));
+    
+    // One history column per pixel, up to what the pyramid renders at once
+    const int numColumns = juce::jlimit(1, PitchHistoryPyramid::MAX_COLUMNS, getHistoryPlotArea().getWidth());
+    historyColumns.assign(static_cast<size_t>(numColumns), PitchHistoryPyramid::Range());
+    historyFramesShown = 0;
 }
 
 void StatisticsDisplay::timerCallback()
 {
-    updateLabels();
+    if (displayMode == Comparison)
+    {
+        updateComparisonSnapshots();
+        repaint();
+    }
+    else if (displayMode == History)
+    {
+        updateHistory();
+        repaint();
+    }
+    else
+    {
+        updateLabels();
+    }
+}
+
+void StatisticsDisplay::setDisplayMode(DisplayMode mode)
+{
+    displayMode = mode;
+    setLabelsVisible(mode == RealTime);
+    repaint();
+}
+
+void StatisticsDisplay::setComparisonSources(const juce::StringArray& names, const juce::Array<StatisticsManager*>& managers)
+{
+    jassert(names.size() == managers.size());
+    
+    comparisonNames = names;
+    comparisonManagers = managers;
+    comparisonSnapshots.assign(static_cast<size_t>(managers.size()), StatisticsSnapshot());
+}
+
+void StatisticsDisplay::setLabelsVisible(bool shouldBeVisible)
+{
+    currentPitchLabel.setVisible(shouldBeVisible);
+    currentNoteLabel.setVisible(shouldBeVisible);
+    averagePitchLabel.setVisible(shouldBeVisible);
+    stabilityLabel.setVisible(shouldBeVisible);
+    confidenceLabel.setVisible(shouldBeVisible);
+    responseTimeLabel.setVisible(shouldBeVisible);
+    detectionCountLabel.setVisible(shouldBeVisible);
+    frameCostLabel.setVisible(shouldBeVisible);
+    blockBudgetLabel.setVisible(shouldBeVisible);
+}
+
+void StatisticsDisplay::updateComparisonSnapshots()
+{
+    for (int i = 0; i < comparisonManagers.size(); ++i)
+        comparisonSnapshots[static_cast<size_t>(i)] = comparisonManagers[i]->getSnapshot();
+}
+
+void StatisticsDisplay::drawComparisonTable(juce::Graphics& g, juce::Rectangle<int> area)
+{
+    const juce::StringArray headers { "Algorithm", "Pitch", "Average", "Stability", "Confidence", "Detections", "Compute" };
+    const float columnWeights[] = { 1.2f, 1.2f, 1.5f, 0.9f, 1.0f, 1.1f, 1.6f };
+    const int rowHeight = 25;
+    
+    // Column edges scaled to the available width
+    float totalWeight = 0.0f;
+    for (float weight : columnWeights)
+        totalWeight += weight;
+    
+    juce::Array<int> columnWidths;
+    for (float weight : columnWeights)
+        columnWidths.add(static_cast<int>(area.getWidth() * weight / totalWeight));
+    
+    auto drawRow = [&](juce::Rectangle<int> row, const juce::StringArray& cells, const juce::Array<juce::Colour>& colours)
+    {
+        for (int column = 0; column < cells.size(); ++column)
+        {
+            g.setColour(colours[column]);
+            g.drawText(cells[column], row.removeFromLeft(columnWidths[column]),
+                       column == 0 ? juce::Justification::centredLeft : juce::Justification::centred, true);
+        }
+    };
+    
+    // Header
+    g.setFont(juce::Font(14.0f, juce::Font::bold));
+    juce::Array<juce::Colour> headerColours;
+    for (int column = 0; column < headers.size(); ++column)
+        headerColours.add(accentColor);
+    drawRow(area.removeFromTop(rowHeight), headers, headerColours);
+    
+    g.setColour(accentColor.withAlpha(0.5f));
+    g.drawHorizontalLine(area.getY(), static_cast<float>(area.getX()), static_cast<float>(area.getRight()));
+    
+    // One row per detector
+    g.setFont(juce::Font(14.0f));
+    for (int i = 0; i < comparisonManagers.size(); ++i)
+    {
+        const StatisticsSnapshot& snapshot = comparisonSnapshots[static_cast<size_t>(i)];
+        
+        juce::StringArray cells;
+        cells.add(comparisonNames[i]);
+        cells.add(formatFrequency(snapshot.currentPitch));
+        cells.add(formatFrequency(snapshot.averagePitch) + " (" + StatisticsManager::frequencyToNote(snapshot.averagePitch) + ")");
+        cells.add(formatPercentage(snapshot.pitchStability));
+        cells.add(formatPercentage(snapshot.detectionConfidence));
+        cells.add(juce::String(snapshot.validDetections) + "/" + juce::String(snapshot.totalDetections));
+        cells.add(formatComputeTime(snapshot.averageComputeTime) + " / " + formatComputeTime(snapshot.maxComputeTime));
+        
+        juce::Array<juce::Colour> colours { textColor, textColor, textColor,
+                                            getStabilityColor(snapshot.pitchStability),
+                                            getConfidenceColor(snapshot.detectionConfidence),
+                                            textColor, textColor };
+        drawRow(area.removeFromTop(rowHeight), cells, colours);
+    }
+    
+    // Legend
+    g.setFont(juce::Font(12.0f));
+    g.setColour(textColor.withAlpha(0.7f));
+    g.drawText("Compute: average / max time per frame", area.removeFromTop(rowHeight * 2),
+               juce::Justification::centredLeft, true);
+}
+
+void StatisticsDisplay::updateHistory()
+{
+    // Costs one pass over the columns however long the session is; a read
+    // the audio thread overtook keeps the previous picture
+    const PitchHistoryPyramid& history = statisticsManager->getSessionHistory();
+    
+    if (history.getNumFrames() == 0)
+    {
+        historyFramesShown = 0;
+        return;
+    }
+    
+    if (juce::int64 framesShown = history.render(historyColumns.data(), static_cast<int>(historyColumns.size())))
+    {
+        historyFramesShown = framesShown;
+        historySeconds = history.getDurationSeconds();
+    }
+}
+
+juce::Rectangle<int> StatisticsDisplay::getHistoryPlotArea() const
+{
+    auto area = getLocalBounds().reduced(20);
+    area.removeFromTop(50); // Space for title
+    area.removeFromBottom(25); // Caption
+    area.removeFromLeft(40); // Note names
+    return area;
+}
+
+float StatisticsDisplay::frequencyToHistoryY(float frequency, juce::Rectangle<int> plotArea) const
+{
+    const float position = std::log(frequency / HISTORY_MIN_FREQUENCY) / std::log(HISTORY_MAX_FREQUENCY / HISTORY_MIN_FREQUENCY);
+    return static_cast<float>(plotArea.getBottom()) - juce::jlimit(0.0f, 1.0f, position) * static_cast<float>(plotArea.getHeight());
+}
+
+void StatisticsDisplay::drawHistory(juce::Graphics& g)
+{
+    const auto plotArea = getHistoryPlotArea();
+    
+    // Open strings of a five-string bass, plus the octave of the top string
+    const float gridFrequencies[] = { 30.87f, 41.20f, 55.0f, 73.42f, 98.0f, 196.0f };
+    
+    g.setFont(juce::Font(12.0f));
+    for (float frequency : gridFrequencies)
+    {
+        const float y = frequencyToHistoryY(frequency, plotArea);
+        g.setColour(accentColor.withAlpha(0.3f));
+        g.drawHorizontalLine(juce::roundToInt(y), static_cast<float>(plotArea.getX()), static_cast<float>(plotArea.getRight()));
+        
+        g.setColour(textColor.withAlpha(0.7f));
+        g.drawText(StatisticsManager::frequencyToNote(frequency),
+                   juce::Rectangle<int>(plotArea.getX() - 40, juce::roundToInt(y) - 8, 35, 16),
+                   juce::Justification::centredRight, false);
+    }
+    
+    auto caption = plotArea.withTop(plotArea.getBottom()).withHeight(25);
+    
+    if (historyFramesShown == 0)
+    {
+        g.setColour(textColor.withAlpha(0.7f));
+        g.drawText("No pitch history yet", caption, juce::Justification::centredLeft, true);
+        return;
+    }
+    
+    // One vertical stroke per column from its lowest to its highest pitch
+    const float columnWidth = static_cast<float>(plotArea.getWidth()) / static_cast<float>(historyColumns.size());
+    
+    g.setColour(successColor);
+    for (size_t column = 0; column < historyColumns.size(); ++column)
+    {
+        const PitchHistoryPyramid::Range& range = historyColumns[column];
+        if (!range.hasPitch())
+            continue;
+        
+        const float top = frequencyToHistoryY(range.maximum, plotArea);
+        const float bottom = frequencyToHistoryY(range.minimum, plotArea);
+        g.fillRect(static_cast<float>(plotArea.getX()) + static_cast<float>(column) * columnWidth,
+                   top - 1.0f, std::max(1.0f, columnWidth), std::max(2.0f, bottom - top + 2.0f));
+    }
+    
+    g.setColour(textColor.withAlpha(0.7f));
+    g.drawText("Session: " + formatDuration(historySeconds) + ", " + juce::String(historyFramesShown) + " frames",
+               caption, juce::Justification::centredLeft, true);
 }
 
 void StatisticsDisplay::setupLabels()
@@ -116,43 +336,103 @@ void StatisticsDisplay::setupLabels()
     detectionCountLabel.setText("Detections: 0/0", juce::dontSendNotification);
     detectionCountLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(detectionCountLabel);
+    
+    // Frame cost label
+    frameCostLabel.setFont(valueFont);
+    frameCostLabel.setColour(juce::Label::textColourId, textColor);
+    frameCostLabel.setText("Frame Cost: ---", juce::dontSendNotification);
+    frameCostLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(frameCostLabel);
+    
+    // Block budget label
+    blockBudgetLabel.setFont(valueFont);
+    blockBudgetLabel.setColour(juce::Label::textColourId, textColor);
+    blockBudgetLabel.setText("Block Budget: ---", juce::dontSendNotification);
+    blockBudgetLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(blockBudgetLabel);
 }
 
 void StatisticsDisplay::updateLabels()
 {
+    // Read one consistent snapshot published by the audio thread
+    StatisticsSnapshot snapshot = statisticsManager->getSnapshot();
+    
     // Update current pitch
-    float currentPitch = statisticsManager.getCurrentPitch();
+    float currentPitch = snapshot.currentPitch;
     currentPitchLabel.setText("Current Pitch: " + formatFrequency(currentPitch), juce::dontSendNotification);
     
     // Update current note
-    juce::String currentNote = statisticsManager.getCurrentNote();
+    juce::String currentNote = StatisticsManager::frequencyToNote(currentPitch);
     currentNoteLabel.setText(currentNote, juce::dontSendNotification);
     
     // Update average pitch
-    float avgPitch = statisticsManager.getAveragePitch();
+    float avgPitch = snapshot.averagePitch;
     averagePitchLabel.setText("Average Pitch: " + formatFrequency(avgPitch) + 
-                             " (" + statisticsManager.getAverageNote() + ")", 
+                             " (" + StatisticsManager::frequencyToNote(avgPitch) + ")", 
                              juce::dontSendNotification);
     
     // Update stability
-    float stability = statisticsManager.getPitchStability();
+    float stability = snapshot.pitchStability;
     stabilityLabel.setText("Stability: " + formatPercentage(stability), juce::dontSendNotification);
     stabilityLabel.setColour(juce::Label::textColourId, getStabilityColor(stability));
     
     // Update confidence
-    float confidence = statisticsManager.getDetectionConfidence();
+    float confidence = snapshot.detectionConfidence;
     confidenceLabel.setText("Confidence: " + formatPercentage(confidence), juce::dontSendNotification);
     confidenceLabel.setColour(juce::Label::textColourId, getConfidenceColor(confidence));
     
     // Update response time
-    float responseTime = statisticsManager.getResponseTime();
+    float responseTime = snapshot.responseTime;
     responseTimeLabel.setText("Response Time: " + formatTime(responseTime), juce::dontSendNotification);
     
     // Update detection count
-    int total = statisticsManager.getTotalDetections();
-    int valid = statisticsManager.getValidDetections();
+    int total = snapshot.totalDetections;
+    int valid = snapshot.validDetections;
     detectionCountLabel.setText("Detections: " + juce::String(valid) + "/" + juce::String(total), 
                                juce::dontSendNotification);
+    
+    updateCostLabels();
+}
+
+void StatisticsDisplay::updateCostLabels()
+{
+    // Percentiles of what the audio thread spent per frame and per block
+    const CostHistogram::Summary frameCosts = statisticsManager->getFrameCosts().getSummary();
+    const CostHistogram::Summary blockLoads = statisticsManager->getBlockLoads().getSummary();
+    
+    if (frameCosts.count == 0)
+    {
+        frameCostLabel.setText("Frame Cost: ---", juce::dontSendNotification);
+    }
+    else
+    {
+        const double millisecondsPerTimestamp = 1000.0 / CycleCounter::getTimestampsPerSecond();
+        auto toMilliseconds = [millisecondsPerTimestamp](juce::uint64 timestamps)
+        {
+            return static_cast<float>(static_cast<double>(timestamps) * millisecondsPerTimestamp);
+        };
+        
+        frameCostLabel.setText("Frame Cost: " + formatComputeTime(toMilliseconds(frameCosts.median)) + " p50, "
+                                   + formatComputeTime(toMilliseconds(frameCosts.percentile99)) + " p99, "
+                                   + formatComputeTime(toMilliseconds(frameCosts.maximum)) + " max",
+                               juce::dontSendNotification);
+    }
+    
+    if (blockLoads.count == 0)
+    {
+        blockBudgetLabel.setText("Block Budget: ---", juce::dontSendNotification);
+        blockBudgetLabel.setColour(juce::Label::textColourId, textColor);
+        return;
+    }
+    
+    auto toFraction = [](juce::uint64 load) { return static_cast<double>(load) / StatisticsManager::BLOCK_LOAD_SCALE; };
+    const double worstFraction = toFraction(blockLoads.maximum);
+    
+    blockBudgetLabel.setText("Block Budget: " + formatBudgetFraction(toFraction(blockLoads.median)) + " p50, "
+                                 + formatBudgetFraction(toFraction(blockLoads.percentile99)) + " p99, "
+                                 + formatBudgetFraction(worstFraction) + " max",
+                             juce::dontSendNotification);
+    blockBudgetLabel.setColour(juce::Label::textColourId, getBudgetColor(worstFraction));
 }
 
 juce::String StatisticsDisplay::formatFrequency(float frequency) const
@@ -184,6 +464,32 @@ juce::String StatisticsDisplay::formatTime(float seconds) const
         return juce::String(seconds, 2) + " s";
 }
 
+juce::String StatisticsDisplay::formatComputeTime(float milliseconds) const
+{
+    if (milliseconds <= 0.0f)
+        return "---";
+    
+    if (milliseconds < 1.0f)
+        return juce::String(static_cast<int>(milliseconds * 1000.0f)) + " us";
+    else
+        return juce::String(milliseconds, 2) + " ms";
+}
+
+juce::String StatisticsDisplay::formatDuration(double seconds) const
+{
+    const int totalSeconds = static_cast<int>(seconds);
+    const int hours = totalSeconds / 3600;
+    const juce::String minutesAndSeconds = juce::String((totalSeconds / 60) % 60).paddedLeft('0', hours > 0 ? 2 : 1)
+                                           + ":" + juce::String(totalSeconds % 60).paddedLeft('0', 2);
+    
+    return hours > 0 ? juce::String(hours) + ":" + minutesAndSeconds : minutesAndSeconds;
+}
+
+juce::String StatisticsDisplay::formatBudgetFraction(double fraction) const
+{
+    return juce::String(fraction * 100.0, 1) + "%";
+}
+
 juce::Colour StatisticsDisplay::getStabilityColor(float stability) const
 {
     if (stability >= 0.8f)
@@ -202,4 +508,14 @@ juce::Colour StatisticsDisplay::getConfidenceColor(float confidence) const
         return warningColor;
     else
         return errorColor;
-} 
\ No newline at end of file
+} 
+
+juce::Colour StatisticsDisplay::getBudgetColor(double fraction) const
+{
+    if (fraction < 0.25)
+        return successColor;
+    else if (fraction < 0.5)
+        return warningColor;
+    else
+        return errorColor;
+}
\ No newline at end of file
@@ -21,12 +21,29 @@ public:
         Comparison
     };
     
-    void setDisplayMode(DisplayMode mode) { displayMode = mode; repaint(); }
+    void setDisplayMode(DisplayMode mode);
+    
+    // Statistics shown in RealTime mode (e.g. when another channel is picked)
+    void setStatisticsSource(StatisticsManager& statsManager) { statisticsManager = &statsManager; }
+    
+    // Detectors shown side by side in Comparison mode
+    void setComparisonSources(const juce::StringArray& names, const juce::Array<StatisticsManager*>& managers);
     
 private:
-    StatisticsManager& statisticsManager;
+    StatisticsManager* statisticsManager;
     DisplayMode displayMode = RealTime;
     
+    // Comparison table
+    juce::StringArray comparisonNames;
+    juce::Array<StatisticsManager*> comparisonManagers;
+    std::vector<StatisticsSnapshot> comparisonSnapshots;
+    
+    // History plot: one pitch range per pixel column, rendered from the
+    // session history's pyramid
+    std::vector<PitchHistoryPyramid::Range> historyColumns;
+    juce::int64 historyFramesShown = 0;
+    double historySeconds = 0.0;
+    
     // Display components
     juce::Label currentPitchLabel;
     juce::Label currentNoteLabel;
@@ -35,6 +52,8 @@ private:
     juce::Label confidenceLabel;
     juce::Label responseTimeLabel;
     juce::Label detectionCountLabel;
+    juce::Label frameCostLabel;
+    juce::Label blockBudgetLabel;
     
     // Colors
     juce::Colour backgroundColor = juce::Colour(0xFF2D2D30);
@@ -47,11 +66,27 @@ private:
     // Helper methods
     void setupLabels();
     void updateLabels();
+    void updateCostLabels();
+    void updateComparisonSnapshots();
+    void drawComparisonTable(juce::Graphics& g, juce::Rectangle<int> area);
+    void updateHistory();
+    void drawHistory(juce::Graphics& g);
+    juce::Rectangle<int> getHistoryPlotArea() const;
+    float frequencyToHistoryY(float frequency, juce::Rectangle<int> plotArea) const;
+    void setLabelsVisible(bool shouldBeVisible);
     juce::String formatFrequency(float frequency) const;
     juce::String formatPercentage(float value) const;
     juce::String formatTime(float seconds) const;
+    juce::String formatComputeTime(float milliseconds) const;
+    juce::String formatBudgetFraction(double fraction) const;
+    juce::String formatDuration(double seconds) const;
     juce::Colour getStabilityColor(float stability) const;
     juce::Colour getConfidenceColor(float confidence) const;
+    juce::Colour getBudgetColor(double fraction) const;
+    
+    // Frequency axis of the history plot (log scale, the bass range)
+    static constexpr float HISTORY_MIN_FREQUENCY = 28.0f;
+    static constexpr float HISTORY_MAX_FREQUENCY = 420.0f;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StatisticsDisplay)
 }; 
\ No newline at end of file
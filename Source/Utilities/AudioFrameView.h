@@ -0,0 +1,141 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <cstring>
+
+// Read-only view of one analysis frame in someone else's memory, so a frame
+// can be analysed where it lies instead of being copied into an AudioBuffer
+// of its own.
+//
+// A frame is up to two spans read one after the other: a frame that wraps
+// around the end of a circular buffer is its tail followed by its head.
+// Within each span consecutive samples are `stride` floats apart (e.g. one
+// channel of interleaved audio). The view doesn't own the samples, which
+// must outlive it and stay unchanged while it's read.
+class AudioFrameView
+{
+public:
+    AudioFrameView() = default;
+    
+    // One span
+    AudioFrameView(const float* samples, int numSamples, int sampleStride = 1)
+        : first(samples), firstSize(numSamples), stride(sampleStride)
+    {
+    }
+    
+    // A span continued by a second one (a wrapped circular buffer)
+    AudioFrameView(const float* firstSamples, int numFirstSamples,
+                   const float* secondSamples, int numSecondSamples, int sampleStride = 1)
+        : first(firstSamples), second(secondSamples), firstSize(numFirstSamples),
+          secondSize(numSecondSamples), stride(sampleStride)
+    {
+        if (firstSize == 0)
+        {
+            // Keep the first span non-empty so contiguous views look the same
+            first = second;
+            firstSize = secondSize;
+            second = nullptr;
+            secondSize = 0;
+        }
+    }
+    
+    // A whole channel of a buffer
+    explicit AudioFrameView(const juce::AudioBuffer<float>& buffer, int channel = 0)
+        : AudioFrameView(buffer.getReadPointer(channel), buffer.getNumSamples())
+    {
+    }
+    
+    int getNumSamples() const { return firstSize + secondSize; }
+    
+    // True when the frame is one run of adjacent samples, so getContiguousData() can be used
+    bool isContiguous() const { return secondSize == 0 && (stride == 1 || firstSize <= 1); }
+    const float* getContiguousData() const
+    {
+        jassert(isContiguous());
+        return first;
+    }
+    
+    float operator[](int index) const
+    {
+        return index < firstSize ? first[static_cast<size_t>(index) * static_cast<size_t>(stride)]
+                                 : second[static_cast<size_t>(index - firstSize) * static_cast<size_t>(stride)];
+    }
+    
+    // numSamples samples starting startSample samples into this frame
+    AudioFrameView getSubView(int startSample, int numSamples) const
+    {
+        jassert(startSample >= 0 && numSamples >= 0 && startSample + numSamples <= getNumSamples());
+        
+        if (startSample >= firstSize)
+            return { second + static_cast<size_t>(startSample - firstSize) * static_cast<size_t>(stride), numSamples, stride };
+        
+        const int fromFirst = std::min(numSamples, firstSize - startSample);
+        return { first + static_cast<size_t>(startSample) * static_cast<size_t>(stride), fromFirst,
+                 second, numSamples - fromFirst, stride };
+    }
+    
+    // Copy the first numSamples samples (all of them by default) into
+    // contiguous memory; a memcpy per span for unit stride
+    void copyTo(float* destination, int numSamples = -1) const
+    {
+        if (numSamples < 0)
+            numSamples = getNumSamples();
+        
+        const int fromFirst = std::min(numSamples, firstSize);
+        copySpan(first, fromFirst, destination);
+        copySpan(second, numSamples - fromFirst, destination + fromFirst);
+    }
+    
+    // Whether the frame equals getNumSamples() samples of contiguous memory
+    bool matches(const float* samples) const
+    {
+        if (stride != 1)
+        {
+            for (int i = 0; i < getNumSamples(); ++i)
+            {
+                if ((*this)[i] != samples[i])
+                    return false;
+            }
+            
+            return true;
+        }
+        
+        return (firstSize == 0 || std::memcmp(first, samples, sizeof(float) * static_cast<size_t>(firstSize)) == 0)
+            && (secondSize == 0 || std::memcmp(second, samples + firstSize, sizeof(float) * static_cast<size_t>(secondSize)) == 0);
+    }
+    
+    // Call function(samples, numSamples) for each non-empty span; unit stride only
+    template <typename Function>
+    void forEachSpan(Function&& function) const
+    {
+        jassert(stride == 1);
+        
+        if (firstSize > 0)
+            function(first, firstSize);
+        if (secondSize > 0)
+            function(second, secondSize);
+    }
+
+private:
+    const float* first = nullptr;
+    const float* second = nullptr;
+    int firstSize = 0;
+    int secondSize = 0;
+    int stride = 1;
+    
+    void copySpan(const float* source, int numSamples, float* destination) const
+    {
+        if (numSamples <= 0)
+            return;
+        
+        if (stride == 1)
+        {
+            std::memcpy(destination, source, sizeof(float) * static_cast<size_t>(numSamples));
+            return;
+        }
+        
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = source[static_cast<size_t>(i) * static_cast<size_t>(stride)];
+    }
+};
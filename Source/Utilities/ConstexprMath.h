@@ -0,0 +1,49 @@
+#pragma once
+
+// Trigonometry usable in constant expressions (std::sin and std::cos aren't
+// constexpr before C++26), for tables built at compile time such as
+// FixedSizeFFT's twiddles and the fixed-size detectors' windows. Accurate to
+// a few units in the last place of a double over any argument a table needs.
+namespace ConstexprMath
+{
+    constexpr double PI = 3.14159265358979323846;
+    
+    // x reduced to [-pi/2, pi/2] with the same sine
+    constexpr double reduceForSine(double x)
+    {
+        // Step 1: Into [-pi, pi]
+        const double turns = x / (2.0 * PI);
+        const auto nearestTurn = static_cast<double>(static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5));
+        x -= nearestTurn * 2.0 * PI;
+        
+        // Step 2: Fold about +-pi/2, where sin(pi - x) = sin(x)
+        if (x > PI / 2.0)
+            return PI - x;
+        if (x < -PI / 2.0)
+            return -PI - x;
+        return x;
+    }
+    
+    constexpr double sin(double x)
+    {
+        x = reduceForSine(x);
+        
+        // Taylor series; by the 13th term, past (pi/2)^27 / 27!, it has converged
+        const double xSquared = x * x;
+        double term = x;
+        double sum = x;
+        
+        for (int n = 1; n < 14; ++n)
+        {
+            term *= -xSquared / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        
+        return sum;
+    }
+    
+    constexpr double cos(double x)
+    {
+        return sin(x + PI / 2.0);
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+
+// Distribution of non-negative integer costs (e.g. CycleCounter timestamps
+// per analysed frame), filled by one thread and read by any other without
+// locks.
+//
+// Values go into log-spaced bins, SUB_BINS per power of two (values below
+// SUB_BINS get a bin each), so a percentile is within 1 / SUB_BINS of the
+// true value at any scale and adding a value is a few shifts and a relaxed
+// store. A reader that overlaps the writer sees each bin either before or
+// after the new value, which only matters for the value being added.
+class CostHistogram
+{
+public:
+    CostHistogram() { clear(); }
+    
+    struct Summary
+    {
+        juce::uint64 count = 0;
+        juce::uint64 median = 0;
+        juce::uint64 percentile99 = 0;
+        juce::uint64 maximum = 0;
+    };
+    
+    // Writer: count one value (constant time, wait-free)
+    void add(juce::uint64 value)
+    {
+        auto& bin = bins[static_cast<size_t>(getBinIndex(value))];
+        bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        
+        if (value > maximum.load(std::memory_order_relaxed))
+            maximum.store(value, std::memory_order_relaxed);
+    }
+    
+    // Writer: forget every value
+    void clear()
+    {
+        for (auto& bin : bins)
+            bin.store(0, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+    
+    // Any thread: count, median, 99th percentile and maximum. Percentiles are
+    // the middle of their bin, capped at the maximum.
+    Summary getSummary() const
+    {
+        std::array<juce::uint32, NUM_BINS> counts;
+        Summary summary;
+        
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            counts[i] = bins[i].load(std::memory_order_relaxed);
+            summary.count += counts[i];
+        }
+        
+        summary.maximum = maximum.load(std::memory_order_relaxed);
+        
+        if (summary.count == 0)
+            return summary;
+        
+        summary.median = std::min(summary.maximum, findPercentile(counts, summary.count, 0.5));
+        summary.percentile99 = std::min(summary.maximum, findPercentile(counts, summary.count, 0.99));
+        return summary;
+    }
+    
+    static constexpr int SUB_BIN_BITS = 3;
+    static constexpr int SUB_BINS = 1 << SUB_BIN_BITS;
+    static constexpr int NUM_BINS = (64 - SUB_BIN_BITS + 1) * SUB_BINS;
+
+private:
+    std::array<std::atomic<juce::uint32>, NUM_BINS> bins;
+    std::atomic<juce::uint64> maximum { 0 };
+    
+    static int getHighestBit(juce::uint64 value)
+    {
+        const auto high = static_cast<juce::uint32>(value >> 32);
+        return high != 0 ? 32 + juce::findHighestSetBit(high)
+                         : juce::findHighestSetBit(static_cast<juce::uint32>(value));
+    }
+    
+    // A value whose highest set bit is `octave` lands in one of the SUB_BINS
+    // bins of that octave, picked by the SUB_BIN_BITS bits below it
+    static int getBinIndex(juce::uint64 value)
+    {
+        if (value < static_cast<juce::uint64>(SUB_BINS))
+            return static_cast<int>(value);
+        
+        const int octave = getHighestBit(value);
+        const int subBin = static_cast<int>(value >> (octave - SUB_BIN_BITS)) & (SUB_BINS - 1);
+        return (octave - SUB_BIN_BITS + 1) * SUB_BINS + subBin;
+    }
+    
+    static juce::uint64 getBinMiddle(int index)
+    {
+        if (index < SUB_BINS)
+            return static_cast<juce::uint64>(index);
+        
+        const int shift = index / SUB_BINS - 1;
+        const auto lowest = static_cast<juce::uint64>(SUB_BINS + index % SUB_BINS) << shift;
+        return lowest + ((juce::uint64 { 1 } << shift) >> 1);
+    }
+    
+    static juce::uint64 findPercentile(const std::array<juce::uint32, NUM_BINS>& counts,
+                                       juce::uint64 total, double fraction)
+    {
+        // Smallest bin at which at least `fraction` of the values are counted
+        const auto rank = static_cast<juce::uint64>(std::ceil(fraction * static_cast<double>(total)));
+        juce::uint64 seen = 0;
+        
+        for (int i = 0; i < NUM_BINS; ++i)
+        {
+            seen += counts[static_cast<size_t>(i)];
+            if (seen >= rank)
+                return getBinMiddle(i);
+        }
+        
+        return getBinMiddle(NUM_BINS - 1);
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE(CostHistogram)
+};
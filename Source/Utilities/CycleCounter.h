@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// CPU timestamp counter for cheap, high-resolution timing of short code
+// sections. Returns 0 on platforms without an accessible counter, so callers
+// should fall back to juce::Time for wall-clock durations (or use
+// timestamp(), which does).
+namespace CycleCounter
+{
+    inline bool isAvailable()
+    {
+       #if JUCE_INTEL
+        return true;
+       #else
+        return false;
+       #endif
+    }
+    
+    inline juce::uint64 now()
+    {
+       #if JUCE_INTEL
+        return static_cast<juce::uint64>(__rdtsc());
+       #else
+        return 0;
+       #endif
+    }
+    
+    // now() where the counter exists, otherwise juce's high-resolution ticks
+    inline juce::uint64 timestamp()
+    {
+        if (isAvailable())
+            return now();
+        
+        return static_cast<juce::uint64>(juce::Time::getHighResolutionTicks());
+    }
+    
+    constexpr int CALIBRATION_MS = 20;
+    
+    // How many timestamp() units make a second. The counter's rate is measured
+    // against juce::Time on the first call, which sleeps for CALIBRATION_MS, so
+    // make that call off the audio thread (e.g. in prepare).
+    inline double getTimestampsPerSecond()
+    {
+        static const double timestampsPerSecond = []
+        {
+            if (!isAvailable())
+                return static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+            
+            const juce::int64 ticksBefore = juce::Time::getHighResolutionTicks();
+            const juce::uint64 cyclesBefore = now();
+            juce::Thread::sleep(CALIBRATION_MS);
+            const juce::uint64 cycles = now() - cyclesBefore;
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticksBefore);
+            
+            return static_cast<double>(cycles) / seconds;
+        }();
+        
+        return timestampsPerSecond;
+    }
+}
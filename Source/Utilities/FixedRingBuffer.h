@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+// Fixed-capacity FIFO that overwrites its oldest element when full.
+// Storage is allocated once in prepare(); push() never allocates.
+template <typename T>
+class FixedRingBuffer
+{
+public:
+    FixedRingBuffer() = default;
+    
+    // Allocate storage and clear (not real-time safe)
+    void prepare(int newCapacity)
+    {
+        storage.assign(static_cast<size_t>(newCapacity), T());
+        clear();
+    }
+    
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+    
+    int size() const { return count; }
+    int capacity() const { return static_cast<int>(storage.size()); }
+    bool empty() const { return count == 0; }
+    bool isFull() const { return count == capacity(); }
+    
+    // Element i, counting from the oldest (0) to the newest (size() - 1)
+    const T& operator[](int index) const { return storage[static_cast<size_t>(wrap(head + index))]; }
+    
+    const T& oldest() const { return (*this)[0]; }
+    const T& newest() const { return (*this)[count - 1]; }
+    
+    // Append, overwriting the oldest element when full
+    void push(const T& value)
+    {
+        if (storage.empty())
+            return;
+        
+        if (isFull())
+        {
+            storage[static_cast<size_t>(head)] = value;
+            head = wrap(head + 1);
+        }
+        else
+        {
+            storage[static_cast<size_t>(wrap(head + count))] = value;
+            ++count;
+        }
+    }
+
+private:
+    std::vector<T> storage;
+    int head = 0;   // Index of the oldest element
+    int count = 0;
+    
+    int wrap(int index) const
+    {
+        int cap = capacity();
+        return index >= cap ? index - cap : index;
+    }
+};
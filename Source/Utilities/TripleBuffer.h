@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+
+// Wait-free single-writer / single-reader publication of a value.
+//
+// The writer fills its private buffer and publishes it by swapping it with
+// the shared middle slot; the reader swaps the middle slot with its own
+// buffer when something new has been published. Neither side ever blocks,
+// the reader always sees a complete value, and it always gets the newest one.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    
+    // Writer: buffer to fill before calling publish()
+    T& getWriteBuffer() { return buffers[writeIndex]; }
+    
+    // Writer: make the write buffer visible to the reader
+    void publish()
+    {
+        int previousMiddle = middle.exchange(writeIndex | NEW_DATA_FLAG, std::memory_order_acq_rel);
+        writeIndex = previousMiddle & INDEX_MASK;
+    }
+    
+    // Writer: fill and publish in one step
+    void publish(const T& value)
+    {
+        getWriteBuffer() = value;
+        publish();
+    }
+    
+    // Reader: newest published value (or the previous one if nothing new)
+    const T& read()
+    {
+        if ((middle.load(std::memory_order_relaxed) & NEW_DATA_FLAG) != 0)
+        {
+            int previousMiddle = middle.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previousMiddle & INDEX_MASK;
+        }
+        
+        return buffers[readIndex];
+    }
+
+private:
+    static constexpr int INDEX_MASK = 0x3;
+    static constexpr int NEW_DATA_FLAG = 0x4;
+    
+    T buffers[3] {};
+    int writeIndex = 0;                 // Owned by the writer
+    int readIndex = 1;                  // Owned by the reader
+    std::atomic<int> middle { 2 };      // Shared slot plus "new data" flag
+};